@@ -0,0 +1,128 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+/**
+ * @file
+ *
+ * @brief Uniform domains for the benchmarks
+ */
+
+#ifndef THUNDEREGG_BENCH_UNIFORMDOMAIN_H
+#define THUNDEREGG_BENCH_UNIFORMDOMAIN_H
+
+#include <ThunderEgg/Domain.h>
+#include <array>
+#include <map>
+#include <memory>
+
+/**
+ * @brief Get the rank that owns a patch, the patches are split into contiguous blocks of ids
+ */
+inline int getOwner(int id, int total_patches)
+{
+	int size;
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	return (long) id * size / total_patches;
+}
+/**
+ * @brief Create a uniform domain of num_patches^D patches, each with n^D cells, on the unit
+ * square/cube, with the patches split between the ranks.
+ *
+ * The parents and children are set so that the domain created with num_patches is the finer
+ * domain of the domain created with num_patches/2.
+ */
+template <int D>
+std::shared_ptr<ThunderEgg::Domain<D>> createUniformDomain(int num_patches, int n)
+{
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	int total_patches = 1;
+	for (int i = 0; i < D; i++) {
+		total_patches *= num_patches;
+	}
+	int fine_patches   = total_patches << D;
+	int coarse_patches = total_patches >> D;
+
+	double                                                   h = 1.0 / (num_patches * n);
+	std::map<int, std::shared_ptr<ThunderEgg::PatchInfo<D>>> pinfo_map;
+	for (int id = 0; id < total_patches; id++) {
+		if (getOwner(id, total_patches) != rank) {
+			continue;
+		}
+		std::array<int, D> coord;
+		int                rest = id;
+		for (int axis = 0; axis < D; axis++) {
+			coord[axis] = rest % num_patches;
+			rest /= num_patches;
+		}
+
+		auto pinfo             = std::make_shared<ThunderEgg::PatchInfo<D>>();
+		pinfo->id              = id;
+		pinfo->rank            = rank;
+		pinfo->num_ghost_cells = 1;
+		pinfo->ns.fill(n);
+		pinfo->spacings.fill(h);
+
+		int parent_id  = 0;
+		int orth       = 0;
+		int stride     = 1;
+		int parent_str = 1;
+		for (int axis = 0; axis < D; axis++) {
+			pinfo->starts[axis]       = coord[axis] * n * h;
+			ThunderEgg::Side<D> lower = ThunderEgg::Side<D>::LowerSideOnAxis(axis);
+			ThunderEgg::Side<D> upper = ThunderEgg::Side<D>::HigherSideOnAxis(axis);
+			if (coord[axis] > 0) {
+				auto nbr_info  = std::make_shared<ThunderEgg::NormalNbrInfo<D>>(id - stride);
+				nbr_info->rank = getOwner(id - stride, total_patches);
+				pinfo->nbr_info[lower.getIndex()] = nbr_info;
+			}
+			if (coord[axis] < num_patches - 1) {
+				auto nbr_info  = std::make_shared<ThunderEgg::NormalNbrInfo<D>>(id + stride);
+				nbr_info->rank = getOwner(id + stride, total_patches);
+				pinfo->nbr_info[upper.getIndex()] = nbr_info;
+			}
+			parent_id += coord[axis] / 2 * parent_str;
+			orth |= (coord[axis] % 2) << axis;
+			stride *= num_patches;
+			parent_str *= num_patches / 2;
+		}
+		if (num_patches > 1) {
+			pinfo->parent_id      = parent_id;
+			pinfo->parent_rank    = getOwner(parent_id, coarse_patches);
+			pinfo->orth_on_parent = ThunderEgg::Orthant<D>(orth);
+		}
+		for (int child = 0; child < (1 << D); child++) {
+			int child_id     = 0;
+			int child_stride = 1;
+			for (int axis = 0; axis < D; axis++) {
+				child_id += (2 * coord[axis] + ((child >> axis) & 1)) * child_stride;
+				child_stride *= 2 * num_patches;
+			}
+			pinfo->child_ids[child]   = child_id;
+			pinfo->child_ranks[child] = getOwner(child_id, fine_patches);
+		}
+		pinfo_map[id] = pinfo;
+	}
+	std::array<int, D> ns;
+	ns.fill(n);
+	return std::make_shared<ThunderEgg::Domain<D>>(pinfo_map, ns, 1);
+}
+#endif
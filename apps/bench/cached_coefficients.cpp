@@ -0,0 +1,140 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+/**
+ * @file
+ *
+ * @brief Compares VarPoisson::StarPatchOperator with and without cached face coefficients.
+ *
+ * For each patch size a uniform domain with about the same number of cells is created, the ghost
+ * cells are filled once, and applySinglePatch is timed on every patch with the face coefficients
+ * computed on the fly and precomputed. The memory used by the face coefficients is printed
+ * relative to the cell centered coefficients.
+ *
+ * 		mpirun -np 1 ./cached_coefficients [num_reps]
+ */
+
+#include "UniformDomain.h"
+#include <ThunderEgg/BiLinearGhostFiller.h>
+#include <ThunderEgg/TriLinearGhostFiller.h>
+#include <ThunderEgg/ValVector.h>
+#include <ThunderEgg/VarPoisson/StarPatchOperator.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+using namespace std;
+using namespace ThunderEgg;
+
+/**
+ * @brief Fill a vector, including the ghost cells, with a smooth function
+ */
+template <int D> void fillSmooth(shared_ptr<Domain<D>> domain, shared_ptr<Vector<D>> u, double k)
+{
+	for (auto pinfo : domain->getPatchInfoVector()) {
+		LocalData<D> ld = u->getLocalData(0, pinfo->local_index);
+		nested_loop<D>(ld.getGhostStart(), ld.getGhostEnd(), [&](const array<int, D> &coord) {
+			double val = 1;
+			for (int axis = 0; axis < D; axis++) {
+				val *= sin(k * (pinfo->starts[axis] + (coord[axis] + 0.5) * pinfo->spacings[axis]));
+			}
+			ld[coord] = 2 + val;
+		});
+	}
+}
+/**
+ * @brief Time the stencil on every patch of a domain with and without the cached face
+ * coefficients, and print the time per application to the whole domain of each
+ */
+template <int D>
+void timeStencil(const char *name, int n, int num_reps, shared_ptr<Domain<D>> domain,
+                 shared_ptr<GhostFiller<D>> ghost_filler)
+{
+	auto u      = ValVector<D>::GetNewVector(domain, 1);
+	auto f      = ValVector<D>::GetNewVector(domain, 1);
+	auto coeffs = ValVector<D>::GetNewVector(domain, 1);
+	fillSmooth<D>(domain, u, 1);
+	fillSmooth<D>(domain, coeffs, 3);
+
+	VarPoisson::StarPatchOperator<D> op(coeffs, domain, ghost_filler);
+
+	auto apply = [&]() {
+		for (auto pinfo : domain->getPatchInfoVector()) {
+			PatchView<D> us = u->getLocalDatas(pinfo->local_index);
+			PatchView<D> fs = f->getLocalDatas(pinfo->local_index);
+			op.applySinglePatch(pinfo, us, fs, false);
+		}
+	};
+
+	double times[2];
+	for (int cached = 0; cached < 2; cached++) {
+		op.setCachedCoefficients(cached);
+		apply();
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < num_reps; i++) {
+			apply();
+		}
+		auto end      = chrono::steady_clock::now();
+		times[cached] = chrono::duration<double>(end - start).count() / num_reps;
+	}
+
+	double face_values = 0;
+	double cell_values = 1;
+	for (int axis = 0; axis < D; axis++) {
+		double faces = n + 1;
+		for (int b = 0; b < D; b++) {
+			if (b != axis) {
+				faces *= n;
+			}
+		}
+		face_values += faces;
+		cell_values *= n + 2;
+	}
+	printf("%-28s %4d %16.6e %16.6e %8.2fx %8.2fx\n", name, n, times[0], times[1],
+	       times[0] / times[1], face_values / cell_values);
+}
+int main(int argc, char *argv[])
+{
+	MPI_Init(&argc, &argv);
+	int size;
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	if (size != 1) {
+		fprintf(stderr, "cached_coefficients has to be run on a single rank\n");
+		MPI_Abort(MPI_COMM_WORLD, 1);
+	}
+	int num_reps = argc > 1 ? atoi(argv[1]) : 20;
+
+	printf("%-28s %4s %16s %16s %9s %9s\n", "stencil", "n", "uncached (s)", "cached (s)",
+	       "speedup", "memory");
+	for (int n : {8, 16, 24, 32, 64}) {
+		auto domain = createUniformDomain<2>(max(2, 256 / n * 2), n);
+		timeStencil<2>("2d VarPoisson::StarPatchOp", n, num_reps, domain,
+		               make_shared<BiLinearGhostFiller>(domain));
+	}
+	for (int n : {8, 16, 24, 32, 64}) {
+		auto domain = createUniformDomain<3>(max(2, 32 / n * 2), n);
+		timeStencil<3>("3d VarPoisson::StarPatchOp", n, num_reps, domain,
+		               make_shared<TriLinearGhostFiller>(domain));
+	}
+	MPI_Finalize();
+	return 0;
+}
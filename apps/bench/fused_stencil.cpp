@@ -0,0 +1,156 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+/**
+ * @file
+ *
+ * @brief Compares the fused Poisson::StarPatchOperator stencil against a pass for each axis.
+ *
+ * For each patch size a uniform domain with about the same number of cells is created, and the
+ * ghost cells are filled once. Then applySinglePatch, which adds up every axis of a cell before
+ * writing it, is timed on every patch against applyPerAxis, which makes a pass over the patch for
+ * each axis.
+ *
+ * 		mpirun -np 1 ./fused_stencil [num_reps]
+ */
+
+#include "UniformDomain.h"
+#include <ThunderEgg/BiLinearGhostFiller.h>
+#include <ThunderEgg/Poisson/StarPatchOperator.h>
+#include <ThunderEgg/TriLinearGhostFiller.h>
+#include <ThunderEgg/ValVector.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+using namespace std;
+using namespace ThunderEgg;
+
+/**
+ * @brief Apply the star stencil with a pass over the patch for each axis
+ *
+ * This is the stencil that Poisson::StarPatchOperator used before it was fused. Each pass reads
+ * and writes f. The ghost cells of u have to be filled, including on the physical boundaries, and
+ * the rows of u and f have to be contiguous.
+ */
+template <int D>
+void applyPerAxis(const PatchInfo<D> &pinfo, const LocalData<D> &u, LocalData<D> &f)
+{
+	array<double, D> h2 = pinfo.spacings;
+	for (size_t i = 0; i < D; i++) {
+		h2[i] *= h2[i];
+	}
+	nested_row_loop<D>(
+	u.getStart(), u.getEnd(),
+	[&](int n, const double *u_row, double *f_row) {
+		for (int i = 0; i < n; i++) {
+			f_row[i] = (u_row[i + 1] - 2 * u_row[i] + u_row[i - 1]) / h2[0];
+		}
+	},
+	u, f);
+	for (int axis = 1; axis < D; axis++) {
+		int stride = u.getStrides()[axis];
+		nested_row_loop<D>(
+		u.getStart(), u.getEnd(),
+		[&](int n, const double *u_row, double *f_row) {
+			for (int i = 0; i < n; i++) {
+				f_row[i] += (u_row[i + stride] - 2 * u_row[i] + u_row[i - stride]) / h2[axis];
+			}
+		},
+		u, f);
+	}
+}
+/**
+ * @brief Time the stencil on every patch of a domain with a pass for each axis and with the fused
+ * stencil, and print the time per application to the whole domain of each
+ */
+template <int D>
+void timeStencil(const char *name, int n, int num_reps, shared_ptr<Domain<D>> domain,
+                 shared_ptr<GhostFiller<D>> ghost_filler)
+{
+	auto u = ValVector<D>::GetNewVector(domain, 1);
+	auto f = ValVector<D>::GetNewVector(domain, 1);
+	for (auto pinfo : domain->getPatchInfoVector()) {
+		LocalData<D> ld = u->getLocalData(0, pinfo->local_index);
+		nested_loop<D>(ld.getStart(), ld.getEnd(), [&](const array<int, D> &coord) {
+			double val = 1;
+			for (int axis = 0; axis < D; axis++) {
+				val *= sin(pinfo->starts[axis] + (coord[axis] + 0.5) * pinfo->spacings[axis]);
+			}
+			ld[coord] = val;
+		});
+	}
+	ghost_filler->fillGhost(u);
+
+	Poisson::StarPatchOperator<D> op(domain, ghost_filler);
+
+	auto apply = [&](bool fused) {
+		for (auto pinfo : domain->getPatchInfoVector()) {
+			PatchView<D> us = u->getLocalDatas(pinfo->local_index);
+			PatchView<D> fs = f->getLocalDatas(pinfo->local_index);
+			if (fused) {
+				op.applySinglePatch(pinfo, us, fs, false);
+			} else {
+				applyPerAxis<D>(*pinfo, us[0], fs[0]);
+			}
+		}
+	};
+
+	// this also sets the ghost cells on the physical boundaries for applyPerAxis
+	apply(true);
+	double times[2];
+	for (int fused = 0; fused < 2; fused++) {
+		apply(fused);
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < num_reps; i++) {
+			apply(fused);
+		}
+		auto end     = chrono::steady_clock::now();
+		times[fused] = chrono::duration<double>(end - start).count() / num_reps;
+	}
+	printf("%-28s %4d %16.6e %16.6e %8.2fx\n", name, n, times[0], times[1], times[0] / times[1]);
+}
+int main(int argc, char *argv[])
+{
+	MPI_Init(&argc, &argv);
+	int size;
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	if (size != 1) {
+		fprintf(stderr, "fused_stencil has to be run on a single rank\n");
+		MPI_Abort(MPI_COMM_WORLD, 1);
+	}
+	int num_reps = argc > 1 ? atoi(argv[1]) : 20;
+
+	printf("%-28s %4s %16s %16s %9s\n", "stencil", "n", "per axis (s)", "fused (s)", "speedup");
+	for (int n : {8, 16, 24, 32, 64}) {
+		auto domain = createUniformDomain<2>(max(2, 256 / n * 2), n);
+		timeStencil<2>("2d Poisson::StarPatchOp", n, num_reps, domain,
+		               make_shared<BiLinearGhostFiller>(domain));
+	}
+	for (int n : {8, 16, 24, 32, 64}) {
+		auto domain = createUniformDomain<3>(max(2, 32 / n * 2), n);
+		timeStencil<3>("3d Poisson::StarPatchOp", n, num_reps, domain,
+		               make_shared<TriLinearGhostFiller>(domain));
+	}
+	MPI_Finalize();
+	return 0;
+}
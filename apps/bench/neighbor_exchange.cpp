@@ -0,0 +1,161 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+/**
+ * @file
+ *
+ * @brief Compares point-to-point messages against neighbor collectives for the ghost exchanges
+ *
+ * A uniform domain is split into blocks of patches, one for each rank, and the ghost cell fills of
+ * MPIGhostFiller and the scatters of GMG::InterLevelComm are timed with point-to-point messages
+ * and with MPI_Ineighbor_alltoallv. The times are the maximum over the ranks.
+ *
+ * 		mpirun -np 4 ./neighbor_exchange [num_reps]
+ */
+
+#include "UniformDomain.h"
+#include <ThunderEgg/BiLinearGhostFiller.h>
+#include <ThunderEgg/GMG/InterLevelComm.h>
+#include <ThunderEgg/TriLinearGhostFiller.h>
+#include <ThunderEgg/ValVector.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace ThunderEgg;
+
+/**
+ * @brief Time a function with point-to-point messages and with neighbor collectives, and print
+ * the maximum time per call over the ranks of each
+ *
+ * @param name the name of the exchange
+ * @param n the number of cells along each axis of a patch
+ * @param num_reps the number of times to call the function
+ * @param set_use_neighbor_collectives switches between the two ways of communicating
+ * @param f the exchange
+ */
+void timeExchange(const string &name, int n, int num_reps,
+                  function<void(bool)> set_use_neighbor_collectives, function<void()> f)
+{
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	double times[2];
+	for (int neighbor = 0; neighbor < 2; neighbor++) {
+		set_use_neighbor_collectives(neighbor);
+		f();
+		MPI_Barrier(MPI_COMM_WORLD);
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < num_reps; i++) {
+			f();
+		}
+		auto   end  = chrono::steady_clock::now();
+		double time = chrono::duration<double>(end - start).count() / num_reps;
+		MPI_Allreduce(&time, &times[neighbor], 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+	}
+	set_use_neighbor_collectives(false);
+	if (rank == 0) {
+		printf("%-28s %4d %16.6e %16.6e %8.2fx\n", name.c_str(), n, times[0], times[1],
+		       times[0] / times[1]);
+	}
+}
+/**
+ * @brief Time the exchanges of a GMG::InterLevelComm between a domain and a coarser domain
+ */
+template <int D>
+void timeInterLevelComm(const string &prefix, int n, int num_reps, shared_ptr<Domain<D>> domain,
+                        shared_ptr<Domain<D>> coarse_domain)
+{
+	auto ilc = make_shared<GMG::InterLevelComm<D>>(coarse_domain, 1, domain);
+
+	auto coarse = ValVector<D>::GetNewVector(coarse_domain, 1);
+	auto ghost  = ilc->getNewGhostVector();
+
+	auto set_use = [&](bool use) { ilc->setUseNeighborCollectives(use); };
+	timeExchange(prefix + " InterLevelComm send", n, num_reps, set_use, [&]() {
+		ilc->sendGhostPatchesStart(coarse, ghost);
+		ilc->sendGhostPatchesFinish(coarse, ghost);
+	});
+	timeExchange(prefix + " InterLevelComm get", n, num_reps, set_use, [&]() {
+		ilc->getGhostPatchesStart(coarse, ghost);
+		ilc->getGhostPatchesFinish(coarse, ghost);
+	});
+}
+/**
+ * @brief Time the two dimensional exchanges
+ */
+void run2d(int n, int num_reps)
+{
+	int  num_patches   = max(2, 256 / n * 2);
+	auto domain        = createUniformDomain<2>(num_patches, n);
+	auto coarse_domain = createUniformDomain<2>(num_patches / 2, n);
+
+	auto u        = ValVector<2>::GetNewVector(domain, 1);
+	auto bilinear = make_shared<BiLinearGhostFiller>(domain);
+
+	timeExchange(
+	"2d BiLinearGhostFiller", n, num_reps,
+	[&](bool use) { bilinear->setUseNeighborCollectives(use); },
+	[&]() { bilinear->fillGhost(u); });
+	timeInterLevelComm<2>("2d", n, num_reps, domain, coarse_domain);
+}
+/**
+ * @brief Time the three dimensional exchanges
+ */
+void run3d(int n, int num_reps)
+{
+	int  num_patches   = max(2, 32 / n * 2);
+	auto domain        = createUniformDomain<3>(num_patches, n);
+	auto coarse_domain = createUniformDomain<3>(num_patches / 2, n);
+
+	auto u         = ValVector<3>::GetNewVector(domain, 1);
+	auto trilinear = make_shared<TriLinearGhostFiller>(domain);
+
+	timeExchange(
+	"3d TriLinearGhostFiller", n, num_reps,
+	[&](bool use) { trilinear->setUseNeighborCollectives(use); },
+	[&]() { trilinear->fillGhost(u); });
+	timeInterLevelComm<3>("3d", n, num_reps, domain, coarse_domain);
+}
+int main(int argc, char *argv[])
+{
+	MPI_Init(&argc, &argv);
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	int num_reps = argc > 1 ? atoi(argv[1]) : 20;
+
+	if (rank == 0) {
+		printf("%-28s %4s %16s %16s %9s\n", "exchange", "n", "p2p (s)", "neighbor (s)",
+		       "speedup");
+	}
+	// small patches are where the exchanges are bound by latency
+	for (int n : {4, 8, 16, 32}) {
+		run2d(n, num_reps);
+	}
+	for (int n : {4, 8, 16}) {
+		run3d(n, num_reps);
+	}
+	MPI_Finalize();
+	return 0;
+}
@@ -0,0 +1,143 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+/**
+ * @file
+ *
+ * @brief Compares the specialized patch size kernels against the generic ones.
+ *
+ * For each patch size a uniform domain with about the same number of cells is created, and
+ * GMG::LinearRestrictor, the only dispatched kernel, is timed with PatchSizeDispatch enabled and
+ * disabled.
+ *
+ * 		mpirun -np 1 ./patch_size_dispatch [num_reps]
+ */
+
+#include "UniformDomain.h"
+#include <ThunderEgg/GMG/LinearRestrictor.h>
+#include <ThunderEgg/PatchSizeDispatch.h>
+#include <ThunderEgg/ValVector.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace ThunderEgg;
+
+/**
+ * @brief Create a vector for a domain, filled with a smooth function
+ */
+template <int D> shared_ptr<ValVector<D>> createVector(shared_ptr<const Domain<D>> domain)
+{
+	auto vec = make_shared<ValVector<D>>(MPI_COMM_WORLD, domain->getNs(),
+	                                     domain->getNumGhostCells(), 1,
+	                                     domain->getNumLocalPatches());
+	for (auto pinfo : domain->getPatchInfoVector()) {
+		LocalData<D> ld = vec->getLocalData(0, pinfo->local_index);
+		nested_loop<D>(ld.getStart(), ld.getEnd(), [&](const array<int, D> &coord) {
+			double val = 1;
+			for (int axis = 0; axis < D; axis++) {
+				val *= sin(pinfo->starts[axis] + (coord[axis] + 0.5) * pinfo->spacings[axis]);
+			}
+			ld[coord] = val;
+		});
+	}
+	return vec;
+}
+/**
+ * @brief Time a function with the specialized kernels disabled and enabled, and print the time
+ * per call of each
+ */
+void timeKernel(const string &name, int n, int num_reps, function<void()> f)
+{
+	double times[2];
+	for (int enabled = 0; enabled < 2; enabled++) {
+		PatchSizeDispatch::SetEnabled(enabled);
+		f();
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < num_reps; i++) {
+			f();
+		}
+		auto end = chrono::steady_clock::now();
+		times[enabled] = chrono::duration<double>(end - start).count() / num_reps;
+	}
+	PatchSizeDispatch::SetEnabled(true);
+	printf("%-28s %4d %16.6e %16.6e %8.2fx\n", name.c_str(), n, times[0], times[1],
+	       times[0] / times[1]);
+}
+/**
+ * @brief Time the two dimensional restrictor
+ */
+void run2d(int n, int num_reps)
+{
+	int  num_patches   = max(2, 256 / n * 2);
+	auto domain        = createUniformDomain<2>(num_patches, n);
+	auto coarse_domain = createUniformDomain<2>(num_patches / 2, n);
+
+	auto u      = createVector<2>(domain);
+	auto coarse = createVector<2>(coarse_domain);
+
+	GMG::LinearRestrictor<2> restrictor(domain, coarse_domain, 1);
+
+	timeKernel("2d LinearRestrictor", n, num_reps, [&]() { restrictor.restrict(u, coarse); });
+}
+/**
+ * @brief Time the three dimensional restrictor
+ */
+void run3d(int n, int num_reps)
+{
+	int  num_patches   = max(2, 32 / n * 2);
+	auto domain        = createUniformDomain<3>(num_patches, n);
+	auto coarse_domain = createUniformDomain<3>(num_patches / 2, n);
+
+	auto u      = createVector<3>(domain);
+	auto coarse = createVector<3>(coarse_domain);
+
+	GMG::LinearRestrictor<3> restrictor(domain, coarse_domain, 1);
+
+	timeKernel("3d LinearRestrictor", n, num_reps, [&]() { restrictor.restrict(u, coarse); });
+}
+int main(int argc, char *argv[])
+{
+	MPI_Init(&argc, &argv);
+	int size;
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	if (size != 1) {
+		fprintf(stderr, "patch_size_dispatch has to be run on a single rank\n");
+		MPI_Abort(MPI_COMM_WORLD, 1);
+	}
+	int num_reps = argc > 1 ? atoi(argv[1]) : 20;
+
+	printf("%-28s %4s %16s %16s %9s\n", "kernel", "n", "generic (s)", "specialized (s)",
+	       "speedup");
+	// 24 is not specialized, and is included to check that the fallback has no overhead
+	for (int n : {8, 16, 24, 32, 64}) {
+		run2d(n, num_reps);
+	}
+	for (int n : {8, 16, 24, 32, 64}) {
+		run3d(n, num_reps);
+	}
+	MPI_Finalize();
+	return 0;
+}
@@ -0,0 +1,131 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+/**
+ * @file
+ *
+ * @brief Compares the 3D star stencils with and without cache tiling, across patch sizes.
+ *
+ * For each patch size a domain of 2x2x2 patches is created, the ghost cells are filled once, and
+ * applySinglePatch of Poisson::StarPatchOperator and VarPoisson::StarPatchOperator is timed on
+ * every patch untiled, with a few fixed tile sizes on the y axis, and with the tile sizes chosen
+ * by Tiling::ChooseTileSizes (printed as the y tile size, 0 if it does not tile).
+ *
+ * 		mpirun -np 1 ./tiled_stencil [num_reps]
+ */
+
+#include "UniformDomain.h"
+#include <ThunderEgg/Poisson/StarPatchOperator.h>
+#include <ThunderEgg/Tiling.h>
+#include <ThunderEgg/TriLinearGhostFiller.h>
+#include <ThunderEgg/ValVector.h>
+#include <ThunderEgg/VarPoisson/StarPatchOperator.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+using namespace std;
+using namespace ThunderEgg;
+
+/**
+ * @brief Fill a vector, including the ghost cells, with a smooth function
+ */
+template <int D> void fillSmooth(shared_ptr<Domain<D>> domain, shared_ptr<Vector<D>> u, double k)
+{
+	for (auto pinfo : domain->getPatchInfoVector()) {
+		LocalData<D> ld = u->getLocalData(0, pinfo->local_index);
+		nested_loop<D>(ld.getGhostStart(), ld.getGhostEnd(), [&](const array<int, D> &coord) {
+			double val = 1;
+			for (int axis = 0; axis < D; axis++) {
+				val *= sin(k * (pinfo->starts[axis] + (coord[axis] + 0.5) * pinfo->spacings[axis]));
+			}
+			ld[coord] = 2 + val;
+		});
+	}
+}
+/**
+ * @brief Time applySinglePatch on every patch of the domain, for each of the tile sizes, and print
+ * the time per application to the whole domain of each
+ */
+template <typename Op>
+void timeTiles(const char *name, int n, int num_reps, shared_ptr<Domain<3>> domain, Op &op,
+               shared_ptr<Vector<3>> u, shared_ptr<Vector<3>> f)
+{
+	auto apply = [&]() {
+		for (auto pinfo : domain->getPatchInfoVector()) {
+			PatchView<3> us = u->getLocalDatas(pinfo->local_index);
+			PatchView<3> fs = f->getLocalDatas(pinfo->local_index);
+			op.applySinglePatch(pinfo, us, fs, false);
+		}
+	};
+	auto time = [&](const array<int, 3> &tile_sizes) {
+		op.setTileSizes(tile_sizes);
+		apply();
+		auto start = chrono::steady_clock::now();
+		for (int i = 0; i < num_reps; i++) {
+			apply();
+		}
+		auto end = chrono::steady_clock::now();
+		return chrono::duration<double>(end - start).count() / num_reps;
+	};
+
+	array<int, 3> auto_tile_sizes = op.getTileSizes();
+
+	double untiled = time({0, 0, 0});
+	printf("%-28s %4d %13.4e", name, n, untiled);
+	for (int tile_size : {8, 16, 32}) {
+		printf(" %7.2fx", untiled / time({0, tile_size, 0}));
+	}
+	printf(" %7.2fx %6d\n", untiled / time(auto_tile_sizes), auto_tile_sizes[1]);
+}
+int main(int argc, char *argv[])
+{
+	MPI_Init(&argc, &argv);
+	int size;
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	if (size != 1) {
+		fprintf(stderr, "tiled_stencil has to be run on a single rank\n");
+		MPI_Abort(MPI_COMM_WORLD, 1);
+	}
+	int num_reps = argc > 1 ? atoi(argv[1]) : 10;
+
+	printf("cache size used to choose tiles: %ld bytes\n", Tiling::GetCacheSize());
+	printf("%-28s %4s %13s %8s %8s %8s %8s %6s\n", "stencil", "n", "untiled (s)", "ty=8",
+	       "ty=16", "ty=32", "auto", "auto ty");
+	for (int n : {32, 64, 96, 128, 192}) {
+		auto domain = createUniformDomain<3>(2, n);
+		auto gf     = make_shared<TriLinearGhostFiller>(domain);
+		auto u      = ValVector<3>::GetNewVector(domain, 1);
+		auto f      = ValVector<3>::GetNewVector(domain, 1);
+		auto coeffs = ValVector<3>::GetNewVector(domain, 1);
+		fillSmooth<3>(domain, u, 1);
+		fillSmooth<3>(domain, coeffs, 3);
+
+		Poisson::StarPatchOperator<3> poisson(domain, gf);
+		timeTiles("3d Poisson::StarPatchOp", n, num_reps, domain, poisson, u, f);
+
+		VarPoisson::StarPatchOperator<3> var_poisson(coeffs, domain, gf);
+		timeTiles("3d VarPoisson::StarPatchOp", n, num_reps, domain, var_poisson, u, f);
+	}
+	MPI_Finalize();
+	return 0;
+}
@@ -32,6 +32,7 @@
 #include <ThunderEgg/Iterative/PatchSolver.h>
 #include <ThunderEgg/PETSc/MatWrapper.h>
 #include <ThunderEgg/PETSc/PCShellCreator.h>
+#include <ThunderEgg/PooledVectorGenerator.h>
 #include <ThunderEgg/Timer.h>
 #include <ThunderEgg/ValVectorGenerator.h>
 #include <ThunderEgg/VarPoisson/StarPatchOperator.h>
@@ -281,7 +282,8 @@ int main(int argc, char *argv[])
 	for (int loop = 0; loop < loop_count; loop++) {
 		timer->start("Domain Initialization");
 
-		auto                  vg    = make_shared<ValVectorGenerator<2>>(domain, 1);
+		auto vg
+		= make_shared<PooledVectorGenerator<2>>(make_shared<ValVectorGenerator<2>>(domain, 1));
 		shared_ptr<Vector<2>> u     = vg->getNewVector();
 		shared_ptr<Vector<2>> exact = vg->getNewVector();
 		shared_ptr<Vector<2>> f     = vg->getNewVector();
@@ -358,7 +360,7 @@ int main(int argc, char *argv[])
 				restrictor = make_shared<GMG::LinearRestrictor<2>>(curr_domain, next_domain, 1);
 
 				builder.addIntermediateLevel(new_p_operator, new_p_solver, restrictor, interpolator,
-				                             vg);
+				                             make_shared<PooledVectorGenerator<2>>(new_vg));
 				prev_domain = curr_domain;
 				curr_domain = next_domain;
 			}
@@ -377,7 +379,8 @@ int main(int argc, char *argv[])
 
 			auto coarse_p_solver
 			= make_shared<Iterative::PatchSolver<2>>(p_bcgs, coarse_p_operator);
-			builder.addCoarsestLevel(coarse_p_operator, coarse_p_solver, interpolator, coarse_vg);
+			builder.addCoarsestLevel(coarse_p_operator, coarse_p_solver, interpolator,
+			                         make_shared<PooledVectorGenerator<2>>(coarse_vg));
 
 			M = builder.getCycle();
 
@@ -396,6 +399,8 @@ int main(int argc, char *argv[])
 		int its = solver.solve(vg, A, u, f, M);
 		if (my_global_rank == 0) {
 			cout << "Iterations: " << its << endl;
+			cout << "Vector pool hits: " << vg->getNumHits() << " misses: " << vg->getNumMisses()
+			     << " peak bytes: " << vg->getPeakNumBytes() << endl;
 		}
 		timer->stop("Linear Solve");
 
@@ -0,0 +1,89 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include <ThunderEgg/AsyncReduction.h>
+#include <ThunderEgg/RuntimeError.h>
+#include <cmath>
+namespace ThunderEgg
+{
+AsyncReduction::AsyncReduction(double local_value, MPI_Op op, MPI_Comm comm, bool take_sqrt)
+: state(new State())
+{
+	state->local_value = local_value;
+	state->take_sqrt   = take_sqrt;
+	MPI_Iallreduce(&state->local_value, &state->global_value, 1, MPI_DOUBLE, op, comm,
+	               &state->request);
+}
+AsyncReduction AsyncReduction::Sum(double local_value, MPI_Comm comm)
+{
+	return AsyncReduction(local_value, MPI_SUM, comm, false);
+}
+AsyncReduction AsyncReduction::TwoNorm(double local_sum_of_squares, MPI_Comm comm)
+{
+	return AsyncReduction(local_sum_of_squares, MPI_SUM, comm, true);
+}
+AsyncReduction AsyncReduction::Max(double local_value, MPI_Comm comm)
+{
+	return AsyncReduction(local_value, MPI_MAX, comm, false);
+}
+AsyncReduction &AsyncReduction::operator=(AsyncReduction &&other)
+{
+	if (this != &other) {
+		if (state != nullptr) {
+			finish();
+		}
+		state = std::move(other.state);
+	}
+	return *this;
+}
+AsyncReduction::~AsyncReduction()
+{
+	if (state != nullptr && !state->finished) {
+		MPI_Wait(&state->request, MPI_STATUS_IGNORE);
+	}
+}
+bool AsyncReduction::test()
+{
+	if (state == nullptr) {
+		throw RuntimeError("AsyncReduction has been moved from");
+	}
+	if (state->finished) {
+		return true;
+	}
+	int flag;
+	MPI_Test(&state->request, &flag, MPI_STATUS_IGNORE);
+	return flag;
+}
+double AsyncReduction::finish()
+{
+	if (state == nullptr) {
+		throw RuntimeError("AsyncReduction has been moved from");
+	}
+	if (!state->finished) {
+		MPI_Wait(&state->request, MPI_STATUS_IGNORE);
+		if (state->take_sqrt) {
+			state->global_value = sqrt(state->global_value);
+		}
+		state->finished = true;
+	}
+	return state->global_value;
+}
+} // namespace ThunderEgg
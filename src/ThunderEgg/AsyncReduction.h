@@ -0,0 +1,144 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_ASYNCREDUCTION_H
+#define THUNDEREGG_ASYNCREDUCTION_H
+#include <memory>
+#include <mpi.h>
+namespace ThunderEgg
+{
+/**
+ * @brief A global reduction of a single value that is in progress
+ *
+ * The reduction is started with MPI_Iallreduce when the object is created, and finish() waits for
+ * it to complete. Work that does not depend on the result can be done in between, so that the
+ * latency of the reduction is hidden:
+ *
+ * 		AsyncReduction r_dot_r = r->dotStart(r);
+ * 		op->apply(p, ap);
+ * 		double rho = r_dot_r.finish();
+ *
+ * How much of the reduction progresses while the process is busy depends on the MPI
+ * implementation. If the object is destroyed before finish() is called, the destructor waits for
+ * the reduction to complete.
+ *
+ * The object can be moved but not copied.
+ */
+class AsyncReduction
+{
+	private:
+	/**
+	 * @brief The state of the reduction, kept on the heap so that the buffers that MPI is using
+	 * do not move when the object is moved
+	 */
+	struct State {
+		/**
+		 * @brief the local value
+		 */
+		double local_value;
+		/**
+		 * @brief the global value, valid after the request has completed
+		 */
+		double global_value = 0;
+		/**
+		 * @brief the request for the MPI_Iallreduce
+		 */
+		MPI_Request request = MPI_REQUEST_NULL;
+		/**
+		 * @brief true if the square root of the global value is the result
+		 */
+		bool take_sqrt = false;
+		/**
+		 * @brief true if finish has been called
+		 */
+		bool finished = false;
+	};
+	/**
+	 * @brief the state, null if the object has been moved from
+	 */
+	std::unique_ptr<State> state;
+
+	/**
+	 * @brief Start a reduction
+	 *
+	 * @param local_value the local value
+	 * @param op the MPI reduction operation
+	 * @param comm the communicator
+	 * @param take_sqrt true if the square root of the reduced value is the result
+	 */
+	AsyncReduction(double local_value, MPI_Op op, MPI_Comm comm, bool take_sqrt);
+
+	public:
+	/**
+	 * @brief Start a global sum
+	 *
+	 * This is a collective call over comm.
+	 *
+	 * @param local_value the local value
+	 * @param comm the communicator
+	 */
+	static AsyncReduction Sum(double local_value, MPI_Comm comm);
+	/**
+	 * @brief Start a global l2 norm, the result is the square root of the global sum
+	 *
+	 * This is a collective call over comm.
+	 *
+	 * @param local_sum_of_squares the local sum of the squares of the values
+	 * @param comm the communicator
+	 */
+	static AsyncReduction TwoNorm(double local_sum_of_squares, MPI_Comm comm);
+	/**
+	 * @brief Start a global maximum
+	 *
+	 * This is a collective call over comm.
+	 *
+	 * @param local_value the local value
+	 * @param comm the communicator
+	 */
+	static AsyncReduction Max(double local_value, MPI_Comm comm);
+	AsyncReduction(const AsyncReduction &) = delete;
+	AsyncReduction &operator=(const AsyncReduction &) = delete;
+	AsyncReduction(AsyncReduction &&)                 = default;
+	/**
+	 * @brief Move assignment, waits for the reduction that is being replaced
+	 */
+	AsyncReduction &operator=(AsyncReduction &&other);
+	/**
+	 * @brief Waits for the reduction if finish() was not called
+	 */
+	~AsyncReduction();
+	/**
+	 * @brief Check if the reduction has completed, without blocking
+	 *
+	 * @return true if finish() will not block
+	 */
+	bool test();
+	/**
+	 * @brief Wait for the reduction to complete and get the result
+	 *
+	 * This can be called more than once, later calls return the same result.
+	 *
+	 * @return double the result
+	 */
+	double finish();
+};
+} // namespace ThunderEgg
+#endif
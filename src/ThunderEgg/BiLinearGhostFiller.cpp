@@ -25,8 +25,8 @@ namespace ThunderEgg
 {
 namespace
 {
-void FillGhostForNormalNbr(const std::vector<LocalData<2>> &local_datas,
-                           const std::vector<LocalData<2>> &nbr_datas, const Side<2> side)
+void FillGhostForNormalNbr(const PatchView<2> &local_datas, const PatchView<2> &nbr_datas,
+                           const Side<2> side)
 {
 	for (size_t c = 0; c < local_datas.size(); c++) {
 		auto local_slice = local_datas[c].getSliceOnSide(side);
@@ -37,9 +37,8 @@ void FillGhostForNormalNbr(const std::vector<LocalData<2>> &local_datas,
 	}
 }
 void FillGhostForCoarseNbr(std::shared_ptr<const PatchInfo<2>> pinfo,
-                           const std::vector<LocalData<2>> &   local_datas,
-                           const std::vector<LocalData<2>> &nbr_datas, const Side<2> side,
-                           const Orthant<2> orthant)
+                           const PatchView<2> &local_datas, const PatchView<2> &nbr_datas,
+                           const Side<2> side, const Orthant<2> orthant)
 {
 	auto nbr_info = pinfo->getCoarseNbrInfo(side);
 	int  offset   = 0;
@@ -56,9 +55,8 @@ void FillGhostForCoarseNbr(std::shared_ptr<const PatchInfo<2>> pinfo,
 	}
 }
 void FillGhostForFineNbr(std::shared_ptr<const PatchInfo<2>> pinfo,
-                         const std::vector<LocalData<2>> &   local_datas,
-                         const std::vector<LocalData<2>> &nbr_datas, const Side<2> side,
-                         const Orthant<2> orthant)
+                         const PatchView<2> &local_datas, const PatchView<2> &nbr_datas,
+                         const Side<2> side, const Orthant<2> orthant)
 {
 	auto nbr_info = pinfo->getFineNbrInfo(side);
 	int  offset   = 0;
@@ -104,8 +102,8 @@ void FillLocalGhostsForFineNbr(const LocalData<2> &local_data, const Side<2> sid
 }
 } // namespace
 void BiLinearGhostFiller::fillGhostCellsForNbrPatch(std::shared_ptr<const PatchInfo<2>> pinfo,
-                                                    const std::vector<LocalData<2>> &   local_datas,
-                                                    const std::vector<LocalData<2>> &   nbr_datas,
+                                                    const PatchView<2> &local_datas,
+                                                    const PatchView<2> &nbr_datas,
                                                     const Side<2> side, const NbrType nbr_type,
                                                     const Orthant<2> orthant) const
 {
@@ -124,8 +122,13 @@ void BiLinearGhostFiller::fillGhostCellsForNbrPatch(std::shared_ptr<const PatchI
 	}
 }
 
-void BiLinearGhostFiller::fillGhostCellsForLocalPatch(
-std::shared_ptr<const PatchInfo<2>> pinfo, const std::vector<LocalData<2>> &local_datas) const
+bool BiLinearGhostFiller::copiesNormalNbrGhosts() const
+{
+	return true;
+}
+
+void BiLinearGhostFiller::fillGhostCellsForLocalPatch(std::shared_ptr<const PatchInfo<2>> pinfo,
+                                                      const PatchView<2> &local_datas) const
 {
 	for (auto &local_data : local_datas) {
 		for (Side<2> side : Side<2>::getValues()) {
@@ -42,11 +42,12 @@ class BiLinearGhostFiller : public MPIGhostFiller<2>
 	{
 	}
 	void fillGhostCellsForNbrPatch(std::shared_ptr<const PatchInfo<2>> pinfo,
-	                               const std::vector<LocalData<2>> &   local_datas,
-	                               const std::vector<LocalData<2>> &nbr_datas, const Side<2> side,
-	                               const NbrType nbr_type, const Orthant<2> orthant) const override;
+	                               const PatchView<2> &local_datas, const PatchView<2> &nbr_datas,
+	                               const Side<2> side, const NbrType nbr_type,
+	                               const Orthant<2> orthant) const override;
+	bool copiesNormalNbrGhosts() const override;
 	void fillGhostCellsForLocalPatch(std::shared_ptr<const PatchInfo<2>> pinfo,
-	                                 const std::vector<LocalData<2>> &local_datas) const override;
+	                                 const PatchView<2> &local_datas) const override;
 };
 } // namespace ThunderEgg
 #endif
@@ -46,8 +46,8 @@ void FillGhostForLocalWithFineNbr(const LocalData<2> &local_data, const Side<2>
 	}
 	ghost[{n - 1}] += -slice[{n - 1}] / 10 + slice[{n - 2}] / 15 - slice[{n - 3}] / 30;
 }
-void FillGhostForNormalNbr(const std::vector<LocalData<2>> &local_datas,
-                           const std::vector<LocalData<2>> &nbr_datas, const Side<2> side)
+void FillGhostForNormalNbr(const PatchView<2> &local_datas, const PatchView<2> &nbr_datas,
+                           const Side<2> side)
 {
 	for (size_t c = 0; c < local_datas.size(); c++) {
 		auto local_slice = local_datas[c].getSliceOnSide(side);
@@ -57,8 +57,8 @@ void FillGhostForNormalNbr(const std::vector<LocalData<2>> &local_datas,
 		[&](const std::array<int, 1> &coord) { nbr_ghosts[coord] = local_slice[coord]; });
 	}
 }
-void FillGhostForCoarseNbrLower(const std::vector<LocalData<2>> &local_datas,
-                                const std::vector<LocalData<2>> &nbr_datas, const Side<2> side)
+void FillGhostForCoarseNbrLower(const PatchView<2> &local_datas, const PatchView<2> &nbr_datas,
+                                const Side<2> side)
 {
 	for (size_t c = 0; c < local_datas.size(); c++) {
 		auto slice       = local_datas[c].getSliceOnSide(side);
@@ -70,8 +70,8 @@ void FillGhostForCoarseNbrLower(const std::vector<LocalData<2>> &local_datas,
 		}
 	}
 }
-void FillGhostForCoarseNbrUpper(const std::vector<LocalData<2>> &local_datas,
-                                const std::vector<LocalData<2>> &nbr_datas, const Side<2> side)
+void FillGhostForCoarseNbrUpper(const PatchView<2> &local_datas, const PatchView<2> &nbr_datas,
+                                const Side<2> side)
 {
 	for (size_t c = 0; c < local_datas.size(); c++) {
 		auto slice       = local_datas[c].getSliceOnSide(side);
@@ -83,8 +83,8 @@ void FillGhostForCoarseNbrUpper(const std::vector<LocalData<2>> &local_datas,
 		}
 	}
 }
-void FillGhostForFineNbrLower(const std::vector<LocalData<2>> &local_datas,
-                              const std::vector<LocalData<2>> &nbr_datas, const Side<2> side)
+void FillGhostForFineNbrLower(const PatchView<2> &local_datas, const PatchView<2> &nbr_datas,
+                              const Side<2> side)
 {
 	for (size_t c = 0; c < local_datas.size(); c++) {
 		auto slice = local_datas[c].getSliceOnSide(side);
@@ -103,8 +103,8 @@ void FillGhostForFineNbrLower(const std::vector<LocalData<2>> &local_datas,
 		}
 	}
 }
-void FillGhostForFineNbrUpper(const std::vector<LocalData<2>> &local_datas,
-                              const std::vector<LocalData<2>> &nbr_datas, const Side<2> side)
+void FillGhostForFineNbrUpper(const PatchView<2> &local_datas, const PatchView<2> &nbr_datas,
+                              const Side<2> side)
 {
 	for (size_t c = 0; c < local_datas.size(); c++) {
 		auto slice = local_datas[c].getSliceOnSide(side);
@@ -126,8 +126,8 @@ void FillGhostForFineNbrUpper(const std::vector<LocalData<2>> &local_datas,
 } // namespace
 
 void BiQuadraticGhostFiller::fillGhostCellsForNbrPatch(std::shared_ptr<const PatchInfo<2>> pinfo,
-                                                       const std::vector<LocalData<2>> &local_datas,
-                                                       const std::vector<LocalData<2>> &nbr_datas,
+                                                       const PatchView<2> &local_datas,
+                                                       const PatchView<2> &nbr_datas,
                                                        const Side<2> side, const NbrType nbr_type,
                                                        const Orthant<2> orthant) const
 {
@@ -154,8 +154,13 @@ void BiQuadraticGhostFiller::fillGhostCellsForNbrPatch(std::shared_ptr<const Pat
 	}
 }
 
-void BiQuadraticGhostFiller::fillGhostCellsForLocalPatch(
-std::shared_ptr<const PatchInfo<2>> pinfo, const std::vector<LocalData<2>> &local_datas) const
+bool BiQuadraticGhostFiller::copiesNormalNbrGhosts() const
+{
+	return true;
+}
+
+void BiQuadraticGhostFiller::fillGhostCellsForLocalPatch(std::shared_ptr<const PatchInfo<2>> pinfo,
+                                                         const PatchView<2> &local_datas) const
 {
 	for (const auto &local_data : local_datas) {
 		for (Side<2> side : Side<2>::getValues()) {
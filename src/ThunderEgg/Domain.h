@@ -22,6 +22,7 @@
 #ifndef THUNDEREGG_DOMAIN_H
 #define THUNDEREGG_DOMAIN_H
 #include <ThunderEgg/PatchInfo.h>
+#include <ThunderEgg/Threading.h>
 #include <ThunderEgg/Timer.h>
 #include <ThunderEgg/Vector.h>
 #include <cmath>
@@ -347,21 +348,34 @@ template <int D> class Domain
 	 */
 	double integrate(std::shared_ptr<const Vector<D>> u) const
 	{
-		double sum = 0;
-
-		for (auto &p : pinfo_id_map) {
-			PatchInfo<D> &d = *p.second;
+		// integrate each patch, the patches are then summed in order so that the result does not
+		// depend on the number of threads
+		std::vector<double> patch_sums(pinfo_vector.size() * u->getNumComponents());
+		Threading::ParallelFor(
+		pinfo_vector.size(),
+		[&](int i) {
+			const PatchInfo<D> &d = *pinfo_vector[i];
 			for (int c = 0; c < u->getNumComponents(); c++) {
 				const LocalData<D> u_data = u->getLocalData(c, d.local_index);
 
 				double patch_sum = 0;
-				nested_loop<D>(u_data.getStart(), u_data.getEnd(),
-				               [&](std::array<int, D> coord) { patch_sum += u_data[coord]; });
+				cell_loop<D>(
+				u_data.getStart(), u_data.getEnd(), [&](const double &u) { patch_sum += u; },
+				u_data);
 
-				for (size_t i = 0; i < D; i++) {
-					patch_sum *= d.spacings[i];
+				for (size_t axis = 0; axis < D; axis++) {
+					patch_sum *= d.spacings[axis];
 				}
-				sum += patch_sum;
+				patch_sums[d.local_index * u->getNumComponents() + c] = patch_sum;
+			}
+		},
+		u->isThreadSafe());
+
+		double sum = 0;
+		for (auto &p : pinfo_id_map) {
+			PatchInfo<D> &d = *p.second;
+			for (int c = 0; c < u->getNumComponents(); c++) {
+				sum += patch_sums[d.local_index * u->getNumComponents() + c];
 			}
 		}
 		double retval;
@@ -0,0 +1,250 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_GMG_CHEBYSHEVSMOOTHER_H
+#define THUNDEREGG_GMG_CHEBYSHEVSMOOTHER_H
+
+#include <ThunderEgg/GMG/Smoother.h>
+#include <ThunderEgg/Operator.h>
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/Threading.h>
+#include <ThunderEgg/VectorGenerator.h>
+#include <random>
+
+namespace ThunderEgg
+{
+namespace GMG
+{
+/**
+ * @brief Chebyshev polynomial smoother, preconditioned with the inverse of the diagonal
+ *
+ * Each call to smooth does degree steps of the Chebyshev iteration for D^-1 A u = D^-1 f, which
+ * damps the error components with eigenvalues of D^-1 A in [lower, upper]. This only needs the
+ * operator to be applied and the inverse of its diagonal, so it is much cheaper than smoothers
+ * that solve each patch.
+ *
+ * The largest eigenvalue of D^-1 A is estimated with a few power iterations when the smoother is
+ * constructed. The upper bound is a bit larger than the estimate, since power iteration
+ * underestimates it, and the lower bound is a fraction of it, since only the upper part of the
+ * spectrum has to be damped by a smoother.
+ *
+ * The eigenvalues of D^-1 A have to be positive. This holds for the negative definite Laplacians
+ * in ThunderEgg, since their diagonals are negative.
+ *
+ * @tparam D the number of Cartesian dimensions
+ */
+template <int D> class ChebyshevSmoother : public Smoother<D>
+{
+	private:
+	/**
+	 * @brief The operator
+	 */
+	std::shared_ptr<const Operator<D>> op;
+	/**
+	 * @brief The inverse of the diagonal of the operator
+	 */
+	std::shared_ptr<const Vector<D>> inv_diag;
+	/**
+	 * @brief Generates the work vectors
+	 */
+	std::shared_ptr<const VectorGenerator<D>> vg;
+	/**
+	 * @brief The number of steps in each call to smooth
+	 */
+	int degree;
+	/**
+	 * @brief The estimate of the largest eigenvalue of D^-1 A
+	 */
+	double max_eigenvalue;
+	/**
+	 * @brief The lower bound of the eigenvalues that are damped
+	 */
+	double lower;
+	/**
+	 * @brief The upper bound of the eigenvalues that are damped
+	 */
+	double upper;
+	/**
+	 * @brief Multiply each value in a vector by the inverse of the diagonal
+	 *
+	 * @param r the vector
+	 */
+	void applyInverseDiagonal(std::shared_ptr<Vector<D>> r) const
+	{
+		Threading::ParallelFor(
+		r->getNumLocalPatches(),
+		[&](int i) {
+			for (int c = 0; c < r->getNumComponents(); c++) {
+				LocalData<D>       r_ld        = r->getLocalData(c, i);
+				const LocalData<D> inv_diag_ld = inv_diag->getLocalData(c, i);
+				cell_loop<D>(
+				r_ld.getStart(), r_ld.getEnd(),
+				[&](double &r_val, const double &inv_diag_val) { r_val *= inv_diag_val; }, r_ld,
+				inv_diag_ld);
+			}
+		},
+		r->isThreadSafe() && inv_diag->isThreadSafe());
+	}
+	/**
+	 * @brief Estimate the largest eigenvalue of D^-1 A with power iteration
+	 *
+	 * The magnitude is the growth of the last iteration, and the sign is the sign of the Rayleigh
+	 * quotient, so that a diagonal with the wrong sign is detected.
+	 *
+	 * @param num_iterations the number of power iterations
+	 * @return double the estimate
+	 */
+	double estimateMaxEigenvalue(int num_iterations) const
+	{
+		std::shared_ptr<Vector<D>> x = vg->getNewVector();
+		std::shared_ptr<Vector<D>> y = vg->getNewVector();
+
+		// a random starting vector has components along every eigenvector
+		int rank;
+		MPI_Comm_rank(x->getMPIComm(), &rank);
+		std::mt19937                           gen(rank);
+		std::uniform_real_distribution<double> dist(-1, 1);
+		for (int i = 0; i < x->getNumLocalPatches(); i++) {
+			for (int c = 0; c < x->getNumComponents(); c++) {
+				LocalData<D> ld = x->getLocalData(c, i);
+				nested_loop<D>(ld.getStart(), ld.getEnd(),
+				               [&](const std::array<int, D> &coord) { ld[coord] = dist(gen); });
+			}
+		}
+		x->scale(1 / x->twoNorm());
+
+		double eigenvalue = 0;
+		for (int i = 0; i < num_iterations; i++) {
+			op->apply(x, y);
+			applyInverseDiagonal(y);
+			eigenvalue = y->twoNorm();
+			if (eigenvalue == 0) {
+				break;
+			}
+			if (i == num_iterations - 1 && x->dot(y) < 0) {
+				eigenvalue = -eigenvalue;
+				break;
+			}
+			x->copy(y);
+			x->scale(1 / eigenvalue);
+		}
+		return eigenvalue;
+	}
+
+	public:
+	/**
+	 * @brief Construct a new ChebyshevSmoother object
+	 *
+	 * This estimates the largest eigenvalue of D^-1 A, which applies the operator
+	 * num_power_iterations times.
+	 *
+	 * @param op the operator
+	 * @param inv_diag the inverse of the diagonal of the operator, with the same layout as the
+	 * vectors that are smoothed (see Poisson::StarPatchOperator::getInverseDiagonal)
+	 * @param vg generates the work vectors
+	 * @param degree the number of steps in each call to smooth
+	 * @param num_power_iterations the number of power iterations used to estimate the largest
+	 * eigenvalue
+	 * @param lower_fraction the lower bound of the damped eigenvalues, as a fraction of the
+	 * estimate
+	 * @param upper_fraction the upper bound of the damped eigenvalues, as a fraction of the
+	 * estimate
+	 */
+	ChebyshevSmoother(std::shared_ptr<const Operator<D>>        op,
+	                  std::shared_ptr<const Vector<D>>          inv_diag,
+	                  std::shared_ptr<const VectorGenerator<D>> vg, int degree = 3,
+	                  int num_power_iterations = 10, double lower_fraction = 0.1,
+	                  double upper_fraction = 1.1)
+	: op(op), inv_diag(inv_diag), vg(vg), degree(degree)
+	{
+		if (degree < 1) {
+			throw RuntimeError("ChebyshevSmoother needs a degree of at least 1");
+		}
+		if (num_power_iterations < 1) {
+			throw RuntimeError("ChebyshevSmoother needs at least one power iteration");
+		}
+		if (lower_fraction <= 0 || lower_fraction >= upper_fraction) {
+			throw RuntimeError("ChebyshevSmoother needs 0 < lower_fraction < upper_fraction");
+		}
+		max_eigenvalue = estimateMaxEigenvalue(num_power_iterations);
+		if (!(max_eigenvalue > 0)) {
+			throw RuntimeError("ChebyshevSmoother estimated an eigenvalue that is not positive");
+		}
+		lower = lower_fraction * max_eigenvalue;
+		upper = upper_fraction * max_eigenvalue;
+	}
+	void smooth(std::shared_ptr<const Vector<D>> f, std::shared_ptr<Vector<D>> u) const override
+	{
+		double theta = (upper + lower) / 2;
+		double delta = (upper - lower) / 2;
+		double sigma = theta / delta;
+		double rho   = 1 / sigma;
+
+		std::shared_ptr<Vector<D>> r = vg->getNewVector();
+		std::shared_ptr<Vector<D>> d = vg->getNewVector();
+		op->residual(f, u, r);
+		applyInverseDiagonal(r);
+		d->copy(r);
+		d->scale(1 / theta);
+		for (int k = 1; k < degree; k++) {
+			u->add(d);
+			op->residual(f, u, r);
+			applyInverseDiagonal(r);
+			double rho_next = 1 / (2 * sigma - rho);
+			d->scaleThenAddScaled(rho_next * rho, 2 * rho_next / delta, r);
+			rho = rho_next;
+		}
+		u->add(d);
+	}
+	/**
+	 * @brief Get the estimate of the largest eigenvalue of D^-1 A
+	 */
+	double getMaxEigenvalueEstimate() const
+	{
+		return max_eigenvalue;
+	}
+	/**
+	 * @brief Get the lower bound of the eigenvalues that are damped
+	 */
+	double getLowerBound() const
+	{
+		return lower;
+	}
+	/**
+	 * @brief Get the upper bound of the eigenvalues that are damped
+	 */
+	double getUpperBound() const
+	{
+		return upper;
+	}
+	/**
+	 * @brief Get the number of steps in each call to smooth
+	 */
+	int getDegree() const
+	{
+		return degree;
+	}
+};
+extern template class ChebyshevSmoother<2>;
+extern template class ChebyshevSmoother<3>;
+} // namespace GMG
+} // namespace ThunderEgg
+#endif
@@ -55,8 +55,7 @@ template <int D> class Cycle : public Operator<D>
 	{
 		// calculate residual
 		std::shared_ptr<Vector<D>> r = level.getVectorGenerator()->getNewVector();
-		level.getOperator()->apply(u_vectors.front(), r);
-		r->scaleThenAdd(-1, f_vectors.front());
+		level.getOperator()->residual(f_vectors.front(), u_vectors.front(), r);
 		// create vectors for coarser levels
 		std::shared_ptr<Vector<D>> new_u = level.getCoarser()->getVectorGenerator()->getNewVector();
 		std::shared_ptr<Vector<D>> new_f = level.getCoarser()->getVectorGenerator()->getNewVector();
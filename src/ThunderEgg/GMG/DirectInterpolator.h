@@ -70,21 +70,32 @@ template <int D> class DirectInterpolator : public MPIInterpolator<D>
 				}
 
 				for (size_t c = 0; c < fine_datas.size(); c++) {
-					nested_loop<D>(fine_datas[c].getStart(), fine_datas[c].getEnd(),
-					               [&](const std::array<int, D> &coord) {
-						               std::array<int, D> coarse_coord;
-						               for (size_t x = 0; x < D; x++) {
-							               coarse_coord[x] = (coord[x] + starts[x]) / 2;
-						               }
-						               fine_datas[c][coord] += coarse_local_datas[c][coarse_coord];
-					               });
+					LocalData<D> &      fine          = fine_datas[c];
+					const LocalData<D> &coarse        = coarse_local_datas[c];
+					int                 n             = fine.getLengths()[0];
+					int                 fine_stride   = fine.getStrides()[0];
+					int                 coarse_stride = coarse.getStrides()[0];
+					row_loop<D>(fine.getStart(), fine.getEnd(),
+					            [&](const std::array<int, D> &coord) {
+						            std::array<int, D> coarse_coord;
+						            for (size_t x = 0; x < D; x++) {
+							            coarse_coord[x] = (coord[x] + starts[x]) / 2;
+						            }
+						            double *      fine_row   = fine.getPtr(coord);
+						            const double *coarse_row = coarse.getPtr(coarse_coord);
+						            for (int i = 0; i < n; i++) {
+							            int coarse_i = (i + starts[0]) / 2 - coarse_coord[0];
+							            fine_row[i * fine_stride]
+							            += coarse_row[coarse_i * coarse_stride];
+						            }
+					            });
 				}
 			} else {
 				for (size_t c = 0; c < fine_datas.size(); c++) {
-					nested_loop<D>(fine_datas[c].getStart(), fine_datas[c].getEnd(),
-					               [&](const std::array<int, D> &coord) {
-						               fine_datas[c][coord] += coarse_local_datas[c][coord];
-					               });
+					cell_loop<D>(
+					fine_datas[c].getStart(), fine_datas[c].getEnd(),
+					[&](double &fine, const double &coarse) { fine += coarse; }, fine_datas[c],
+					coarse_local_datas[c]);
 				}
 			}
 		}
@@ -23,6 +23,7 @@
 #define THUNDEREGG_GMG_INTERLEVELCOMM_H
 
 #include <ThunderEgg/Domain.h>
+#include <ThunderEgg/NeighborComm.h>
 #include <ThunderEgg/RuntimeError.h>
 #include <ThunderEgg/ValVector.h>
 
@@ -98,10 +99,229 @@ template <int D> class InterLevelComm
 	std::shared_ptr<const Vector<D>> current_vector;
 	std::shared_ptr<const Vector<D>> current_ghost_vector;
 
-	std::vector<std::vector<double>> recv_buffers;
-	std::vector<MPI_Request>         recv_requests;
-	std::vector<std::vector<double>> send_buffers;
-	std::vector<MPI_Request>         send_requests;
+	std::vector<double>      recv_buffer;
+	std::vector<int>         recv_counts;
+	std::vector<int>         recv_displs;
+	std::vector<MPI_Request> recv_requests;
+	std::vector<double>      send_buffer;
+	std::vector<int>         send_counts;
+	std::vector<int>         send_displs;
+	std::vector<MPI_Request> send_requests;
+
+	/**
+	 * @brief recv buffer for float messages
+	 */
+	std::vector<float> recv_float_buffer;
+	/**
+	 * @brief send buffer for float messages
+	 */
+	std::vector<float> send_float_buffer;
+	/**
+	 * @brief true if the patches are sent as floats
+	 */
+	bool use_float_messages = false;
+
+	/**
+	 * @brief The graph communicator for getGhostPatches, null if point-to-point messages are used
+	 */
+	std::shared_ptr<const NeighborComm> get_comm;
+	/**
+	 * @brief The graph communicator for sendGhostPatches, null if point-to-point messages are used
+	 */
+	std::shared_ptr<const NeighborComm> send_comm;
+	/**
+	 * @brief The graph communicator of the communication in progress, null if point-to-point
+	 * messages are used
+	 */
+	const NeighborComm *current_comm = nullptr;
+	/**
+	 * @brief The request of the neighbor collective in progress
+	 */
+	MPI_Request neighbor_request = MPI_REQUEST_NULL;
+
+	/**
+	 * @brief Get the ranks from a vector of rank and local index pairs
+	 */
+	static std::vector<int> GetRanks(const std::vector<std::pair<int, std::vector<int>>> &pairs)
+	{
+		std::vector<int> ranks;
+		ranks.reserve(pairs.size());
+		for (const auto &pair : pairs) {
+			ranks.push_back(pair.first);
+		}
+		return ranks;
+	}
+	/**
+	 * @brief Allocate a buffer for the patches to or from each rank, one after another
+	 *
+	 * @tparam T the type of the values in the messages
+	 * @param pairs the ranks and the local indexes of the patches for each rank
+	 * @param buffer the buffer
+	 * @param counts the number of values for each rank
+	 * @param displs the offset in the buffer for each rank
+	 */
+	template <typename T>
+	void setUpBuffer(const std::vector<std::pair<int, std::vector<int>>> &pairs,
+	                 std::vector<T> &buffer, std::vector<int> &counts,
+	                 std::vector<int> &displs) const
+	{
+		counts.resize(pairs.size());
+		displs.resize(pairs.size());
+		int size = 0;
+		for (size_t i = 0; i < pairs.size(); i++) {
+			counts[i] = patch_size * pairs[i].second.size();
+			displs[i] = size;
+			size += counts[i];
+		}
+		buffer.resize(size);
+	}
+	/**
+	 * @brief Post the recvs, and fill the buffers and post the sends
+	 *
+	 * @param recv_pairs the ranks and the local indexes of the patches to recieve
+	 * @param send_pairs the ranks and the local indexes of the patches to send
+	 * @param send_vector the vector to send the patches of
+	 * @param comm the graph communicator, null to use point-to-point messages
+	 */
+	void startExchange(const std::vector<std::pair<int, std::vector<int>>> &recv_pairs,
+	                   const std::vector<std::pair<int, std::vector<int>>> &send_pairs,
+	                   const Vector<D> &send_vector, const NeighborComm *comm)
+	{
+		if (use_float_messages) {
+			startExchange(recv_pairs, send_pairs, send_vector, comm, recv_float_buffer,
+			              send_float_buffer, MPI_FLOAT);
+		} else {
+			startExchange(recv_pairs, send_pairs, send_vector, comm, recv_buffer, send_buffer,
+			              MPI_DOUBLE);
+		}
+	}
+	/**
+	 * @brief Post the recvs, and fill the buffers and post the sends
+	 *
+	 * @tparam T the type of the values in the messages
+	 * @param recv_pairs the ranks and the local indexes of the patches to recieve
+	 * @param send_pairs the ranks and the local indexes of the patches to send
+	 * @param send_vector the vector to send the patches of
+	 * @param comm the graph communicator, null to use point-to-point messages
+	 * @param recv_values the buffer to recieve into
+	 * @param send_values the buffer to send from
+	 * @param type the MPI type of T
+	 */
+	template <typename T>
+	void startExchange(const std::vector<std::pair<int, std::vector<int>>> &recv_pairs,
+	                   const std::vector<std::pair<int, std::vector<int>>> &send_pairs,
+	                   const Vector<D> &send_vector, const NeighborComm *comm,
+	                   std::vector<T> &recv_values, std::vector<T> &send_values,
+	                   MPI_Datatype type)
+	{
+		current_comm = comm;
+
+		// post receives
+		setUpBuffer(recv_pairs, recv_values, recv_counts, recv_displs);
+		if (comm == nullptr) {
+			recv_requests.resize(recv_pairs.size());
+			for (size_t i = 0; i < recv_pairs.size(); i++) {
+				MPI_Irecv(recv_values.data() + recv_displs[i], recv_counts[i], type,
+				          recv_pairs[i].first, 0, MPI_COMM_WORLD, &recv_requests[i]);
+			}
+		}
+
+		// post sends
+		setUpBuffer(send_pairs, send_values, send_counts, send_displs);
+		if (comm == nullptr) {
+			send_requests.resize(send_pairs.size());
+		}
+		for (size_t i = 0; i < send_pairs.size(); i++) {
+			// fill buffer with values
+			T * buffer     = send_values.data() + send_displs[i];
+			int buffer_idx = 0;
+			for (int local_index : send_pairs[i].second) {
+				auto local_datas = send_vector.getLocalDatas(local_index);
+				for (const auto &local_data : local_datas) {
+					nested_loop<D>(local_data.getGhostStart(), local_data.getGhostEnd(),
+					               [&](const std::array<int, D> &coord) {
+						               buffer[buffer_idx] = local_data[coord];
+						               buffer_idx++;
+					               });
+				}
+			}
+
+			// post the send
+			if (comm == nullptr) {
+				MPI_Isend(buffer, send_counts[i], type, send_pairs[i].first, 0, MPI_COMM_WORLD,
+				          &send_requests[i]);
+			}
+		}
+		if (comm != nullptr) {
+			comm->alltoallvStart(send_values.data(), send_counts, send_displs, recv_values.data(),
+			                     recv_counts, recv_displs, type, &neighbor_request);
+		}
+	}
+	/**
+	 * @brief Process the recieved buffers as they arrive, and wait for the sends
+	 *
+	 * @param recv_pairs the ranks and the local indexes of the patches that are recieved
+	 * @param recv_vector the vector to put the patches in
+	 * @param op called with a value in recv_vector and the recieved value
+	 */
+	template <typename Op>
+	void finishExchange(const std::vector<std::pair<int, std::vector<int>>> &recv_pairs,
+	                    Vector<D> &recv_vector, Op op)
+	{
+		if (use_float_messages) {
+			finishExchange(recv_pairs, recv_vector, op, recv_float_buffer);
+		} else {
+			finishExchange(recv_pairs, recv_vector, op, recv_buffer);
+		}
+	}
+	/**
+	 * @brief Process the recieved buffers as they arrive, and wait for the sends
+	 *
+	 * @tparam T the type of the values in the messages
+	 * @param recv_pairs the ranks and the local indexes of the patches that are recieved
+	 * @param recv_vector the vector to put the patches in
+	 * @param op called with a value in recv_vector and the recieved value
+	 * @param recv_values the buffer that was recieved into
+	 */
+	template <typename Op, typename T>
+	void finishExchange(const std::vector<std::pair<int, std::vector<int>>> &recv_pairs,
+	                    Vector<D> &recv_vector, Op op, const std::vector<T> &recv_values)
+	{
+		if (current_comm != nullptr) {
+			MPI_Wait(&neighbor_request, MPI_STATUS_IGNORE);
+		}
+		for (size_t i = 0; i < recv_pairs.size(); i++) {
+			int finished_idx = i;
+			if (current_comm == nullptr) {
+				MPI_Waitany(recv_requests.size(), recv_requests.data(), &finished_idx,
+				            MPI_STATUS_IGNORE);
+			}
+
+			// get local indexes for the buffer that was recieved
+			const std::vector<int> &local_indexes = recv_pairs.at(finished_idx).second;
+
+			// add the values in the buffer to the vector
+			const T *buffer     = recv_values.data() + recv_displs[finished_idx];
+			int      buffer_idx = 0;
+			for (int local_index : local_indexes) {
+				auto local_datas = recv_vector.getLocalDatas(local_index);
+				for (auto &local_data : local_datas) {
+					nested_loop<D>(local_data.getGhostStart(), local_data.getGhostEnd(),
+					               [&](const std::array<int, D> &coord) {
+						               op(local_data[coord], buffer[buffer_idx]);
+						               buffer_idx++;
+					               });
+				}
+			}
+		}
+
+		// wait for sends for finish
+		MPI_Waitall(send_requests.size(), send_requests.data(), MPI_STATUS_IGNORE);
+
+		recv_requests.clear();
+		send_requests.clear();
+		current_comm = nullptr;
+	}
 
 	public:
 	/**
@@ -216,6 +436,9 @@ template <int D> class InterLevelComm
 			MPI_Waitall(send_requests.size(), send_requests.data(), MPI_STATUS_IGNORE);
 			MPI_Waitall(recv_requests.size(), recv_requests.data(), MPI_STATUS_IGNORE);
 		}
+		if (neighbor_request != MPI_REQUEST_NULL) {
+			MPI_Wait(&neighbor_request, MPI_STATUS_IGNORE);
+		}
 	}
 
 	/**
@@ -259,6 +482,67 @@ template <int D> class InterLevelComm
 		return patches_with_ghost_parent;
 	}
 
+	/**
+	 * @brief Do the communication with neighbor collectives instead of point-to-point messages
+	 *
+	 * A graph communicator is created for each direction of the communication, and each exchange
+	 * is a single MPI_Ineighbor_alltoallv. The recieved values are put in the vector once every
+	 * message has arrived, instead of as each message arrives.
+	 *
+	 * This is a collective call over MPI_COMM_WORLD.
+	 *
+	 * @param use_neighbor_collectives true to use neighbor collectives
+	 */
+	void setUseNeighborCollectives(bool use_neighbor_collectives)
+	{
+		if (communicating) {
+			throw RuntimeError(
+			"InterLevelComm can not change modes while communication is in progress");
+		}
+		get_comm  = nullptr;
+		send_comm = nullptr;
+		if (use_neighbor_collectives) {
+			std::vector<int> vector_ranks       = GetRanks(rank_and_local_indexes_for_vector);
+			std::vector<int> ghost_vector_ranks = GetRanks(rank_and_local_indexes_for_ghost_vector);
+			get_comm
+			= std::make_shared<NeighborComm>(MPI_COMM_WORLD, ghost_vector_ranks, vector_ranks);
+			send_comm
+			= std::make_shared<NeighborComm>(MPI_COMM_WORLD, vector_ranks, ghost_vector_ranks);
+		}
+	}
+	/**
+	 * @brief Check if the communication is done with neighbor collectives
+	 */
+	bool getUseNeighborCollectives() const
+	{
+		return get_comm != nullptr;
+	}
+	/**
+	 * @brief Send the patches to other ranks as floats instead of doubles
+	 *
+	 * This halves the size of the messages. The values of patches from other ranks are rounded to
+	 * single precision, which is enough when the levels are used in a preconditioner. The patches
+	 * with a local parent are not rounded.
+	 *
+	 * This has to be set to the same value on every rank.
+	 *
+	 * @param use_float_messages true to send floats
+	 */
+	void setUseFloatMessages(bool use_float_messages)
+	{
+		if (communicating) {
+			throw RuntimeError(
+			"InterLevelComm can not change modes while communication is in progress");
+		}
+		this->use_float_messages = use_float_messages;
+	}
+	/**
+	 * @brief Check if the patches are sent to other ranks as floats
+	 */
+	bool getUseFloatMessages() const
+	{
+		return use_float_messages;
+	}
 	/**
 	 * @brief Start the communication for sending ghost values.
 	 *
@@ -288,45 +572,8 @@ template <int D> class InterLevelComm
 		current_ghost_vector = ghost_vector;
 		current_vector       = vector;
 
-		// post receives
-		recv_buffers.reserve(rank_and_local_indexes_for_vector.size());
-		recv_requests.reserve(rank_and_local_indexes_for_vector.size());
-		for (auto rank_indexes_pair : rank_and_local_indexes_for_vector) {
-			// allocate buffer
-			recv_buffers.emplace_back(patch_size * rank_indexes_pair.second.size());
-
-			// post the receive
-			int rank = rank_indexes_pair.first;
-			recv_requests.emplace_back();
-			MPI_Irecv(recv_buffers.back().data(), recv_buffers.back().size(), MPI_DOUBLE, rank, 0,
-			          MPI_COMM_WORLD, &recv_requests.back());
-		}
-		send_buffers.reserve(rank_and_local_indexes_for_ghost_vector.size());
-		send_requests.reserve(rank_and_local_indexes_for_ghost_vector.size());
-		// post sends
-		for (auto rank_indexes_pair : rank_and_local_indexes_for_ghost_vector) {
-			// allocate buffer
-			send_buffers.emplace_back(patch_size * rank_indexes_pair.second.size());
-
-			// fill buffer with values
-			int buffer_idx = 0;
-			for (int local_index : rank_indexes_pair.second) {
-				auto local_datas = ghost_vector->getLocalDatas(local_index);
-				for (const auto &local_data : local_datas) {
-					nested_loop<D>(local_data.getGhostStart(), local_data.getGhostEnd(),
-					               [&](const std::array<int, D> &coord) {
-						               send_buffers.back()[buffer_idx] = local_data[coord];
-						               buffer_idx++;
-					               });
-				}
-			}
-
-			// post the send
-			int rank = rank_indexes_pair.first;
-			send_requests.emplace_back();
-			MPI_Isend(send_buffers.back().data(), send_buffers.back().size(), MPI_DOUBLE, rank, 0,
-			          MPI_COMM_WORLD, &send_requests.back());
-		}
+		startExchange(rank_and_local_indexes_for_vector, rank_and_local_indexes_for_ghost_vector,
+		              *ghost_vector, send_comm.get());
 
 		// set state
 		communicating = true;
@@ -363,39 +610,8 @@ template <int D> class InterLevelComm
 			"InterLevelComm senGhostPatchesFinish is being called with a different ghost vector than when sendGhostPatchesStart was called");
 		}
 
-		// finish recvs
-		for (size_t i = 0; i < rank_and_local_indexes_for_vector.size(); i++) {
-			int finished_idx;
-			MPI_Waitany(recv_requests.size(), recv_requests.data(), &finished_idx,
-			            MPI_STATUS_IGNORE);
-
-			// get local indexes for the buffer that was received
-			std::vector<int> &local_indexes
-			= rank_and_local_indexes_for_vector.at(finished_idx).second;
-
-			// add the values in the buffer to the vector
-			std::vector<double> &buffer     = recv_buffers.at(finished_idx);
-			int                  buffer_idx = 0;
-			for (int local_index : local_indexes) {
-				auto local_datas = vector->getLocalDatas(local_index);
-				for (auto &local_data : local_datas) {
-					nested_loop<D>(local_data.getGhostStart(), local_data.getGhostEnd(),
-					               [&](const std::array<int, D> &coord) {
-						               local_data[coord] += buffer[buffer_idx];
-						               buffer_idx++;
-					               });
-				}
-			}
-		}
-
-		// wait for sends for finish
-		MPI_Waitall(send_requests.size(), send_requests.data(), MPI_STATUS_IGNORE);
-
-		// clear buffers
-		recv_requests.clear();
-		recv_buffers.clear();
-		send_requests.clear();
-		send_buffers.clear();
+		finishExchange(rank_and_local_indexes_for_vector, *vector,
+		               [](double &value, double recv_value) { value += recv_value; });
 
 		// set state
 		communicating        = false;
@@ -431,45 +647,8 @@ template <int D> class InterLevelComm
 		current_ghost_vector = ghost_vector;
 		current_vector       = vector;
 
-		// post receives
-		recv_buffers.reserve(rank_and_local_indexes_for_ghost_vector.size());
-		recv_requests.reserve(rank_and_local_indexes_for_ghost_vector.size());
-		for (auto rank_indexes_pair : rank_and_local_indexes_for_ghost_vector) {
-			// allocate buffer
-			recv_buffers.emplace_back(patch_size * rank_indexes_pair.second.size());
-
-			// post the recieve
-			int rank = rank_indexes_pair.first;
-			recv_requests.emplace_back();
-			MPI_Irecv(recv_buffers.back().data(), recv_buffers.back().size(), MPI_DOUBLE, rank, 0,
-			          MPI_COMM_WORLD, &recv_requests.back());
-		}
-		send_buffers.reserve(rank_and_local_indexes_for_vector.size());
-		send_requests.reserve(rank_and_local_indexes_for_vector.size());
-		// post sends
-		for (auto rank_indexes_pair : rank_and_local_indexes_for_vector) {
-			// allocate buffer
-			send_buffers.emplace_back(patch_size * rank_indexes_pair.second.size());
-
-			// fill buffer with values
-			int buffer_idx = 0;
-			for (int local_index : rank_indexes_pair.second) {
-				auto local_datas = vector->getLocalDatas(local_index);
-				for (const auto &local_data : local_datas) {
-					nested_loop<D>(local_data.getGhostStart(), local_data.getGhostEnd(),
-					               [&](const std::array<int, D> &coord) {
-						               send_buffers.back()[buffer_idx] = local_data[coord];
-						               buffer_idx++;
-					               });
-				}
-			}
-
-			// post the send
-			int rank = rank_indexes_pair.first;
-			send_requests.emplace_back();
-			MPI_Isend(send_buffers.back().data(), send_buffers.back().size(), MPI_DOUBLE, rank, 0,
-			          MPI_COMM_WORLD, &send_requests.back());
-		}
+		startExchange(rank_and_local_indexes_for_ghost_vector, rank_and_local_indexes_for_vector,
+		              *vector, get_comm.get());
 
 		// set state
 		communicating = true;
@@ -506,39 +685,8 @@ template <int D> class InterLevelComm
 			"InterLevelComm getGhostPatchesFinish is being called with a different ghost vector than when getGhostPatchesStart was called");
 		}
 
-		// finish recvs
-		for (size_t i = 0; i < rank_and_local_indexes_for_ghost_vector.size(); i++) {
-			int finished_idx;
-			MPI_Waitany(recv_requests.size(), recv_requests.data(), &finished_idx,
-			            MPI_STATUS_IGNORE);
-
-			// get local indexes for the buffer that was recieved
-			std::vector<int> &local_indexes
-			= rank_and_local_indexes_for_ghost_vector.at(finished_idx).second;
-
-			// add the values in the buffer to the vector
-			std::vector<double> &buffer     = recv_buffers.at(finished_idx);
-			int                  buffer_idx = 0;
-			for (int local_index : local_indexes) {
-				auto local_datas = ghost_vector->getLocalDatas(local_index);
-				for (auto &local_data : local_datas) {
-					nested_loop<D>(local_data.getGhostStart(), local_data.getGhostEnd(),
-					               [&](const std::array<int, D> &coord) {
-						               local_data[coord] = buffer[buffer_idx];
-						               buffer_idx++;
-					               });
-				}
-			}
-		}
-
-		// wait for sends for finish
-		MPI_Waitall(send_requests.size(), send_requests.data(), MPI_STATUS_IGNORE);
-
-		// clear buffers
-		recv_requests.clear();
-		recv_buffers.clear();
-		send_requests.clear();
-		send_buffers.clear();
+		finishExchange(rank_and_local_indexes_for_ghost_vector, *ghost_vector,
+		               [](double &value, double recv_value) { value = recv_value; });
 
 		// set state
 		communicating        = false;
@@ -22,11 +22,72 @@
 #ifndef THUNDEREGG_GMG_LINEARRESTRICTOR_H
 #define THUNDEREGG_GMG_LINEARRESTRICTOR_H
 #include <ThunderEgg/GMG/MPIRestrictor.h>
+#include <ThunderEgg/PatchSizeDispatch.h>
 #include <memory>
 namespace ThunderEgg
 {
 namespace GMG
 {
+/**
+ * @brief Kernel for restricting the interior cells of a patch to its coarser parent
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @tparam N the number of cells in each direction of the patch
+ */
+template <int D, int N> struct LinearRestrictorKernel {
+	/**
+	 * @brief Add the average of the fine cells to the corresponding coarse cell
+	 *
+	 * The rows of fine and coarse have to be contiguous.
+	 *
+	 * @param fine the finer patch
+	 * @param coarse the coarser patch
+	 * @param starts the starting index of the finer patch in the coarser patch, before dividing by
+	 * 2
+	 */
+	static void run(const LocalData<D> &fine, LocalData<D> &coarse,
+	                const std::array<int, D> &starts)
+	{
+		PatchSizeDispatch::ForEachRow<D, N>([&](const std::array<int, D> &coord) {
+			std::array<int, D> coarse_coord;
+			for (size_t x = 0; x < D; x++) {
+				coarse_coord[x] = (coord[x] + starts[x]) / 2;
+			}
+			const double *fine_row   = fine.getPtr(coord);
+			double *      coarse_row = coarse.getPtr(coarse_coord);
+			for (int i = 0; i < N / 2; i++) {
+				coarse_row[i] += fine_row[2 * i] / (1 << D);
+				coarse_row[i] += fine_row[2 * i + 1] / (1 << D);
+			}
+		});
+	}
+};
+/**
+ * @brief Kernel for copying the interior cells of a patch to a parent of the same size
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @tparam N the number of cells in each direction of the patch
+ */
+template <int D, int N> struct LinearRestrictorCopyKernel {
+	/**
+	 * @brief Add the fine cells to the coarse cells
+	 *
+	 * The rows of fine and coarse have to be contiguous.
+	 *
+	 * @param fine the finer patch
+	 * @param coarse the coarser patch
+	 */
+	static void run(const LocalData<D> &fine, LocalData<D> &coarse)
+	{
+		PatchSizeDispatch::ForEachRow<D, N>([&](const std::array<int, D> &coord) {
+			const double *fine_row   = fine.getPtr(coord);
+			double *      coarse_row = coarse.getPtr(coord);
+			for (int i = 0; i < N; i++) {
+				coarse_row[i] += fine_row[i];
+			}
+		});
+	}
+};
 /**
  * @brief Restrictor that averages the corresponding fine cells into each coarse cell.
  */
@@ -100,14 +161,21 @@ template <int D> class LinearRestrictor : public MPIRestrictor<D>
 
 		for (size_t c = 0; c < fine_datas.size(); c++) {
 			// interpolate interior values
-			nested_loop<D>(
-			fine_datas[c].getStart(), fine_datas[c].getEnd(), [&](const std::array<int, D> &coord) {
-				std::array<int, D> coarse_coord;
-				for (size_t x = 0; x < D; x++) {
-					coarse_coord[x] = (coord[x] + starts[x]) / 2;
-				}
-				coarse_local_datas[c][coarse_coord] += fine_datas[c][coord] / (1 << D);
-			});
+			bool contiguous = fine_datas[c].getStrides()[0] == 1
+			                  && coarse_local_datas[c].getStrides()[0] == 1;
+			if (!contiguous
+			    || !PatchSizeDispatch::Dispatch<LinearRestrictorKernel, D>(
+			       pinfo->ns, fine_datas[c], coarse_local_datas[c], starts)) {
+				nested_loop<D>(fine_datas[c].getStart(), fine_datas[c].getEnd(),
+				               [&](const std::array<int, D> &coord) {
+					               std::array<int, D> coarse_coord;
+					               for (size_t x = 0; x < D; x++) {
+						               coarse_coord[x] = (coord[x] + starts[x]) / 2;
+					               }
+					               coarse_local_datas[c][coarse_coord]
+					               += fine_datas[c][coord] / (1 << D);
+				               });
+			}
 
 			if (extrapolate_boundary_ghosts) {
 				extrapolateBoundaries(pinfo, fine_datas[c], coarse_local_datas[c]);
@@ -132,10 +200,16 @@ template <int D> class LinearRestrictor : public MPIRestrictor<D>
 		auto fine_datas         = finer_vector->getLocalDatas(pinfo->local_index);
 		for (size_t c = 0; c < fine_datas.size(); c++) {
 			// just copy the values
-			nested_loop<D>(fine_datas[c].getStart(), fine_datas[c].getEnd(),
-			               [&](const std::array<int, D> &coord) {
-				               coarse_local_datas[c][coord] += fine_datas[c][coord];
-			               });
+			bool contiguous = fine_datas[c].getStrides()[0] == 1
+			                  && coarse_local_datas[c].getStrides()[0] == 1;
+			if (!contiguous
+			    || !PatchSizeDispatch::Dispatch<LinearRestrictorCopyKernel, D>(
+			       pinfo->ns, fine_datas[c], coarse_local_datas[c])) {
+				nested_loop<D>(fine_datas[c].getStart(), fine_datas[c].getEnd(),
+				               [&](const std::array<int, D> &coord) {
+					               coarse_local_datas[c][coord] += fine_datas[c][coord];
+				               });
+			}
 			if (extrapolate_boundary_ghosts) {
 				// copy boundary ghost values
 				for (Side<D> s : Side<D>::getValues()) {
@@ -49,6 +49,13 @@ template <int D> class MPIInterpolator : public Interpolator<D>
 	 * @param ilc the communcation package for the two levels.
 	 */
 	explicit MPIInterpolator(std::shared_ptr<InterLevelComm<D>> ilc) : ilc(ilc) {}
+	/**
+	 * @brief Get the communication package for the two levels
+	 */
+	std::shared_ptr<InterLevelComm<D>> getInterLevelComm() const
+	{
+		return ilc;
+	}
 	/**
 	 * @brief Interpolate values from coarse vector to the finer vector
 	 *
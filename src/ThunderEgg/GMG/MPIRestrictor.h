@@ -52,6 +52,13 @@ template <int D> class MPIRestrictor : public Restrictor<D>
 	{
 		this->ilc = ilc_in;
 	}
+	/**
+	 * @brief Get the communication package for the two levels
+	 */
+	std::shared_ptr<InterLevelComm<D>> getInterLevelComm() const
+	{
+		return ilc;
+	}
 	/**
 	 * @brief restriction function
 	 *
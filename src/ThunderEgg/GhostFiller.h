@@ -22,6 +22,7 @@
 #ifndef THUNDEREGG_GHOSTEFILLER_H
 #define THUNDEREGG_GHOSTEFILLER_H
 #include <ThunderEgg/Vector.h>
+#include <vector>
 namespace ThunderEgg
 {
 /**
@@ -40,6 +41,55 @@ template <int D> class GhostFiller
 	 * @param u  the vector
 	 */
 	virtual void fillGhost(std::shared_ptr<const Vector<D>> u) const = 0;
+	/**
+	 * @brief Fill ghost cells on several vectors
+	 *
+	 * Ghost fillers that communicate should override this so that the vectors share messages.
+	 * The default implementation fills the vectors one at a time.
+	 *
+	 * @param us  the vectors
+	 */
+	virtual void fillGhost(const std::vector<std::shared_ptr<const Vector<D>>> &us) const
+	{
+		for (const auto &u : us) {
+			fillGhost(u);
+		}
+	}
+	/**
+	 * @brief Start filling ghost cells on a vector
+	 *
+	 * When this returns, the ghost cells of the patches where needsFillGhostFinish() is false are
+	 * filled. The rest of the ghost cells are filled by fillGhostFinish(), which has to be called
+	 * with the same vector before another fill is started. The interior values of u can be
+	 * modified in between, the values that are sent to other patches have already been read.
+	 *
+	 * The default implementation fills all of the ghost cells.
+	 *
+	 * @param u  the vector
+	 */
+	virtual void fillGhostStart(std::shared_ptr<const Vector<D>> u) const
+	{
+		fillGhost(u);
+	}
+	/**
+	 * @brief Finish filling ghost cells on a vector
+	 *
+	 * @param u  the vector that was passed to fillGhostStart()
+	 */
+	virtual void fillGhostFinish(std::shared_ptr<const Vector<D>> u) const {}
+	/**
+	 * @brief Check if the ghost cells of a patch are only filled after fillGhostFinish() is
+	 * called
+	 *
+	 * The default implementation returns false for every patch.
+	 *
+	 * @param patch_local_index the local index of the patch
+	 * @return true if the patch has to wait for fillGhostFinish()
+	 */
+	virtual bool needsFillGhostFinish(int patch_local_index) const
+	{
+		return false;
+	}
 };
 } // namespace ThunderEgg
 #endif
@@ -25,7 +25,9 @@
 #include <ThunderEgg/DivergenceError.h>
 #include <ThunderEgg/Iterative/Solver.h>
 #include <ThunderEgg/Operator.h>
+#include <ThunderEgg/ReductionBatch.h>
 #include <ThunderEgg/Timer.h>
+#include <ThunderEgg/VectorExpression.h>
 #include <ThunderEgg/VectorGenerator.h>
 
 namespace ThunderEgg
@@ -142,29 +144,34 @@ template <int D> class BiCGStab : public Solver<D>
 	{
 		std::shared_ptr<Vector<D>> resid = vg->getNewVector();
 
-		A->apply(x, resid);
-		resid->scaleThenAdd(-1, b);
+		A->residual(b, x, resid);
 
 		std::shared_ptr<Vector<D>> initial_guess = vg->getNewVector();
 		initial_guess->copy(x);
 		x->set(0);
 
-		double                     r0_norm = b->twoNorm();
-		std::shared_ptr<Vector<D>> rhat    = vg->getNewVector();
+		std::shared_ptr<Vector<D>> rhat = vg->getNewVector();
 		rhat->copy(resid);
 		std::shared_ptr<Vector<D>> p = vg->getNewVector();
 		p->copy(resid);
 		std::shared_ptr<Vector<D>> ap = vg->getNewVector();
 		std::shared_ptr<Vector<D>> as = vg->getNewVector();
 
-		std::shared_ptr<Vector<D>> s   = vg->getNewVector();
-		double                     rho = rhat->dot(resid);
+		std::shared_ptr<Vector<D>> s = vg->getNewVector();
+
+		ReductionBatch<D> initial_reductions;
+		int               b_norm_index     = initial_reductions.addTwoNorm(b);
+		int               rho_index        = initial_reductions.addDot(rhat, resid);
+		int               resid_norm_index = initial_reductions.addTwoNorm(resid);
+		initial_reductions.evaluate();
+		double r0_norm = initial_reductions.getResult(b_norm_index);
+		double rho     = initial_reductions.getResult(rho_index);
 
 		int num_its = 0;
 		if (r0_norm == 0) {
 			return num_its;
 		}
-		double residual = resid->twoNorm() / r0_norm;
+		double residual = initial_reductions.getResult(resid_norm_index) / r0_norm;
 		if (output) {
 			char buf[100];
 			sprintf(buf, "%5d %16.8e\n", num_its, residual);
@@ -182,29 +189,44 @@ template <int D> class BiCGStab : public Solver<D>
 
 			applyWithPreconditioner(vg, nullptr, A, Mr, p, ap);
 			double alpha = rho / rhat->dot(ap);
-			s->copy(resid);
-			s->addScaled(-alpha, ap);
-			if (s->twoNorm() / r0_norm <= tolerance) {
-				x->addScaled(alpha, p);
+
+			// the norm of s is reduced while as is computed, as is not needed if s has converged,
+			// but that only happens on the last iteration
+			ReductionBatch<D> s_reductions;
+			int               s_norm_index = s_reductions.addTwoNorm(s);
+			assignStart(s, resid - alpha * ap, s_reductions);
+			applyWithPreconditioner(vg, nullptr, A, Mr, s, as);
+			s_reductions.evaluateFinish();
+			if (s_reductions.getResult(s_norm_index) / r0_norm <= tolerance) {
+				assign(x, x + alpha * p);
 				if (timer) {
 					timer->stop("Iteration");
 				}
 				break;
 			}
-			applyWithPreconditioner(vg, nullptr, A, Mr, s, as);
-			double omega = as->dot(s) / as->dot(as);
-			x->addScaled(alpha, p, omega, s);
-			resid->addScaled(-alpha, ap);
-			resid->addScaled(-omega, as);
 
-			double rho_new = resid->dot(rhat);
+			ReductionBatch<D> omega_reductions;
+			int               as_dot_s_index  = omega_reductions.addDot(as, s);
+			int               as_dot_as_index = omega_reductions.addDot(as, as);
+			omega_reductions.evaluate();
+			double omega = omega_reductions.getResult(as_dot_s_index)
+			               / omega_reductions.getResult(as_dot_as_index);
+
+			// s is resid - alpha * ap, so the new residual is s - omega * as, the update of x does
+			// not depend on the reductions, so it is done while they are in progress
+			ReductionBatch<D> resid_reductions;
+			int               rho_new_index        = resid_reductions.addDot(resid, rhat);
+			int               new_resid_norm_index = resid_reductions.addTwoNorm(resid);
+			assignStart(resid, s - omega * as, resid_reductions);
+			assign(x, x + alpha * p + omega * s);
+			resid_reductions.evaluateFinish();
+			double rho_new = resid_reductions.getResult(rho_new_index);
 			double beta    = rho_new * alpha / (rho * omega);
-			p->addScaled(-omega, ap);
-			p->scaleThenAdd(beta, resid);
+			assign(p, resid + beta * (p - omega * ap));
 
 			num_its++;
 			rho      = rho_new;
-			residual = resid->twoNorm() / r0_norm;
+			residual = resid_reductions.getResult(new_resid_norm_index) / r0_norm;
 
 			if (residual > 1e6) {
 				throw DivergenceError("BiCGStab reached divergence criteria on iteration "
@@ -25,7 +25,9 @@
 #include <ThunderEgg/DivergenceError.h>
 #include <ThunderEgg/Iterative/Solver.h>
 #include <ThunderEgg/Operator.h>
+#include <ThunderEgg/ReductionBatch.h>
 #include <ThunderEgg/Timer.h>
+#include <ThunderEgg/VectorExpression.h>
 #include <ThunderEgg/VectorGenerator.h>
 
 namespace ThunderEgg
@@ -142,25 +144,29 @@ template <int D> class CG : public Solver<D>
 	{
 		std::shared_ptr<Vector<D>> resid = vg->getNewVector();
 
-		A->apply(x, resid);
-		resid->scaleThenAdd(-1, b);
+		A->residual(b, x, resid);
 
 		std::shared_ptr<Vector<D>> initial_guess = vg->getNewVector();
 		initial_guess->copy(x);
 		x->set(0);
 
-		double                     r0_norm = b->twoNorm();
-		std::shared_ptr<Vector<D>> p       = vg->getNewVector();
+		std::shared_ptr<Vector<D>> p = vg->getNewVector();
 		p->copy(resid);
 		std::shared_ptr<Vector<D>> ap = vg->getNewVector();
 
-		double rho = resid->dot(resid);
+		ReductionBatch<D> initial_reductions;
+		int               b_norm_index    = initial_reductions.addTwoNorm(b);
+		int               resid_dot_index = initial_reductions.addDot(resid, resid);
+		initial_reductions.evaluate();
+		double r0_norm = initial_reductions.getResult(b_norm_index);
+		double rho     = initial_reductions.getResult(resid_dot_index);
 
 		int num_its = 0;
 		if (r0_norm == 0) {
 			return num_its;
 		}
-		double residual = resid->twoNorm() / r0_norm;
+		// rho is the dot product of the residual with itself
+		double residual = sqrt(rho) / r0_norm;
 		if (output) {
 			char buf[100];
 			sprintf(buf, "%5d %16.8e\n", num_its, residual);
@@ -178,16 +184,21 @@ template <int D> class CG : public Solver<D>
 
 			applyWithPreconditioner(vg, nullptr, A, Mr, p, ap);
 			double alpha = rho / p->dot(ap);
-			x->addScaled(alpha, p);
-			resid->addScaled(-alpha, ap);
 
-			double rho_new = resid->dot(resid);
+			// the update of x does not depend on rho_new, so it is done while the reduction is in
+			// progress
+			ReductionBatch<D> resid_reductions;
+			int               rho_new_index = resid_reductions.addDot(resid, resid);
+			assignStart(resid, resid - alpha * ap, resid_reductions);
+			assign(x, x + alpha * p);
+			resid_reductions.evaluateFinish();
+			double rho_new = resid_reductions.getResult(rho_new_index);
 			double beta    = rho_new / rho;
-			p->scaleThenAdd(beta, resid);
+			assign(p, resid + beta * p);
 
 			num_its++;
 			rho      = rho_new;
-			residual = resid->twoNorm() / r0_norm;
+			residual = sqrt(rho) / r0_norm;
 
 			if (output) {
 				char buf[100];
@@ -28,6 +28,7 @@
 #include <ThunderEgg/Iterative/Solver.h>
 #include <ThunderEgg/PatchOperator.h>
 #include <ThunderEgg/PatchSolver.h>
+#include <ThunderEgg/PooledVectorGenerator.h>
 #include <ThunderEgg/ValVector.h>
 #include <bitset>
 #include <map>
@@ -95,7 +96,7 @@ template <int D> class PatchSolver : public ThunderEgg::PatchSolver<D>
 		/**
 		 * @brief The LocalData for the patch
 		 */
-		std::vector<LocalData<D>> lds;
+		PatchView<D> lds;
 
 		/**
 		 * @brief Get the number of local cells in the LocalData object
@@ -118,7 +119,7 @@ template <int D> class PatchSolver : public ThunderEgg::PatchSolver<D>
 		 *
 		 * @param ld_in the localdata for the patch
 		 */
-		SinglePatchVec(const std::vector<LocalData<D>> &lds)
+		SinglePatchVec(const PatchView<D> &lds)
 		: Vector<D>(MPI_COMM_SELF, lds.size(), 1, GetNumLocalCells(lds[0])), lds(lds)
 		{
 		}
@@ -181,6 +182,15 @@ template <int D> class PatchSolver : public ThunderEgg::PatchSolver<D>
 	 * @brief whether or not to continue on BreakDownError
 	 */
 	bool continue_on_breakdown;
+	/**
+	 * @brief Generates the work vectors for the patch solves, the vectors are recycled between
+	 * patches. This is created on the first patch solve.
+	 */
+	mutable std::shared_ptr<PooledVectorGenerator<D>> single_vg;
+	/**
+	 * @brief The number of components of the vectors generated by single_vg
+	 */
+	mutable int single_vg_num_components = 0;
 
 	public:
 	/**
@@ -198,11 +208,16 @@ template <int D> class PatchSolver : public ThunderEgg::PatchSolver<D>
 	{
 	}
 	void solveSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                      const std::vector<LocalData<D>> &   fs,
-	                      std::vector<LocalData<D>> &         us) const override
+	                      const PatchView<D> &                fs,
+	                      PatchView<D> &                      us) const override
 	{
-		std::shared_ptr<SinglePatchOp>      single_op(new SinglePatchOp(pinfo, op));
-		std::shared_ptr<VectorGenerator<D>> vg(new SingleVG(pinfo, fs.size()));
+		std::shared_ptr<SinglePatchOp> single_op(new SinglePatchOp(pinfo, op));
+		if (single_vg == nullptr || single_vg_num_components != (int) fs.size()) {
+			single_vg.reset(
+			new PooledVectorGenerator<D>(std::make_shared<SingleVG>(pinfo, fs.size())));
+			single_vg_num_components = fs.size();
+		}
+		std::shared_ptr<VectorGenerator<D>> vg = single_vg;
 
 		std::shared_ptr<Vector<D>> f_single(new SinglePatchVec(fs));
 		std::shared_ptr<Vector<D>> u_single(new SinglePatchVec(us));
@@ -22,6 +22,7 @@
 #ifndef THUNDEREGG_LOOPS_H
 #define THUNDEREGG_LOOPS_H
 
+#include <algorithm>
 #include <array>
 
 namespace ThunderEgg
@@ -87,5 +88,188 @@ template <int D, typename T, typename A> inline void nested_loop(A start, A end,
 	A coord = start;
 	NestedLoop<D, D - 1, T, A>::nested_loop_loop(coord, start, end, lambda);
 }
+/**
+ * @brief Loop over the rows of a box of cells
+ *
+ * A row is the set of cells along the first axis. The lambda is called with the coordinate of the
+ * first cell of each row, so that it only has to loop along the first axis.
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @param start the first coordinate of the box
+ * @param end the last coordinate of the box
+ * @param lambda called with the coordinate of the first cell of each row
+ */
+template <int D, typename T>
+inline void row_loop(const std::array<int, D> &start, const std::array<int, D> &end, T lambda)
+{
+	std::array<int, D> row_end = end;
+	row_end[0]                 = start[0];
+	nested_loop<D>(start, row_end, lambda);
+}
+/**
+ * @brief Loop over the rows of a box of cells in several arrays
+ *
+ * For each row, the lambda is called with the length of the row and a pointer to the first cell
+ * of the row in each of the arrays, so the inner loop is a plain unit stride loop
+ *
+ * 		nested_row_loop<D>(
+ * 		u.getStart(), u.getEnd(),
+ * 		[&](int n, const double *u_row, double *f_row) {
+ * 			for (int i = 0; i < n; i++) {
+ * 				f_row[i] = 2 * u_row[i];
+ * 			}
+ * 		},
+ * 		u, f);
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @param start the first coordinate of the box
+ * @param end the last coordinate of the box
+ * @param lambda called with the length of the row and the pointers to the rows
+ * @param arrays the arrays (LocalData objects), the rows of each have to be contiguous
+ */
+template <int D, typename T, typename... Arrays>
+inline void nested_row_loop(const std::array<int, D> &start, const std::array<int, D> &end,
+                            T lambda, Arrays &... arrays)
+{
+	int n = end[0] - start[0] + 1;
+	row_loop<D>(start, end,
+	            [&](const std::array<int, D> &coord) { lambda(n, arrays.getPtr(coord)...); });
+}
+/**
+ * @brief Loop over the rows of a box of cells, one tile at a time
+ *
+ * The box is split into tiles of tile_sizes cells on each axis, where a tile size of 0 (or one
+ * that is larger than the box) keeps the whole axis in one tile. The tiles are visited in the same
+ * order as nested_loop, and the lambda is called with the coordinate of the first cell of each row
+ * in the tile, and the length of the row.
+ *
+ * This keeps the working set of a stencil small enough to stay in cache on large patches, at the
+ * cost of shorter inner loops if the first axis is tiled.
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @param start the first coordinate of the box
+ * @param end the last coordinate of the box
+ * @param tile_sizes the number of cells in a tile on each axis
+ * @param lambda called with the coordinate of the first cell of each row and the row length
+ */
+template <int D, typename T>
+inline void tiled_row_loop(const std::array<int, D> &start, const std::array<int, D> &end,
+                           const std::array<int, D> &tile_sizes, T lambda)
+{
+	std::array<int, D> sizes;
+	std::array<int, D> tile_end;
+	for (int axis = 0; axis < D; axis++) {
+		int length  = end[axis] - start[axis] + 1;
+		sizes[axis] = (tile_sizes[axis] <= 0 || tile_sizes[axis] > length) ? length
+		                                                                    : tile_sizes[axis];
+		tile_end[axis] = (length + sizes[axis] - 1) / sizes[axis] - 1;
+	}
+	std::array<int, D> tile_start;
+	tile_start.fill(0);
+	nested_loop<D>(tile_start, tile_end, [&](const std::array<int, D> &tile) {
+		std::array<int, D> box_start;
+		std::array<int, D> box_end;
+		for (int axis = 0; axis < D; axis++) {
+			box_start[axis] = start[axis] + tile[axis] * sizes[axis];
+			box_end[axis]   = std::min(box_start[axis] + sizes[axis] - 1, end[axis]);
+		}
+		int n = box_end[0] - box_start[0] + 1;
+		row_loop<D>(box_start, box_end, [&](const std::array<int, D> &coord) { lambda(coord, n); });
+	});
+}
+/**
+ * @brief Loop over the rows of a box of cells in several arrays, one tile at a time
+ *
+ * This is the same as nested_row_loop, but the rows are visited tile by tile, see
+ * tiled_row_loop.
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @param start the first coordinate of the box
+ * @param end the last coordinate of the box
+ * @param tile_sizes the number of cells in a tile on each axis, 0 for the whole axis
+ * @param lambda called with the length of the row and the pointers to the rows
+ * @param arrays the arrays (LocalData objects), the rows of each have to be contiguous
+ */
+template <int D, typename T, typename... Arrays>
+inline void tiled_nested_row_loop(const std::array<int, D> &start, const std::array<int, D> &end,
+                                  const std::array<int, D> &tile_sizes, T lambda,
+                                  Arrays &... arrays)
+{
+	tiled_row_loop<D>(start, end, tile_sizes, [&](const std::array<int, D> &coord, int n) {
+		lambda(n, arrays.getPtr(coord)...);
+	});
+}
+/**
+ * @brief Check if any of the tile sizes is positive, that is, if tiling is enabled on any axis
+ */
+template <int D> inline bool is_tiled(const std::array<int, D> &tile_sizes)
+{
+	for (int axis = 0; axis < D; axis++) {
+		if (tile_sizes[axis] > 0) {
+			return true;
+		}
+	}
+	return false;
+}
+/**
+ * @brief Check if the rows of all of the arrays are contiguous
+ */
+inline bool rows_are_contiguous()
+{
+	return true;
+}
+/**
+ * @brief Check if the rows of all of the arrays are contiguous
+ */
+template <typename Array, typename... Arrays>
+inline bool rows_are_contiguous(const Array &array, const Arrays &... arrays)
+{
+	return array.getStrides()[0] == 1 && rows_are_contiguous(arrays...);
+}
+/**
+ * @brief Calls a function on the values of each cell in a row
+ */
+template <typename T> class CellLoopRow
+{
+	private:
+	T &lambda;
+
+	public:
+	explicit CellLoopRow(T &lambda) : lambda(lambda) {}
+	template <typename... Ptrs> inline void operator()(int n, Ptrs... rows) const
+	{
+		for (int i = 0; i < n; i++) {
+			lambda(rows[i]...);
+		}
+	}
+};
+/**
+ * @brief Loop over the cells of a box of cells in several arrays
+ *
+ * The lambda is called with a reference to the value of each cell in each of the arrays. If the
+ * rows of all of the arrays are contiguous, the rows are traversed with nested_row_loop, so that
+ * the inner loop can be vectorized.
+ *
+ * 		cell_loop<D>(
+ * 		u.getStart(), u.getEnd(), [&](const double &u_val, double &f_val) { f_val = 2 * u_val; }, u,
+ * 		f);
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @param start the first coordinate of the box
+ * @param end the last coordinate of the box
+ * @param lambda called with the values of each cell
+ * @param arrays the arrays (LocalData objects)
+ */
+template <int D, typename T, typename... Arrays>
+inline void cell_loop(const std::array<int, D> &start, const std::array<int, D> &end, T lambda,
+                      Arrays &... arrays)
+{
+	if (rows_are_contiguous(arrays...)) {
+		nested_row_loop<D>(start, end, CellLoopRow<T>(lambda), arrays...);
+	} else {
+		nested_loop<D>(start, end,
+		               [&](const std::array<int, D> &coord) { lambda(arrays[coord]...); });
+	}
+}
 } // namespace ThunderEgg
 #endif
\ No newline at end of file
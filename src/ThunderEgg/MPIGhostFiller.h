@@ -24,6 +24,12 @@
 
 #include <ThunderEgg/Domain.h>
 #include <ThunderEgg/GhostFiller.h>
+#include <ThunderEgg/NeighborComm.h>
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/SharedValVector.h>
+#include <ThunderEgg/Threading.h>
+#include <algorithm>
+#include <map>
 #include <mpi.h>
 namespace ThunderEgg
 {
@@ -50,33 +56,455 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 	                             const Orthant<D>, int, int>;
 
 	/**
-	 * @brief A vector of RemoteCall deques, one sperate deque for each rank
+	 * @brief The neighbor patch, the side of the neighbor patch that the local patch is on, the
+	 * rank of the neighbor patch, and the local index of the local patch
+	 *
+	 * The PatchInfo of the neighbor patch only has the neighbor info for the local patch, and its
+	 * local index is the local index on the rank that owns it.
+	 */
+	using SharedCall = std::tuple<std::shared_ptr<const PatchInfo<D>>, const Side<D>, int, int>;
+
+	/**
+	 * @brief deques of local calls to be made, one for each local patch, holding the calls that
+	 * fill the ghost cells of that patch
+	 *
+	 * Calls in different deques write to different patches, so the deques can be run
+	 * concurrently.
+	 */
+	std::vector<std::deque<LocalCall>> local_calls;
+	/**
+	 * @brief The buffers and persistent requests for one number of components
+	 *
+	 * The requests are bound to the buffers, so the buffers are never resized. With float
+	 * messages, the values are packed into the double buffers as usual, and the float buffers
+	 * are what is sent and recieved.
+	 */
+	struct Exchange {
+		/**
+		 * @brief recv buffer, with the values from each rank one after another
+		 */
+		std::vector<double> recv_buffer;
+		/**
+		 * @brief the number of values recieved from each rank
+		 */
+		std::vector<int> recv_counts;
+		/**
+		 * @brief the offset in recv_buffer for each rank
+		 */
+		std::vector<int> recv_displs;
+		/**
+		 * @brief send buffer, with the values for each rank one after another
+		 */
+		std::vector<double> send_buffer;
+		/**
+		 * @brief the number of values sent to each rank
+		 */
+		std::vector<int> send_counts;
+		/**
+		 * @brief the offset in send_buffer for each rank
+		 */
+		std::vector<int> send_displs;
+		/**
+		 * @brief true if the messages are sent as floats
+		 */
+		bool float_messages = false;
+		/**
+		 * @brief recv buffer for float messages, empty if doubles are sent
+		 */
+		std::vector<float> recv_float_buffer;
+		/**
+		 * @brief send buffer for float messages, empty if doubles are sent
+		 */
+		std::vector<float> send_float_buffer;
+		/**
+		 * @brief persistent recv requests, one for each rank, empty with neighbor collectives
+		 */
+		std::vector<MPI_Request> recv_requests;
+		/**
+		 * @brief persistent send requests, one for each rank, empty with neighbor collectives
+		 */
+		std::vector<MPI_Request> send_requests;
+		/**
+		 * @brief the request of the neighbor collective
+		 */
+		MPI_Request neighbor_request = MPI_REQUEST_NULL;
+		Exchange()                   = default;
+		Exchange(const Exchange &) = delete;
+		Exchange &operator=(const Exchange &) = delete;
+		/**
+		 * @brief Get the recv buffer for a rank
+		 *
+		 * @param i the index of the rank
+		 */
+		double *getRecvBuffer(size_t i)
+		{
+			return recv_buffer.data() + recv_displs[i];
+		}
+		/**
+		 * @brief Get the send buffer for a rank
+		 *
+		 * @param i the index of the rank
+		 */
+		double *getSendBuffer(size_t i)
+		{
+			return send_buffer.data() + send_displs[i];
+		}
+		/**
+		 * @brief Get the buffer that the message from a rank is recieved into
+		 *
+		 * @param i the index of the rank
+		 */
+		void *getRecvMessage(size_t i)
+		{
+			if (float_messages) {
+				return recv_float_buffer.data() + recv_displs[i];
+			}
+			return getRecvBuffer(i);
+		}
+		/**
+		 * @brief Get the buffer that the message to a rank is sent from
+		 *
+		 * @param i the index of the rank
+		 */
+		void *getSendMessage(size_t i)
+		{
+			if (float_messages) {
+				return send_float_buffer.data() + send_displs[i];
+			}
+			return getSendBuffer(i);
+		}
+		/**
+		 * @brief Get the buffer that the messages are recieved into
+		 */
+		void *getRecvMessages()
+		{
+			if (float_messages) {
+				return recv_float_buffer.data();
+			}
+			return recv_buffer.data();
+		}
+		/**
+		 * @brief Get the buffer that the messages are sent from
+		 */
+		void *getSendMessages()
+		{
+			if (float_messages) {
+				return send_float_buffer.data();
+			}
+			return send_buffer.data();
+		}
+		/**
+		 * @brief Get the MPI type of the messages
+		 */
+		MPI_Datatype getMessageType() const
+		{
+			return float_messages ? MPI_FLOAT : MPI_DOUBLE;
+		}
+		/**
+		 * @brief Free the persistent requests
+		 */
+		~Exchange()
+		{
+			int finalized;
+			MPI_Finalized(&finalized);
+			if (!finalized) {
+				for (MPI_Request &request : recv_requests) {
+					MPI_Request_free(&request);
+				}
+				for (MPI_Request &request : send_requests) {
+					MPI_Request_free(&request);
+				}
+			}
+		}
+	};
+	/**
+	 * @brief The messages that are sent and recieved for a fill
+	 */
+	struct MessagePlan {
+		/**
+		 * @brief A vector of RemoteCall deques, one sperate deque for each rank
+		 */
+		std::vector<std::deque<RemoteCall>> remote_calls;
+		/**
+		 * @brief vector of deques for incoming ghost cells, one deque for each rank
+		 *
+		 * the deques contain a tuple with the local index of the patch, the side that the ghost
+		 * cells are on, the offset in the buffer for those ghost cells, and the type of the
+		 * neighbor
+		 */
+		std::vector<std::deque<std::tuple<int, Side<D>, size_t, NbrType>>> incoming_ghosts;
+		/**
+		 * @brief vectors ranks, the position of the ranks correlate with other vectors.
+		 */
+		std::vector<size_t> index_rank_map;
+		/**
+		 * @brief lengths of send buffers for each rank
+		 */
+		std::vector<size_t> send_buff_lengths;
+		/**
+		 * @brief lengths of recv buffers for each rank
+		 */
+		std::vector<size_t> recv_buff_lengths;
+		/**
+		 * @brief The graph communicator over the ranks in index_rank_map, null if the exchange is
+		 * done with point-to-point messages
+		 */
+		std::shared_ptr<const NeighborComm> neighbor_comm;
+		/**
+		 * @brief The exchanges that have been set up, keyed by the number of components
+		 *
+		 * These are created the first time a vector with that number of components is filled,
+		 * and reused for every fill after that. When several vectors are filled together, the
+		 * key is the total number of components, and each buffer holds the values for the first
+		 * vector, followed by the values for the second vector, and so on.
+		 */
+		mutable std::map<int, std::shared_ptr<Exchange>> exchanges;
+	};
+	/**
+	 * @brief The messages for a fill of vectors that are not in shared memory
+	 */
+	MessagePlan plan;
+	/**
+	 * @brief The messages for a fill of SharedValVector objects, only the ghost cells that can not
+	 * be read from shared memory are sent. Null if shared memory is not used.
+	 */
+	std::unique_ptr<MessagePlan> shared_memory_plan;
+	/**
+	 * @brief The ranks that share memory, null if shared memory is not used
+	 */
+	std::shared_ptr<const SharedMemoryComm> shared_comm;
+	/**
+	 * @brief The neighbors that are read directly from shared memory
+	 */
+	std::deque<SharedCall> shared_calls;
+	/**
+	 * @brief A strided copy of a row of values
+	 */
+	struct GhostCopy {
+		/**
+		 * @brief the offset of the first value to copy from
+		 */
+		int src_offset;
+		/**
+		 * @brief the offset of the first value to copy to
+		 */
+		int dst_offset;
+		/**
+		 * @brief the number of values to copy
+		 */
+		int count;
+		/**
+		 * @brief the stride between the values to copy from
+		 */
+		int src_stride;
+		/**
+		 * @brief the stride between the values to copy to
+		 */
+		int dst_stride;
+	};
+	/**
+	 * @brief The copies that fill the ghost cells of normal neighbors for one patch layout
+	 *
+	 * Each array is indexed by the side of the patch that the ghost cells are on. The offsets are
+	 * relative to the first non-ghost cell of the patches, and to the start of the first component
+	 * of the ghost cells in the buffers.
+	 */
+	struct CopyPlan {
+		/**
+		 * @brief copies from the neighbor patch to the ghost cells of the patch
+		 */
+		std::array<std::vector<GhostCopy>, Side<D>::num_sides> local_copies;
+		/**
+		 * @brief copies from the neighbor patch to the ghost cells in a send buffer
+		 */
+		std::array<std::vector<GhostCopy>, Side<D>::num_sides> pack_copies;
+		/**
+		 * @brief copies from the ghost cells in a recv buffer to the ghost cells of the patch
+		 */
+		std::array<std::vector<GhostCopy>, Side<D>::num_sides> unpack_copies;
+		/**
+		 * @brief the number of values in a buffer for one component of the ghost cells
+		 */
+		std::array<int, Side<D>::num_sides> buffer_sizes;
+	};
+	/**
+	 * @brief The copy plans that have been built, keyed by the strides of the patches and if the
+	 * plan fills corners
+	 */
+	mutable std::map<std::pair<std::array<int, D>, bool>, std::shared_ptr<const CopyPlan>>
+	copy_plans;
+	/**
+	 * @brief true for the patches that recieve ghost cells from other ranks, indexed by local
+	 * index
+	 */
+	std::vector<bool> patch_needs_finish;
+	/**
+	 * @brief The vectors that are being filled, set between fillGhostStart and fillGhostFinish
+	 */
+	mutable std::vector<std::shared_ptr<const Vector<D>>> vectors_in_progress;
+	/**
+	 * @brief The exchange that is in progress, set between fillGhostStart and fillGhostFinish
+	 */
+	mutable Exchange *exchange_in_progress = nullptr;
+	/**
+	 * @brief The plan of the exchange that is in progress
+	 */
+	mutable const MessagePlan *plan_in_progress = nullptr;
+	/**
+	 * @brief The messages for each axis of a fill with corners, empty if corners are not filled
+	 */
+	std::vector<MessagePlan> corner_plans;
+	/**
+	 * @brief The local copies for each axis of a fill with corners, grouped by the patch that
+	 * they fill the ghost cells of like local_calls
+	 */
+	std::vector<std::vector<std::deque<LocalCall>>> corner_local_calls;
+	/**
+	 * @brief true if the exchanges are done with neighbor collectives
 	 */
-	std::vector<std::deque<RemoteCall>> remote_calls;
+	bool use_neighbor_collectives = false;
 	/**
-	 * @brief deque of local calls to be made
+	 * @brief true if the messages are sent as floats
 	 */
-	std::deque<LocalCall> local_calls;
+	bool use_float_messages = false;
+
 	/**
-	 * @brief vector of deques for incoming ghost cells, one deque for each rank
+	 * @brief Allocate a buffer for the messages to or from each rank, one after another
 	 *
-	 * the deques contain a tuple with the local index of the patch, the side that the ghost cells
-	 * are on, and the offset in the buffer for those ghost cells
+	 * @param lengths the length of the message for each rank, for one component
+	 * @param num_components the number of components
+	 * @param buffer the buffer
+	 * @param counts the number of values for each rank
+	 * @param displs the offset in the buffer for each rank
 	 */
-	std::vector<std::deque<std::tuple<int, Side<D>, size_t>>> incoming_ghosts;
+	static void SetUpBuffer(const std::vector<size_t> &lengths, int num_components,
+	                        std::vector<double> &buffer, std::vector<int> &counts,
+	                        std::vector<int> &displs)
+	{
+		counts.resize(lengths.size());
+		displs.resize(lengths.size());
+		int size = 0;
+		for (size_t i = 0; i < lengths.size(); i++) {
+			counts[i] = lengths[i] * num_components;
+			displs[i] = size;
+			size += counts[i];
+		}
+		buffer.resize(size);
+	}
 	/**
-	 * @brief vectors ranks, the position of the ranks correlate with other vectors.
+	 * @brief Get the Exchange for a number of components, creating it if it does not exist
+	 *
+	 * @param plan the messages of the exchange
+	 * @param num_components the number of components
+	 * @return Exchange& the exchange
 	 */
-	std::vector<size_t> index_rank_map;
+	Exchange &getExchange(const MessagePlan &plan, int num_components) const
+	{
+		std::shared_ptr<Exchange> &exchange = plan.exchanges[num_components];
+		if (exchange == nullptr) {
+			exchange.reset(new Exchange());
+			SetUpBuffer(plan.recv_buff_lengths, num_components, exchange->recv_buffer,
+			            exchange->recv_counts, exchange->recv_displs);
+			SetUpBuffer(plan.send_buff_lengths, num_components, exchange->send_buffer,
+			            exchange->send_counts, exchange->send_displs);
+			if (use_float_messages) {
+				exchange->float_messages = true;
+				exchange->recv_float_buffer.resize(exchange->recv_buffer.size());
+				exchange->send_float_buffer.resize(exchange->send_buffer.size());
+			}
+			if (plan.neighbor_comm == nullptr) {
+				size_t num_ranks = plan.index_rank_map.size();
+				exchange->recv_requests.resize(num_ranks);
+				exchange->send_requests.resize(num_ranks);
+				for (size_t i = 0; i < num_ranks; i++) {
+					MPI_Recv_init(exchange->getRecvMessage(i), exchange->recv_counts[i],
+					              exchange->getMessageType(), plan.index_rank_map[i], 0,
+					              MPI_COMM_WORLD, &exchange->recv_requests[i]);
+					MPI_Send_init(exchange->getSendMessage(i), exchange->send_counts[i],
+					              exchange->getMessageType(), plan.index_rank_map[i], 0,
+					              MPI_COMM_WORLD, &exchange->send_requests[i]);
+				}
+			}
+		}
+		return *exchange;
+	}
+
 	/**
-	 * @brief lengths of send buffers for each rank
+	 * @brief Get the number of cells along an axis in the ghost cells for a side
+	 *
+	 * @param side the side that the ghost cells are on
+	 * @param axis the axis
+	 * @param with_corners true if the ghost cells extend over the ghost cells of the lower axes
+	 * @return int the number of cells
 	 */
-	std::vector<size_t> send_buff_lengths;
+	int getGhostExtent(const Side<D> side, size_t axis, bool with_corners) const
+	{
+		int num_ghost_cells = domain->getNumGhostCells();
+		if (axis == side.getAxisIndex()) {
+			return num_ghost_cells;
+		} else if (with_corners && axis < side.getAxisIndex()) {
+			return domain->getNs()[axis] + 2 * num_ghost_cells;
+		} else {
+			return domain->getNs()[axis];
+		}
+	}
 	/**
-	 * @brief lengths of recv buffers for each rank
+	 * @brief Get the strides of the ghost cells for a side in a buffer
+	 *
+	 * @param side the side that the ghost cells are on
+	 * @param with_corners true if the ghost cells extend over the ghost cells of the lower axes
+	 * @return std::array<int, D> the strides
 	 */
-	std::vector<size_t> recv_buff_lengths;
+	std::array<int, D> getBufferStrides(const Side<D> side, bool with_corners = false) const
+	{
+		std::array<int, D> strides;
+		strides[0] = 1;
+		for (size_t i = 1; i < D; i++) {
+			strides[i] = getGhostExtent(side, i - 1, with_corners) * strides[i - 1];
+		}
+		return strides;
+	}
+	/**
+	 * @brief Get the number of values in a buffer for one component of the ghost cells for a side
+	 *
+	 * @param side the side that the ghost cells are on
+	 * @param strides the strides of the ghost cells in the buffer
+	 * @param with_corners true if the ghost cells extend over the ghost cells of the lower axes
+	 * @return int the number of values
+	 */
+	int getBufferSize(const Side<D> side, const std::array<int, D> &strides,
+	                  bool with_corners = false) const
+	{
+		return getGhostExtent(side, D - 1, with_corners) * strides[D - 1];
+	}
+	/**
+	 * @brief Get the position of the first non-ghost cell relative to the start of the ghost cells
+	 * for a side in a buffer, this position is outside of the buffer
+	 *
+	 * @param side the side that the ghost cells are on
+	 * @param strides the strides of the ghost cells in the buffer
+	 * @param with_corners true if the ghost cells extend over the ghost cells of the lower axes
+	 * @return int the offset
+	 */
+	int getBufferOrigin(const Side<D> side, const std::array<int, D> &strides,
+	                    bool with_corners = false) const
+	{
+		int    num_ghost_cells = domain->getNumGhostCells();
+		size_t axis            = side.getAxisIndex();
 
+		int origin = 0;
+		if (side.isLowerOnAxis()) {
+			origin = num_ghost_cells * strides[axis];
+		} else {
+			origin = -domain->getNs()[axis] * strides[axis];
+		}
+		if (with_corners) {
+			for (size_t i = 0; i < axis; i++) {
+				origin += num_ghost_cells * strides[i];
+			}
+		}
+		return origin;
+	}
 	/**
 	 * @brief Get the LocalData object for the buffer
 	 *
@@ -88,139 +516,587 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 	LocalData<D> getLocalDataForBuffer(double *buffer_ptr, const Side<D> side,
 	                                   int component_index) const
 	{
-		auto ns              = domain->getNs();
-		int  num_ghost_cells = domain->getNumGhostCells();
-		// determine striding
-		std::array<int, D> strides;
-		strides[0] = 1;
-		for (size_t i = 1; i < D; i++) {
-			if (i - 1 == side.getAxisIndex()) {
-				strides[i] = num_ghost_cells * strides[i - 1];
-			} else {
-				strides[i] = ns[i - 1] * strides[i - 1];
+		std::array<int, D> strides = getBufferStrides(side);
+		int                size    = getBufferSize(side, strides);
+		// transform buffer ptr so that it points to first non-ghost cell
+		double *transformed_buffer_ptr
+		= buffer_ptr + size * component_index + getBufferOrigin(side, strides);
+
+		LocalData<D> buffer_data(transformed_buffer_ptr, strides, domain->getNs(),
+		                         domain->getNumGhostCells());
+		return buffer_data;
+	}
+	/**
+	 * @brief Get the copies for the ghost cells on a side of a patch
+	 *
+	 * The ghost cells are copied one row at a time. The rows are along the first axis that is not
+	 * normal to the side.
+	 *
+	 * @param side the side of the patch that the ghost cells are on
+	 * @param src_strides the strides of the values that are copied from
+	 * @param src_origin the offset of the first non-ghost cell in the values that are copied from
+	 * @param src_is_ghost true if the values that are copied from are laid out as ghost cells on
+	 * the side, false if they are the non-ghost cells of the neighbor
+	 * @param dst_strides the strides of the ghost cells
+	 * @param dst_origin the offset of the first non-ghost cell in the ghost cells
+	 * @param with_corners true if the ghost cells extend over the ghost cells of the lower axes
+	 * @return std::vector<GhostCopy> the copies
+	 */
+	std::vector<GhostCopy> getSideCopies(const Side<D> side, const std::array<int, D> &src_strides,
+	                                     int src_origin, bool src_is_ghost,
+	                                     const std::array<int, D> &dst_strides, int dst_origin,
+	                                     bool with_corners) const
+	{
+		auto   ns              = domain->getNs();
+		int    num_ghost_cells = domain->getNumGhostCells();
+		size_t axis            = side.getAxisIndex();
+		size_t row_axis        = (axis == 0 && D > 1) ? 1 : 0;
+
+		// loop over the first cell of each row in a layer
+		std::array<int, D> start;
+		std::array<int, D> end;
+		for (size_t i = 0; i < D; i++) {
+			bool extended = with_corners && i < axis;
+			start[i]      = extended ? -num_ghost_cells : 0;
+			end[i]        = extended ? ns[i] - 1 + num_ghost_cells : ns[i] - 1;
+		}
+		end[axis]     = start[axis];
+		end[row_axis] = start[row_axis];
+
+		int row_length = row_axis == axis ? 1 : getGhostExtent(side, row_axis, with_corners);
+
+		std::vector<GhostCopy> copies;
+		for (int layer = 1; layer <= num_ghost_cells; layer++) {
+			int dst_index = side.isLowerOnAxis() ? -layer : ns[axis] - 1 + layer;
+			int src_index = dst_index;
+			if (!src_is_ghost) {
+				src_index = side.isLowerOnAxis() ? ns[axis] - layer : layer - 1;
 			}
+			nested_loop<D>(start, end, [&](const std::array<int, D> &coord) {
+				GhostCopy copy;
+				copy.src_offset = src_origin + src_index * src_strides[axis];
+				copy.dst_offset = dst_origin + dst_index * dst_strides[axis];
+				for (size_t i = 0; i < D; i++) {
+					if (i != axis) {
+						copy.src_offset += coord[i] * src_strides[i];
+						copy.dst_offset += coord[i] * dst_strides[i];
+					}
+				}
+				copy.count      = row_length;
+				copy.src_stride = src_strides[row_axis];
+				copy.dst_stride = dst_strides[row_axis];
+				copies.push_back(copy);
+			});
 		}
-		int size = D - 1 == side.getAxisIndex() ? (num_ghost_cells * strides[D - 1])
-		                                        : (ns[D - 1] * strides[D - 1]);
-		// transform buffer ptr so that it points to first non-ghost cell
-		double *transformed_buffer_ptr = buffer_ptr + size * component_index;
-		if (side.isLowerOnAxis()) {
-			transformed_buffer_ptr -= (-num_ghost_cells) * strides[side.getAxisIndex()];
-		} else {
-			transformed_buffer_ptr -= ns[side.getAxisIndex()] * strides[side.getAxisIndex()];
+		return copies;
+	}
+	/**
+	 * @brief Get the CopyPlan for the layout of a vector, building it if it does not exist
+	 *
+	 * @param u the vector
+	 * @param with_corners true to get the plan for a fill with corners
+	 * @return const CopyPlan* the plan, nullptr if the ghost cells of normal neighbors are not
+	 * filled with copies
+	 */
+	const CopyPlan *getCopyPlan(const Vector<D> &u, bool with_corners = false) const
+	{
+		if ((!with_corners && !copiesNormalNbrGhosts()) || u.getNumLocalPatches() == 0) {
+			return nullptr;
 		}
+		std::array<int, D> strides = u.getLocalData(0, 0).getStrides();
 
-		LocalData<D> buffer_data(transformed_buffer_ptr, strides, ns, num_ghost_cells);
-		return buffer_data;
+		std::shared_ptr<const CopyPlan> &copy_plan
+		= copy_plans[std::make_pair(strides, with_corners)];
+		if (copy_plan == nullptr) {
+			std::shared_ptr<CopyPlan> new_plan(new CopyPlan());
+			for (Side<D> s : Side<D>::getValues()) {
+				std::array<int, D> buffer_strides = getBufferStrides(s, with_corners);
+
+				int buffer_origin = getBufferOrigin(s, buffer_strides, with_corners);
+
+				new_plan->local_copies[s.getIndex()]
+				= getSideCopies(s, strides, 0, false, strides, 0, with_corners);
+				new_plan->pack_copies[s.getIndex()] = getSideCopies(
+				s, strides, 0, false, buffer_strides, buffer_origin, with_corners);
+				new_plan->unpack_copies[s.getIndex()] = getSideCopies(
+				s, buffer_strides, buffer_origin, true, strides, 0, with_corners);
+				new_plan->buffer_sizes[s.getIndex()]
+				= getBufferSize(s, buffer_strides, with_corners);
+			}
+			copy_plan = new_plan;
+		}
+		return copy_plan.get();
 	}
 	/**
-	 * @brief Post send requests
+	 * @brief Run a list of copies
 	 *
-	 * @param buffers the allocated buffers
-	 * @return std::vector<MPI_Request> the send requests
+	 * @param copies the copies
+	 * @param src the values to copy from
+	 * @param dst the values to copy to
 	 */
-	std::vector<MPI_Request> postRecvs(std::vector<std::vector<double>> &buffers) const
+	static void RunCopies(const std::vector<GhostCopy> &copies, const double *src, double *dst)
 	{
-		std::vector<MPI_Request> recv_requests(buffers.size());
-		for (size_t i = 0; i < recv_requests.size(); i++) {
-			MPI_Irecv(buffers[i].data(), buffers[i].size(), MPI_DOUBLE, index_rank_map[i], 0,
-			          MPI_COMM_WORLD, &recv_requests[i]);
+		for (const GhostCopy &copy : copies) {
+			const double *src_row = src + copy.src_offset;
+			double *      dst_row = dst + copy.dst_offset;
+			if (copy.src_stride == 1 && copy.dst_stride == 1) {
+				std::copy(src_row, src_row + copy.count, dst_row);
+			} else {
+				for (int i = 0; i < copy.count; i++) {
+					dst_row[i * copy.dst_stride] = src_row[i * copy.src_stride];
+				}
+			}
+		}
+	}
+	/**
+	 * @brief Copy the ghost cells of a normal neighbor for every component
+	 *
+	 * @param copies the copies for the side
+	 * @param src_datas the LocalData objects of the neighbor
+	 * @param dst_datas the LocalData objects of the patch
+	 */
+	static void CopyNormalNbrGhosts(const std::vector<GhostCopy> &copies,
+	                                const PatchView<D> &src_datas, const PatchView<D> &dst_datas)
+	{
+		for (size_t c = 0; c < dst_datas.size(); c++) {
+			RunCopies(copies, src_datas[c].getPtr(), dst_datas[c].getPtr());
+		}
+	}
+	/**
+	 * @brief Set the ghost cells that will be filled to zero
+	 *
+	 * The ghost cells of normal neighbors are skipped when they are filled with copies, since the
+	 * copies overwrite them.
+	 *
+	 * @param u the vector
+	 */
+	void zeroGhosts(std::shared_ptr<const Vector<D>> u) const
+	{
+		bool skip_normal = getCopyPlan(*u) != nullptr;
+		for (auto pinfo : domain->getPatchInfoVector()) {
+			for (auto &this_patch : u->getLocalDatas(pinfo->local_index)) {
+				for (Side<D> s : Side<D>::getValues()) {
+					if (pinfo->hasNbr(s)
+					    && !(skip_normal && pinfo->getNbrType(s) == NbrType::Normal)) {
+						for (int i = 0; i < pinfo->num_ghost_cells; i++) {
+							auto this_ghost = this_patch.getGhostSliceOnSide(s, i + 1);
+							nested_loop<D - 1>(
+							this_ghost.getStart(), this_ghost.getEnd(),
+							[&](const std::array<int, D - 1> &coord) { this_ghost[coord] = 0; });
+						}
+					}
+				}
+			}
+		}
+	}
+	/**
+	 * @brief Start the persistent recv requests
+	 *
+	 * @param exchange the exchange
+	 */
+	void postRecvs(Exchange &exchange) const
+	{
+		if (!exchange.recv_requests.empty()) {
+			MPI_Startall(exchange.recv_requests.size(), exchange.recv_requests.data());
 		}
-		return recv_requests;
 	}
 	/**
 	 * @brief process recv requests as they are ready
 	 *
-	 * @param requests the recv requests
-	 * @param buffers the recv buffers
-	 * @param u the vector to fill ghost values in
-	 */
-	void processRecvs(std::vector<MPI_Request> &requests, std::vector<std::vector<double>> &buffers,
-	                  std::shared_ptr<const Vector<D>> u) const
-	{
-		size_t num_requests = requests.size();
-		for (size_t i = 0; i < num_requests; i++) {
-			int finished_index;
-			MPI_Waitany(requests.size(), requests.data(), &finished_index, MPI_STATUS_IGNORE);
-			for (auto t : incoming_ghosts[finished_index]) {
-				int     local_index   = std::get<0>(t);
-				Side<D> side          = std::get<1>(t);
-				size_t  buffer_offset = std::get<2>(t);
-
-				for (int c = 0; c < u->getNumComponents(); c++) {
-					const LocalData<D> local_data = u->getLocalData(c, local_index);
-					double *           buffer_ptr
-					= buffers[finished_index].data() + buffer_offset * u->getNumComponents();
-					LocalData<D> buffer_data = getLocalDataForBuffer(buffer_ptr, side, c);
-					for (int ig = 0; ig < domain->getNumGhostCells(); ig++) {
-						LocalData<D - 1> local_slice = local_data.getGhostSliceOnSide(side, ig + 1);
-						LocalData<D - 1> buffer_slice
-						= buffer_data.getGhostSliceOnSide(side, ig + 1);
-						nested_loop<D - 1>(local_slice.getStart(), local_slice.getEnd(),
-						                   [&](const std::array<int, D - 1> &coord) {
-							                   local_slice[coord] += buffer_slice[coord];
-						                   });
+	 * @param plan the messages of the exchange
+	 * @param exchange the exchange with the recv requests and buffers
+	 * @param us the vectors to fill ghost values in
+	 * @param with_corners true if the buffers include the corners of the ghost cells
+	 */
+	void processRecvs(const MessagePlan &plan, Exchange &exchange,
+	                  const std::vector<std::shared_ptr<const Vector<D>>> &us,
+	                  bool with_corners = false) const
+	{
+		std::vector<MPI_Request> &requests  = exchange.recv_requests;
+		size_t                    num_ranks = plan.index_rank_map.size();
+		if (plan.neighbor_comm != nullptr) {
+			MPI_Wait(&exchange.neighbor_request, MPI_STATUS_IGNORE);
+		}
+		for (size_t i = 0; i < num_ranks; i++) {
+			int finished_index = i;
+			if (plan.neighbor_comm == nullptr) {
+				MPI_Waitany(requests.size(), requests.data(), &finished_index, MPI_STATUS_IGNORE);
+			}
+			double *vector_buffer = exchange.getRecvBuffer(finished_index);
+			if (exchange.float_messages) {
+				auto message = static_cast<const float *>(exchange.getRecvMessage(finished_index));
+				std::copy_n(message, exchange.recv_counts[finished_index], vector_buffer);
+			}
+			for (const auto &u : us) {
+				int             num_components = u->getNumComponents();
+				const CopyPlan *copy_plan      = getCopyPlan(*u, with_corners);
+				for (auto t : plan.incoming_ghosts[finished_index]) {
+					int     local_index   = std::get<0>(t);
+					Side<D> side          = std::get<1>(t);
+					size_t  buffer_offset = std::get<2>(t);
+					NbrType nbr_type      = std::get<3>(t);
+
+					if (copy_plan != nullptr && nbr_type == NbrType::Normal) {
+						double *buffer_ptr = vector_buffer + buffer_offset * num_components;
+						int     size       = copy_plan->buffer_sizes[side.getIndex()];
+						for (int c = 0; c < num_components; c++) {
+							LocalData<D> local_data = u->getLocalData(c, local_index);
+							RunCopies(copy_plan->unpack_copies[side.getIndex()],
+							          buffer_ptr + size * c, local_data.getPtr());
+						}
+						continue;
+					}
+					for (int c = 0; c < num_components; c++) {
+						const LocalData<D> local_data = u->getLocalData(c, local_index);
+						double *     buffer_ptr  = vector_buffer + buffer_offset * num_components;
+						LocalData<D> buffer_data = getLocalDataForBuffer(buffer_ptr, side, c);
+						for (int ig = 0; ig < domain->getNumGhostCells(); ig++) {
+							LocalData<D - 1> local_slice
+							= local_data.getGhostSliceOnSide(side, ig + 1);
+							LocalData<D - 1> buffer_slice
+							= buffer_data.getGhostSliceOnSide(side, ig + 1);
+							nested_loop<D - 1>(local_slice.getStart(), local_slice.getEnd(),
+							                   [&](const std::array<int, D - 1> &coord) {
+								                   local_slice[coord] += buffer_slice[coord];
+							                   });
+						}
 					}
 				}
+				vector_buffer += plan.recv_buff_lengths[finished_index] * num_components;
 			}
 		}
 	}
 	/**
-	 * @brief fill buffers and post send requests
+	 * @brief fill buffers and start the persistent send requests
 	 *
-	 * @param buffers the allocated buffers
-	 * @param u the vector to fill buffers from
-	 * @return std::vector<MPI_Request> the requests
+	 * Each send is started as soon as its buffer is filled. With neighbor collectives, the
+	 * exchange is started once all of the buffers are filled.
+	 *
+	 * @param plan the messages of the exchange
+	 * @param exchange the exchange with the send requests and buffers
+	 * @param us the vectors to fill buffers from
+	 * @param with_corners true if the buffers include the corners of the ghost cells
 	 */
-	std::vector<MPI_Request> postSends(std::vector<std::vector<double>> &buffers,
-	                                   std::shared_ptr<const Vector<D>>  u) const
+	void postSends(const MessagePlan &plan, Exchange &exchange,
+	               const std::vector<std::shared_ptr<const Vector<D>>> &us,
+	               bool with_corners = false) const
 	{
-		std::vector<MPI_Request> send_requests(send_buff_lengths.size());
-		for (size_t i = 0; i < remote_calls.size(); i++) {
-			for (const RemoteCall &call : remote_calls[i]) {
-				auto    pinfo         = std::get<0>(call);
-				auto    side          = std::get<1>(call);
-				auto    nbr_type      = std::get<2>(call);
-				auto    orthant       = std::get<3>(call);
-				auto    local_datas   = u->getLocalDatas(std::get<4>(call));
-				size_t  buffer_offset = std::get<5>(call);
-				double *buffer_ptr    = buffers[i].data() + buffer_offset * u->getNumComponents();
+		std::vector<const CopyPlan *> vector_copy_plans;
+		bool                          all_copied = true;
+		for (const auto &u : us) {
+			vector_copy_plans.push_back(getCopyPlan(*u, with_corners));
+			all_copied = all_copied && vector_copy_plans.back() != nullptr;
+		}
+
+		for (size_t i = 0; i < plan.remote_calls.size(); i++) {
+			// the ghost fillers add to the buffer, the copies overwrite it
+			bool needs_zero = !all_copied;
+			for (const RemoteCall &call : plan.remote_calls[i]) {
+				needs_zero = needs_zero || std::get<2>(call) != NbrType::Normal;
+			}
+			if (needs_zero) {
+				std::fill_n(exchange.getSendBuffer(i), exchange.send_counts[i], 0.0);
+			}
+			double *vector_buffer = exchange.getSendBuffer(i);
+			for (size_t v = 0; v < us.size(); v++) {
+				const auto &    u              = us[v];
+				const CopyPlan *copy_plan      = vector_copy_plans[v];
+				int             num_components = u->getNumComponents();
+				for (const RemoteCall &call : plan.remote_calls[i]) {
+					auto    pinfo         = std::get<0>(call);
+					auto    side          = std::get<1>(call);
+					auto    nbr_type      = std::get<2>(call);
+					auto    orthant       = std::get<3>(call);
+					auto    local_datas   = u->getLocalDatas(std::get<4>(call));
+					size_t  buffer_offset = std::get<5>(call);
+					double *buffer_ptr    = vector_buffer + buffer_offset * num_components;
+
+					if (copy_plan != nullptr && nbr_type == NbrType::Normal) {
+						Side<D> ghost_side = side.opposite();
+						int     size       = copy_plan->buffer_sizes[ghost_side.getIndex()];
+						for (int c = 0; c < num_components; c++) {
+							RunCopies(copy_plan->pack_copies[ghost_side.getIndex()],
+							          local_datas[c].getPtr(), buffer_ptr + size * c);
+						}
+						continue;
+					}
+
+					// create LocalData objects for the buffer
+					PatchView<D> buffer_datas(num_components);
+					for (int c = 0; c < num_components; c++) {
+						buffer_datas[c] = getLocalDataForBuffer(buffer_ptr, side.opposite(), c);
+					}
 
-				// create LocalData objects for the buffer
-				std::vector<LocalData<D>> buffer_datas(u->getNumComponents());
-				for (int c = 0; c < u->getNumComponents(); c++) {
-					buffer_datas[c] = getLocalDataForBuffer(buffer_ptr, side.opposite(), c);
+					// make the call
+					fillGhostCellsForNbrPatch(pinfo, local_datas, buffer_datas, side, nbr_type,
+					                          orthant);
 				}
+				vector_buffer += plan.send_buff_lengths[i] * num_components;
+			}
+			if (exchange.float_messages) {
+				std::copy_n(exchange.getSendBuffer(i), exchange.send_counts[i],
+				            static_cast<float *>(exchange.getSendMessage(i)));
+			}
+			if (plan.neighbor_comm == nullptr) {
+				MPI_Start(&exchange.send_requests[i]);
+			}
+		}
+		if (plan.neighbor_comm != nullptr) {
+			plan.neighbor_comm->alltoallvStart(
+			exchange.getSendMessages(), exchange.send_counts, exchange.send_displs,
+			exchange.getRecvMessages(), exchange.recv_counts, exchange.recv_displs,
+			exchange.getMessageType(), &exchange.neighbor_request);
+		}
+	}
 
-				// make the call
-				fillGhostCellsForNbrPatch(pinfo, local_datas, buffer_datas, side, nbr_type,
-				                          orthant);
+	/**
+	 * @brief Check if the ghost cells of the vectors can be read from shared memory
+	 *
+	 * @param us the vectors
+	 * @return true if shared memory is used and every vector is a SharedValVector with the same
+	 * ranks
+	 */
+	bool canUseSharedMemory(const std::vector<std::shared_ptr<const Vector<D>>> &us) const
+	{
+		if (shared_memory_plan == nullptr) {
+			return false;
+		}
+		for (const auto &u : us) {
+			auto shared_u = dynamic_cast<const SharedValVector<D> *>(u.get());
+			if (shared_u == nullptr) {
+				return false;
+			}
+			int result;
+			MPI_Comm_compare(shared_u->getSharedMemoryComm()->getComm(), shared_comm->getComm(),
+			                 &result);
+			if (result != MPI_IDENT && result != MPI_CONGRUENT) {
+				return false;
 			}
-			MPI_Isend(buffers[i].data(), buffers[i].size(), MPI_DOUBLE, index_rank_map[i], 0,
-			          MPI_COMM_WORLD, &send_requests[i]);
 		}
-		return send_requests;
+		return true;
 	}
+	/**
+	 * @brief Check if the ghost cells from patches on this rank can be filled by several threads
+	 *
+	 * @param us the vectors
+	 * @return true if this filler and every vector are thread safe
+	 */
+	bool canFillLocalGhostsInParallel(const std::vector<std::shared_ptr<const Vector<D>>> &us) const
+	{
+		bool parallel = isThreadSafe();
+		for (const auto &u : us) {
+			parallel = parallel && u->isThreadSafe();
+		}
+		return parallel;
+	}
+	/**
+	 * @brief Fill the ghost cells from the normal neighbors that are on other ranks of the node
+	 *
+	 * The values are read directly from the other ranks. This waits for the other ranks on the
+	 * node twice, once so that the patches are not read before they are written, and once so that
+	 * the patches of this rank are not written while they are still being read.
+	 *
+	 * @param us the vectors, all of them are SharedValVector objects
+	 */
+	void fillSharedGhosts(const std::vector<std::shared_ptr<const Vector<D>>> &us) const
+	{
+		for (const auto &u : us) {
+			static_cast<const SharedValVector<D> *>(u.get())->sync();
+		}
+		shared_comm->barrier();
 
-	protected:
+		for (const auto &u : us) {
+			auto            shared_u       = static_cast<const SharedValVector<D> *>(u.get());
+			int             num_components = u->getNumComponents();
+			const CopyPlan *copy_plan      = getCopyPlan(*u);
+			for (const SharedCall &call : shared_calls) {
+				auto nbr_pinfo   = std::get<0>(call);
+				auto side        = std::get<1>(call);
+				int  nbr_rank    = std::get<2>(call);
+				auto local_datas = u->getLocalDatas(std::get<3>(call));
+
+				PatchView<D> nbr_datas(num_components);
+				for (int c = 0; c < num_components; c++) {
+					nbr_datas[c] = shared_u->getNodeLocalData(nbr_rank, c, nbr_pinfo->local_index);
+				}
+				if (copy_plan != nullptr) {
+					CopyNormalNbrGhosts(copy_plan->local_copies[side.opposite().getIndex()],
+					                    nbr_datas, local_datas);
+				} else {
+					fillGhostCellsForNbrPatch(nbr_pinfo, nbr_datas, local_datas, side,
+					                          NbrType::Normal, Orthant<D>::null());
+				}
+			}
+		}
+
+		for (const auto &u : us) {
+			static_cast<const SharedValVector<D> *>(u.get())->sync();
+		}
+		shared_comm->barrier();
+	}
 	/**
-	 * @brief The domain that this ghostfiller operates on
+	 * @brief Build the messages and local copies for each axis of a fill with corners
 	 */
-	std::shared_ptr<const Domain<D>> domain;
+	void buildCornerPlans()
+	{
+		int rank;
+		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+		std::vector<std::vector<std::deque<LocalCall>>> local_calls_by_axis(
+		D, std::vector<std::deque<LocalCall>>(domain->getNumLocalPatches()));
+		using RemoteKey = std::tuple<int, int, Side<D>, std::shared_ptr<const PatchInfo<D>>, int>;
+		// rank nbr_id side pinfo local_index, for each axis
+		std::vector<std::set<RemoteKey>> remote_call_sets(D);
+		// rank id side local_index, for each axis
+		std::vector<std::set<std::tuple<int, int, Side<D>, int>>> incoming_ghost_sets(D);
+		for (auto pinfo : domain->getPatchInfoVector()) {
+			for (Side<D> s : Side<D>::getValues()) {
+				if (!pinfo->hasNbr(s)) {
+					continue;
+				}
+				if (pinfo->getNbrType(s) != NbrType::Normal) {
+					throw RuntimeError("MPIGhostFiller can only fill corners when every neighbor "
+					                   "is on the same refinement level");
+				}
+				auto   nbrinfo = pinfo->getNormalNbrInfo(s);
+				size_t axis    = s.getAxisIndex();
+				if (nbrinfo.rank == rank) {
+					local_calls_by_axis[axis][nbrinfo.local_index].emplace_back(
+					pinfo, s, NbrType::Normal, Orthant<D>::null(), pinfo->local_index,
+					nbrinfo.local_index);
+				} else {
+					remote_call_sets[axis].emplace(nbrinfo.rank, nbrinfo.id, s.opposite(), pinfo,
+					                               pinfo->local_index);
+					incoming_ghost_sets[axis].emplace(nbrinfo.rank, pinfo->id, s,
+					                                  pinfo->local_index);
+				}
+			}
+		}
+		corner_local_calls.swap(local_calls_by_axis);
+		corner_plans.resize(D);
+		for (size_t axis = 0; axis < D; axis++) {
+			MessagePlan &      axis_plan = corner_plans[axis];
+			Side<D>            side      = Side<D>::LowerSideOnAxis(axis);
+			std::array<int, D> strides   = getBufferStrides(side, true);
+			size_t             length    = getBufferSize(side, strides, true);
+
+			std::map<int, size_t> rank_index_map;
+			for (const auto &call : remote_call_sets[axis]) {
+				int nbr_rank = std::get<0>(call);
+				if (rank_index_map.count(nbr_rank) == 0) {
+					rank_index_map[nbr_rank] = axis_plan.index_rank_map.size();
+					axis_plan.index_rank_map.push_back(nbr_rank);
+				}
+			}
+			size_t num_ranks = axis_plan.index_rank_map.size();
+			axis_plan.remote_calls.resize(num_ranks);
+			axis_plan.send_buff_lengths.resize(num_ranks);
+			for (const auto &call : remote_call_sets[axis]) {
+				size_t index  = rank_index_map[std::get<0>(call)];
+				size_t offset = axis_plan.send_buff_lengths[index];
+				axis_plan.send_buff_lengths[index] += length;
+				axis_plan.remote_calls[index].emplace_back(
+				std::get<3>(call), std::get<2>(call).opposite(), NbrType::Normal,
+				Orthant<D>::null(), std::get<4>(call), offset);
+			}
+			axis_plan.incoming_ghosts.resize(num_ranks);
+			axis_plan.recv_buff_lengths.resize(num_ranks);
+			for (const auto &t : incoming_ghost_sets[axis]) {
+				size_t index  = rank_index_map.at(std::get<0>(t));
+				size_t offset = axis_plan.recv_buff_lengths[index];
+				axis_plan.recv_buff_lengths[index] += length;
+				axis_plan.incoming_ghosts[index].emplace_back(std::get<3>(t), std::get<2>(t),
+				                                              offset, NbrType::Normal);
+			}
+			setUpNeighborComm(axis_plan);
+		}
+	}
 	/**
-	 * @brief Number of sides to address
+	 * @brief Create or free the graph communicator of a plan, depending on
+	 * use_neighbor_collectives
+	 *
+	 * The exchanges of the plan are freed, since they depend on the way that the messages are
+	 * sent. This is a collective call over MPI_COMM_WORLD when neighbor collectives are used.
+	 *
+	 * @param message_plan the plan
 	 */
-	int side_cases;
+	void setUpNeighborComm(MessagePlan &message_plan)
+	{
+		message_plan.exchanges.clear();
+		message_plan.neighbor_comm = nullptr;
+		if (use_neighbor_collectives) {
+			std::vector<int> ranks(message_plan.index_rank_map.begin(),
+			                       message_plan.index_rank_map.end());
+			message_plan.neighbor_comm
+			= std::make_shared<NeighborComm>(MPI_COMM_WORLD, ranks, ranks);
+		}
+	}
+	/**
+	 * @brief Start a fill with corners
+	 *
+	 * The axes are filled one after the other, and the ghost cells that are copied for an axis
+	 * include the ghost cells of the neighbor on the lower axes. This fills the edges and corners
+	 * without knowing the diagonal neighbors. Every axis but the last is finished here.
+	 *
+	 * @param us the vectors
+	 * @param total_components the total number of components in the vectors
+	 */
+	void fillCornersStart(const std::vector<std::shared_ptr<const Vector<D>>> &us,
+	                      int total_components) const
+	{
+		for (size_t axis = 0; axis < D; axis++) {
+			const MessagePlan &axis_plan = corner_plans[axis];
+			Exchange &         exchange  = getExchange(axis_plan, total_components);
+			postRecvs(exchange);
+			postSends(axis_plan, exchange, us, true);
 
-	public:
+			std::vector<const CopyPlan *> vector_copy_plans;
+			for (const auto &u : us) {
+				vector_copy_plans.push_back(getCopyPlan(*u, true));
+			}
+			Threading::ParallelFor(
+			domain->getNumLocalPatches(),
+			[&](int i) {
+				for (size_t v = 0; v < us.size(); v++) {
+					const CopyPlan *copy_plan = vector_copy_plans[v];
+					if (copy_plan == nullptr) {
+						continue;
+					}
+					for (const LocalCall &call : corner_local_calls[axis][i]) {
+						auto side        = std::get<1>(call);
+						auto local_datas = us[v]->getLocalDatas(std::get<4>(call));
+						auto nbr_datas   = us[v]->getLocalDatas(std::get<5>(call));
+						CopyNormalNbrGhosts(copy_plan->local_copies[side.opposite().getIndex()],
+						                    local_datas, nbr_datas);
+					}
+				}
+			},
+			canFillLocalGhostsInParallel(us));
+
+			if (axis + 1 < D) {
+				processRecvs(axis_plan, exchange, us, true);
+				MPI_Waitall(exchange.send_requests.size(), exchange.send_requests.data(),
+				            MPI_STATUSES_IGNORE);
+			} else {
+				exchange_in_progress = &exchange;
+				plan_in_progress     = &axis_plan;
+				vectors_in_progress  = us;
+			}
+		}
+	}
 	/**
-	 * @brief Construct a new MPIGhostFiller object
+	 * @brief Build the messages that are sent and recieved for a fill
 	 *
-	 * @param domain_in  the domain being used
-	 * @param side_cases_in  the number of side cases to address
+	 * When node_comm is null the local calls are also collected, they are the same for every
+	 * plan.
+	 *
+	 * @param plan the plan to build
+	 * @param node_comm if not null, the normal neighbors on ranks that share memory are left out
+	 * of the plan
+	 * @param node_nbrs the patches and sides of the normal neighbors that were left out
 	 */
-	MPIGhostFiller(std::shared_ptr<const Domain<D>> domain_in, int side_cases_in)
-	: domain(domain_in), side_cases(side_cases_in)
+	void buildMessagePlan(
+	MessagePlan &plan, const SharedMemoryComm *node_comm,
+	std::deque<std::pair<std::shared_ptr<const PatchInfo<D>>, Side<D>>> *node_nbrs)
 	{
 		int rank;
 		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -228,8 +1104,8 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 		std::set<std::tuple<int, int, const Side<D>, const Orthant<D>, const NbrType,
 		                    std::shared_ptr<const PatchInfo<D>>, int>>
 		remote_call_set;
-		// rank id side local index
-		std::set<std::tuple<int, int, const Side<D>, int>> incoming_ghost_set;
+		// rank id side local index nbrtype
+		std::set<std::tuple<int, int, const Side<D>, int, NbrType>> incoming_ghost_set;
 
 		std::array<size_t, D> axis_ghost_lengths;
 		for (size_t axis = 0; axis < D; axis++) {
@@ -251,16 +1127,20 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 						case NbrType::Normal: {
 							auto nbrinfo = pinfo->getNormalNbrInfo(s);
 							if (nbrinfo.rank == rank) {
-								local_calls.emplace_back(pinfo, s, NbrType::Normal,
-								                         Orthant<D>::null(), pinfo->local_index,
-								                         nbrinfo.local_index);
+								if (node_comm == nullptr) {
+									local_calls[nbrinfo.local_index].emplace_back(
+									pinfo, s, NbrType::Normal, Orthant<D>::null(),
+									pinfo->local_index, nbrinfo.local_index);
+								}
+							} else if (node_comm != nullptr && node_comm->contains(nbrinfo.rank)) {
+								node_nbrs->emplace_back(pinfo, s);
 							} else {
 								ranks.insert(nbrinfo.rank);
 								remote_call_set.emplace(nbrinfo.rank, nbrinfo.id, s.opposite(),
 								                        Orthant<D>::null(), NbrType::Normal, pinfo,
 								                        pinfo->local_index);
 								incoming_ghost_set.emplace(nbrinfo.rank, pinfo->id, s,
-								                           pinfo->local_index);
+								                           pinfo->local_index, NbrType::Normal);
 							}
 						} break;
 						case NbrType::Fine: {
@@ -268,16 +1148,18 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 							auto orthants = Orthant<D>::getValuesOnSide(s);
 							for (size_t i = 0; i < orthants.size(); i++) {
 								if (nbrinfo.ranks[i] == rank) {
-									local_calls.emplace_back(pinfo, s, NbrType::Fine, orthants[i],
-									                         pinfo->local_index,
-									                         nbrinfo.local_indexes[i]);
+									if (node_comm == nullptr) {
+										local_calls[nbrinfo.local_indexes[i]].emplace_back(
+										pinfo, s, NbrType::Fine, orthants[i], pinfo->local_index,
+										nbrinfo.local_indexes[i]);
+									}
 								} else {
 									ranks.insert(nbrinfo.ranks[i]);
 									remote_call_set.emplace(
 									nbrinfo.ranks[i], nbrinfo.ids[i], s.opposite(), orthants[i],
 									NbrType::Fine, pinfo, pinfo->local_index);
 									incoming_ghost_set.emplace(nbrinfo.ranks[i], pinfo->id, s,
-									                           pinfo->local_index);
+									                           pinfo->local_index, NbrType::Fine);
 								}
 							}
 						} break;
@@ -286,15 +1168,18 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 							auto orthant = Orthant<D>::getValuesOnSide(
 							s.opposite())[nbrinfo.orth_on_coarse.getIndex()];
 							if (nbrinfo.rank == rank) {
-								local_calls.emplace_back(pinfo, s, NbrType::Coarse, orthant,
-								                         pinfo->local_index, nbrinfo.local_index);
+								if (node_comm == nullptr) {
+									local_calls[nbrinfo.local_index].emplace_back(
+									pinfo, s, NbrType::Coarse, orthant, pinfo->local_index,
+									nbrinfo.local_index);
+								}
 							} else {
 								ranks.insert(nbrinfo.rank);
 								remote_call_set.emplace(nbrinfo.rank, nbrinfo.id, s.opposite(),
 								                        orthant, NbrType::Coarse, pinfo,
 								                        pinfo->local_index);
 								incoming_ghost_set.emplace(nbrinfo.rank, pinfo->id, s,
-								                           pinfo->local_index);
+								                           pinfo->local_index, NbrType::Coarse);
 							}
 						} break;
 					}
@@ -302,6 +1187,7 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 			}
 		}
 		std::map<int, size_t> rank_index_map;
+		std::vector<size_t> &index_rank_map = plan.index_rank_map;
 		index_rank_map.reserve(ranks.size());
 		int curr_index = 0;
 		for (int rank : ranks) {
@@ -310,8 +1196,9 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 			curr_index++;
 		}
 		std::tuple<int, Side<D>> prev_id_side;
+		std::vector<size_t> &send_buff_lengths = plan.send_buff_lengths;
 		send_buff_lengths.resize(ranks.size());
-		remote_calls.resize(ranks.size());
+		plan.remote_calls.resize(ranks.size());
 		for (auto call : remote_call_set) {
 			int  local_buffer_index = rank_index_map[std::get<0>(call)];
 			int  id                 = std::get<1>(call);
@@ -333,16 +1220,18 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 				send_buff_lengths[local_buffer_index] += length;
 			}
 
-			remote_calls[local_buffer_index].emplace_back(pinfo, side, nbr_type, orthant,
-			                                              local_index, offset);
+			plan.remote_calls[local_buffer_index].emplace_back(pinfo, side, nbr_type, orthant,
+			                                                   local_index, offset);
 			prev_id_side = std::make_tuple(id, side);
 		}
+		std::vector<size_t> &recv_buff_lengths = plan.recv_buff_lengths;
 		recv_buff_lengths.resize(ranks.size());
-		incoming_ghosts.resize(ranks.size());
+		plan.incoming_ghosts.resize(ranks.size());
 		for (auto t : incoming_ghost_set) {
 			int     local_buffer_index = rank_index_map[std::get<0>(t)];
 			Side<D> side               = std::get<2>(t);
 			int     local_index        = std::get<3>(t);
+			NbrType nbr_type           = std::get<4>(t);
 
 			// add length for ghosts to buffer length
 			size_t length = axis_ghost_lengths[side.getAxisIndex()];
@@ -350,9 +1239,248 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 			recv_buff_lengths[local_buffer_index] += length;
 
 			// add ghost to incoming ghosts
-			incoming_ghosts[local_buffer_index].emplace_back(local_index, side, offset);
+			plan.incoming_ghosts[local_buffer_index].emplace_back(local_index, side, offset,
+			                                                      nbr_type);
 		}
 	}
+
+	protected:
+	/**
+	 * @brief The domain that this ghostfiller operates on
+	 */
+	std::shared_ptr<const Domain<D>> domain;
+	/**
+	 * @brief Number of sides to address
+	 */
+	int side_cases;
+
+	public:
+	/**
+	 * @brief Construct a new MPIGhostFiller object
+	 *
+	 * @param domain_in  the domain being used
+	 * @param side_cases_in  the number of side cases to address
+	 */
+	MPIGhostFiller(std::shared_ptr<const Domain<D>> domain_in, int side_cases_in)
+	: domain(domain_in), side_cases(side_cases_in)
+	{
+		local_calls.resize(domain->getNumLocalPatches());
+		buildMessagePlan(plan, nullptr, nullptr);
+		patch_needs_finish.resize(domain->getNumLocalPatches(), false);
+		for (const auto &incoming : plan.incoming_ghosts) {
+			for (const auto &t : incoming) {
+				patch_needs_finish[std::get<0>(t)] = true;
+			}
+		}
+	}
+	/**
+	 * @brief Read the ghost cells of normal neighbors on the same node directly from shared memory
+	 *
+	 * This is only used when every vector that is filled is a SharedValVector with the same ranks,
+	 * other vectors are filled with messages. Ghost cells from coarse and fine neighbors, and from
+	 * neighbors on other nodes, are still sent with messages.
+	 *
+	 * When this is used, fillGhostStart waits for the other ranks on the node, so every rank on the
+	 * node has to fill the same vectors at the same time. This has to be called on every rank.
+	 *
+	 * @param shared_comm the ranks that share memory, split from MPI_COMM_WORLD. nullptr to only
+	 * use messages.
+	 */
+	void setUseSharedMemory(std::shared_ptr<const SharedMemoryComm> shared_comm)
+	{
+		if (exchange_in_progress != nullptr) {
+			throw RuntimeError("MPIGhostFiller can not change modes while a fill is in progress");
+		}
+		this->shared_comm = shared_comm;
+		shared_memory_plan.reset();
+		shared_calls.clear();
+		if (shared_comm == nullptr) {
+			return;
+		}
+		int result;
+		MPI_Comm_compare(shared_comm->getParentComm(), MPI_COMM_WORLD, &result);
+		if (result != MPI_IDENT && result != MPI_CONGRUENT) {
+			throw RuntimeError("MPIGhostFiller needs a SharedMemoryComm split from MPI_COMM_WORLD");
+		}
+
+		std::deque<std::pair<std::shared_ptr<const PatchInfo<D>>, Side<D>>> node_nbrs;
+		shared_memory_plan.reset(new MessagePlan());
+		buildMessagePlan(*shared_memory_plan, shared_comm.get(), &node_nbrs);
+		setUpNeighborComm(*shared_memory_plan);
+
+		// the local indexes in NbrInfo are only valid on this rank, get the local indexes of the
+		// neighbors from the ranks that own them
+		std::map<int, std::vector<int>> send_buffers;
+		for (const auto &nbr : node_nbrs) {
+			std::vector<int> &buffer = send_buffers[nbr.first->getNormalNbrInfo(nbr.second).rank];
+			buffer.push_back(nbr.first->id);
+			buffer.push_back(nbr.first->local_index);
+		}
+		std::vector<MPI_Request> send_requests;
+		send_requests.reserve(send_buffers.size());
+		for (auto &pair : send_buffers) {
+			send_requests.emplace_back();
+			MPI_Isend(pair.second.data(), pair.second.size(), MPI_INT, pair.first, 1,
+			          MPI_COMM_WORLD, &send_requests.back());
+		}
+		// normal neighbors are symmetric, so every rank that was sent to also sends
+		std::map<int, int> nbr_local_indexes;
+		for (auto &pair : send_buffers) {
+			MPI_Status status;
+			MPI_Probe(pair.first, 1, MPI_COMM_WORLD, &status);
+			int count;
+			MPI_Get_count(&status, MPI_INT, &count);
+			std::vector<int> buffer(count);
+			MPI_Recv(buffer.data(), count, MPI_INT, pair.first, 1, MPI_COMM_WORLD,
+			         MPI_STATUS_IGNORE);
+			for (int i = 0; i < count; i += 2) {
+				nbr_local_indexes[buffer[i]] = buffer[i + 1];
+			}
+		}
+		MPI_Waitall(send_requests.size(), send_requests.data(), MPI_STATUSES_IGNORE);
+
+		for (const auto &nbr : node_nbrs) {
+			std::shared_ptr<const PatchInfo<D>> pinfo   = nbr.first;
+			Side<D>                             s       = nbr.second;
+			const NormalNbrInfo<D> &            nbrinfo = pinfo->getNormalNbrInfo(s);
+
+			// a PatchInfo for the neighbor, with only the local patch as a neighbor
+			std::shared_ptr<PatchInfo<D>> nbr_pinfo(new PatchInfo<D>(*pinfo));
+			nbr_pinfo->id           = nbrinfo.id;
+			nbr_pinfo->rank         = nbrinfo.rank;
+			nbr_pinfo->local_index  = nbr_local_indexes.at(nbrinfo.id);
+			nbr_pinfo->global_index = nbrinfo.global_index;
+
+			int axis = s.getAxisIndex();
+			nbr_pinfo->starts[axis] += (s.isLowerOnAxis() ? -1 : 1) * pinfo->spacings[axis]
+			                           * pinfo->ns[axis];
+			nbr_pinfo->neumann.reset();
+			nbr_pinfo->nbr_info.fill(nullptr);
+
+			std::shared_ptr<NormalNbrInfo<D>> back_info(new NormalNbrInfo<D>(pinfo->id));
+			back_info->rank         = pinfo->rank;
+			back_info->local_index  = pinfo->local_index;
+			back_info->global_index = pinfo->global_index;
+
+			nbr_pinfo->nbr_info[s.opposite().getIndex()] = back_info;
+
+			shared_calls.emplace_back(nbr_pinfo, s.opposite(), nbrinfo.rank, pinfo->local_index);
+		}
+	}
+	/**
+	 * @brief Fill the edge and corner regions of the ghost cells as well
+	 *
+	 * In this mode every layer of ghost cells is copied from the neighbors, including the regions
+	 * that are next to two or more sides of the patch. The axes are exchanged one after another,
+	 * so a fill takes D rounds of messages. This lets a smoother do as many sweeps as there are
+	 * ghost layers between fills.
+	 *
+	 * Every neighbor has to be on the same refinement level. The ghost cells are only copied,
+	 * fillGhostCellsForNbrPatch and fillGhostCellsForLocalPatch are not called, and shared memory
+	 * is not used.
+	 *
+	 * @param fill_corners true to fill the corners
+	 */
+	void setFillCorners(bool fill_corners)
+	{
+		if (exchange_in_progress != nullptr) {
+			throw RuntimeError("MPIGhostFiller can not change modes while a fill is in progress");
+		}
+		corner_plans.clear();
+		corner_local_calls.clear();
+		if (fill_corners) {
+			buildCornerPlans();
+		}
+	}
+	/**
+	 * @brief Check if the edge and corner regions of the ghost cells are filled
+	 */
+	bool getFillCorners() const
+	{
+		return !corner_plans.empty();
+	}
+	/**
+	 * @brief Exchange the ghost cells with neighbor collectives instead of point-to-point messages
+	 *
+	 * A graph communicator over the neighboring ranks is created for each set of messages, and
+	 * each exchange is a single MPI_Ineighbor_alltoallv. This lets the MPI implementation coalesce
+	 * the messages and take the topology into account. The ghost values are unpacked once every
+	 * message has arrived, instead of as each message arrives.
+	 *
+	 * This is a collective call over MPI_COMM_WORLD, and so are setFillCorners and
+	 * setUseSharedMemory while neighbor collectives are used.
+	 *
+	 * @param use_neighbor_collectives true to use neighbor collectives
+	 */
+	void setUseNeighborCollectives(bool use_neighbor_collectives)
+	{
+		if (exchange_in_progress != nullptr) {
+			throw RuntimeError("MPIGhostFiller can not change modes while a fill is in progress");
+		}
+		this->use_neighbor_collectives = use_neighbor_collectives;
+		setUpNeighborComm(plan);
+		if (shared_memory_plan != nullptr) {
+			setUpNeighborComm(*shared_memory_plan);
+		}
+		for (MessagePlan &corner_plan : corner_plans) {
+			setUpNeighborComm(corner_plan);
+		}
+	}
+	/**
+	 * @brief Check if the ghost cells are exchanged with neighbor collectives
+	 */
+	bool getUseNeighborCollectives() const
+	{
+		return use_neighbor_collectives;
+	}
+	/**
+	 * @brief Send the ghost values to other ranks as floats instead of doubles
+	 *
+	 * This halves the size of the messages. The ghost values from other ranks are rounded to
+	 * single precision, which is enough when the filler is used in a preconditioner. The ghost
+	 * values of neighbors on the same rank, or read from shared memory, are not rounded.
+	 *
+	 * This has to be set to the same value on every rank.
+	 *
+	 * @param use_float_messages true to send floats
+	 */
+	void setUseFloatMessages(bool use_float_messages)
+	{
+		if (exchange_in_progress != nullptr) {
+			throw RuntimeError("MPIGhostFiller can not change modes while a fill is in progress");
+		}
+		this->use_float_messages = use_float_messages;
+		plan.exchanges.clear();
+		if (shared_memory_plan != nullptr) {
+			shared_memory_plan->exchanges.clear();
+		}
+		for (MessagePlan &corner_plan : corner_plans) {
+			corner_plan.exchanges.clear();
+		}
+	}
+	/**
+	 * @brief Check if the ghost values are sent to other ranks as floats
+	 */
+	bool getUseFloatMessages() const
+	{
+		return use_float_messages;
+	}
+	/**
+	 * @brief Check if the ghost cells of normal neighbors are copies of the values of the neighbor
+	 *
+	 * If this is true, fillGhostCellsForNbrPatch is not called for normal neighbors. Instead the
+	 * ghost cells are overwritten with copies, using a plan that is built once for each patch
+	 * layout, and they are not set to zero before the fill. Every layer of ghost cells is copied.
+	 *
+	 * This can only be true if fillGhostCellsForLocalPatch does not change the ghost cells on
+	 * sides with normal neighbors.
+	 *
+	 * @return false by default
+	 */
+	virtual bool copiesNormalNbrGhosts() const
+	{
+		return false;
+	}
 	/**
 	 * @brief Fill the ghost cells for the neighboring patch
 	 *
@@ -365,8 +1493,8 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 	 * @param orthant the orthant that the neighbors ghost cells lie on
 	 */
 	virtual void fillGhostCellsForNbrPatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                                       const std::vector<LocalData<D>> &   local_datas,
-	                                       const std::vector<LocalData<D>> &   nbr_datas,
+	                                       const PatchView<D> &                local_datas,
+	                                       const PatchView<D> &                nbr_datas,
 	                                       const Side<D> side, const NbrType nbr_type,
 	                                       const Orthant<D> orthant) const = 0;
 
@@ -379,9 +1507,22 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 	 * @param pinfo the patch
 	 * @param local_datas the LocalData for the patch
 	 */
-	virtual void
-	fillGhostCellsForLocalPatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                            const std::vector<LocalData<D>> &   local_datas) const = 0;
+	virtual void fillGhostCellsForLocalPatch(std::shared_ptr<const PatchInfo<D>> pinfo,
+	                                         const PatchView<D> &local_datas) const = 0;
+	/**
+	 * @brief Check if fillGhostCellsForNbrPatch and fillGhostCellsForLocalPatch can be called
+	 * concurrently
+	 *
+	 * The ghost cells from patches on this rank are filled by several threads when this is true.
+	 * The concurrent calls always fill the ghost cells of different patches. Override this to
+	 * return false if the calls modify state that is shared between patches.
+	 *
+	 * @return true if the calls are thread safe
+	 */
+	virtual bool isThreadSafe() const
+	{
+		return true;
+	}
 
 	/**
 	 * @brief Fill ghost cells on a vector
@@ -390,55 +1531,151 @@ template <int D> class MPIGhostFiller : public GhostFiller<D>
 	 */
 	void fillGhost(std::shared_ptr<const Vector<D>> u) const
 	{
-		// zero out ghost cells
-		for (auto pinfo : domain->getPatchInfoVector()) {
-			for (auto &this_patch : u->getLocalDatas(pinfo->local_index)) {
-				for (Side<D> s : Side<D>::getValues()) {
-					if (pinfo->hasNbr(s)) {
-						for (int i = 0; i < pinfo->num_ghost_cells; i++) {
-							auto this_ghost = this_patch.getGhostSliceOnSide(s, i + 1);
-							nested_loop<D - 1>(
-							this_ghost.getStart(), this_ghost.getEnd(),
-							[&](const std::array<int, D - 1> &coord) { this_ghost[coord] = 0; });
-						}
-					}
-				}
+		fillGhostStart(u);
+		fillGhostFinish(u);
+	}
+	/**
+	 * @brief Fill ghost cells on several vectors with a single exchange
+	 *
+	 * The values for all of the vectors are packed into one message for each neighboring rank.
+	 *
+	 * @param us  the vectors
+	 */
+	void fillGhost(const std::vector<std::shared_ptr<const Vector<D>>> &us) const
+	{
+		fillGhostStart(us);
+		fillGhostFinish(us);
+	}
+	/**
+	 * @brief Start filling ghost cells on a vector
+	 *
+	 * This posts the recvs and sends, and fills the ghost cells that come from patches on this
+	 * rank. Only one fill can be in progress at a time.
+	 *
+	 * @param u  the vector
+	 */
+	void fillGhostStart(std::shared_ptr<const Vector<D>> u) const
+	{
+		fillGhostStart(std::vector<std::shared_ptr<const Vector<D>>>(1, u));
+	}
+	/**
+	 * @brief Start filling ghost cells on several vectors with a single exchange
+	 *
+	 * @param us  the vectors
+	 */
+	void fillGhostStart(const std::vector<std::shared_ptr<const Vector<D>>> &us) const
+	{
+		if (exchange_in_progress != nullptr) {
+			throw RuntimeError("MPIGhostFiller already has a fill in progress");
+		}
+
+		if (getFillCorners()) {
+			int total_components = 0;
+			for (const auto &u : us) {
+				total_components += u->getNumComponents();
 			}
+			fillCornersStart(us, total_components);
+			return;
 		}
 
-		// allocate recv buffers and post recvs
-		std::vector<std::vector<double>> recv_buffers(recv_buff_lengths.size());
-		for (size_t i = 0; i < recv_buff_lengths.size(); i++) {
-			recv_buffers[i].resize(recv_buff_lengths[i] * u->getNumComponents());
+		// zero out ghost cells
+		int total_components = 0;
+		for (const auto &u : us) {
+			zeroGhosts(u);
+			total_components += u->getNumComponents();
 		}
-		std::vector<MPI_Request> recv_requests = postRecvs(recv_buffers);
 
-		// allocate send buffers
-		std::vector<std::vector<double>> out_buffers(send_buff_lengths.size());
-		for (size_t i = 0; i < send_buff_lengths.size(); i++) {
-			out_buffers[i].resize(send_buff_lengths[i] * u->getNumComponents());
+		// post recvs and sends
+		bool               use_shared_memory = canUseSharedMemory(us);
+		const MessagePlan &fill_plan         = use_shared_memory ? *shared_memory_plan : plan;
+		Exchange &         exchange          = getExchange(fill_plan, total_components);
+		postRecvs(exchange);
+		postSends(fill_plan, exchange, us);
+
+		// perform local operations, each patch fills its own ghost cells so the patches can be
+		// done concurrently
+		std::vector<const CopyPlan *> vector_copy_plans;
+		for (const auto &u : us) {
+			vector_copy_plans.push_back(getCopyPlan(*u));
 		}
-		std::vector<MPI_Request> send_requests = postSends(out_buffers, u);
+		Threading::ParallelFor(
+		domain->getNumLocalPatches(),
+		[&](int i) {
+			for (size_t v = 0; v < us.size(); v++) {
+				const auto &    u         = us[v];
+				const CopyPlan *copy_plan = vector_copy_plans[v];
+				auto            pinfo     = domain->getPatchInfoVector()[i];
+				auto            datas     = u->getLocalDatas(pinfo->local_index);
+				fillGhostCellsForLocalPatch(pinfo, datas);
+				for (const LocalCall &call : local_calls[pinfo->local_index]) {
+					auto nbr_pinfo   = std::get<0>(call);
+					auto side        = std::get<1>(call);
+					auto nbr_type    = std::get<2>(call);
+					auto orthant     = std::get<3>(call);
+					auto local_datas = u->getLocalDatas(std::get<4>(call));
+					if (copy_plan != nullptr && nbr_type == NbrType::Normal) {
+						CopyNormalNbrGhosts(copy_plan->local_copies[side.opposite().getIndex()],
+						                    local_datas, datas);
+					} else {
+						fillGhostCellsForNbrPatch(nbr_pinfo, local_datas, datas, side, nbr_type,
+						                          orthant);
+					}
+				}
+			}
+		},
+		canFillLocalGhostsInParallel(us));
 
-		// perform local operations
-		for (auto pinfo : domain->getPatchInfoVector()) {
-			auto datas = u->getLocalDatas(pinfo->local_index);
-			fillGhostCellsForLocalPatch(pinfo, datas);
+		if (use_shared_memory) {
+			fillSharedGhosts(us);
 		}
-		for (const LocalCall &call : local_calls) {
-			auto pinfo       = std::get<0>(call);
-			auto side        = std::get<1>(call);
-			auto nbr_type    = std::get<2>(call);
-			auto orthant     = std::get<3>(call);
-			auto local_datas = u->getLocalDatas(std::get<4>(call));
-			auto nbr_datas   = u->getLocalDatas(std::get<5>(call));
-			fillGhostCellsForNbrPatch(pinfo, local_datas, nbr_datas, side, nbr_type, orthant);
+
+		exchange_in_progress = &exchange;
+		plan_in_progress     = &fill_plan;
+		vectors_in_progress  = us;
+	}
+	/**
+	 * @brief Finish filling ghost cells on a vector
+	 *
+	 * This adds the ghost cells that come from other ranks as they arrive.
+	 *
+	 * @param u  the vector that was passed to fillGhostStart
+	 */
+	void fillGhostFinish(std::shared_ptr<const Vector<D>> u) const
+	{
+		fillGhostFinish(std::vector<std::shared_ptr<const Vector<D>>>(1, u));
+	}
+	/**
+	 * @brief Finish filling ghost cells on several vectors
+	 *
+	 * @param us  the vectors that were passed to fillGhostStart
+	 */
+	void fillGhostFinish(const std::vector<std::shared_ptr<const Vector<D>>> &us) const
+	{
+		if (exchange_in_progress == nullptr || vectors_in_progress != us) {
+			throw RuntimeError("MPIGhostFiller does not have a fill in progress for these vectors");
 		}
+		Exchange &         exchange  = *exchange_in_progress;
+		const MessagePlan &fill_plan = *plan_in_progress;
 
-		processRecvs(recv_requests, recv_buffers, u);
+		exchange_in_progress = nullptr;
+		plan_in_progress     = nullptr;
+		vectors_in_progress.clear();
+
+		processRecvs(fill_plan, exchange, us, getFillCorners());
 
 		// wait for sends for finish
-		MPI_Waitall(send_requests.size(), send_requests.data(), MPI_STATUS_IGNORE);
+		MPI_Waitall(exchange.send_requests.size(), exchange.send_requests.data(),
+		            MPI_STATUSES_IGNORE);
+	}
+	/**
+	 * @brief Check if a patch recieves ghost cells from another rank
+	 *
+	 * @param patch_local_index the local index of the patch
+	 * @return true if the ghost cells of the patch are not filled until fillGhostFinish
+	 */
+	bool needsFillGhostFinish(int patch_local_index) const
+	{
+		return patch_needs_finish[patch_local_index];
 	}
 };
 extern template class MPIGhostFiller<1>;
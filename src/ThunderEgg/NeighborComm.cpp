@@ -0,0 +1,71 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include <ThunderEgg/NeighborComm.h>
+namespace ThunderEgg
+{
+NeighborComm::NeighborComm(MPI_Comm parent_comm, const std::vector<int> &sources,
+                           const std::vector<int> &destinations)
+: parent_comm(parent_comm), sources(sources), destinations(destinations)
+{
+	MPI_Dist_graph_create_adjacent(parent_comm, sources.size(), sources.data(), MPI_UNWEIGHTED,
+	                               destinations.size(), destinations.data(), MPI_UNWEIGHTED,
+	                               MPI_INFO_NULL, 0, &comm);
+}
+NeighborComm::~NeighborComm()
+{
+	int finalized;
+	MPI_Finalized(&finalized);
+	if (!finalized) {
+		MPI_Comm_free(&comm);
+	}
+}
+MPI_Comm NeighborComm::getParentComm() const
+{
+	return parent_comm;
+}
+MPI_Comm NeighborComm::getComm() const
+{
+	return comm;
+}
+const std::vector<int> &NeighborComm::getSources() const
+{
+	return sources;
+}
+const std::vector<int> &NeighborComm::getDestinations() const
+{
+	return destinations;
+}
+void NeighborComm::alltoallvStart(const void *send_buffer, const std::vector<int> &send_counts,
+                                  const std::vector<int> &send_displs, void *recv_buffer,
+                                  const std::vector<int> &recv_counts,
+                                  const std::vector<int> &recv_displs, MPI_Datatype type,
+                                  MPI_Request *request) const
+{
+	// some implementations do not accept null arrays when there are no neighbors
+	int empty = 0;
+	MPI_Ineighbor_alltoallv(send_buffer, send_counts.empty() ? &empty : send_counts.data(),
+	                        send_displs.empty() ? &empty : send_displs.data(), type, recv_buffer,
+	                        recv_counts.empty() ? &empty : recv_counts.data(),
+	                        recv_displs.empty() ? &empty : recv_displs.data(), type, comm,
+	                        request);
+}
+} // namespace ThunderEgg
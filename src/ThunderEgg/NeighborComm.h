@@ -0,0 +1,113 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_NEIGHBORCOMM_H
+#define THUNDEREGG_NEIGHBORCOMM_H
+#include <mpi.h>
+#include <vector>
+namespace ThunderEgg
+{
+/**
+ * @brief A distributed graph communicator over the ranks that a rank exchanges messages with
+ *
+ * This wraps the communicator that is created with MPI_Dist_graph_create_adjacent, so that an
+ * exchange with all of the neighboring ranks can be done with a single MPI_Ineighbor_alltoallv,
+ * which lets the MPI implementation coalesce the messages and take the topology into account.
+ * The ranks are not reordered, so the ranks in the communicator are the ranks in the parent
+ * communicator.
+ *
+ * The object can not be copied, share it with a shared_ptr.
+ */
+class NeighborComm
+{
+	private:
+	/**
+	 * @brief the communicator that the graph was created from
+	 */
+	MPI_Comm parent_comm;
+	/**
+	 * @brief the graph communicator
+	 */
+	MPI_Comm comm;
+	/**
+	 * @brief the ranks that messages are recieved from
+	 */
+	std::vector<int> sources;
+	/**
+	 * @brief the ranks that messages are sent to
+	 */
+	std::vector<int> destinations;
+
+	public:
+	/**
+	 * @brief Construct a new NeighborComm object
+	 *
+	 * This is a collective call over parent_comm.
+	 *
+	 * @param parent_comm the communicator to create the graph from
+	 * @param sources the ranks that messages are recieved from, in the order of the recv buffers
+	 * @param destinations the ranks that messages are sent to, in the order of the send buffers
+	 */
+	NeighborComm(MPI_Comm parent_comm, const std::vector<int> &sources,
+	             const std::vector<int> &destinations);
+	NeighborComm(const NeighborComm &) = delete;
+	NeighborComm &operator=(const NeighborComm &) = delete;
+	/**
+	 * @brief Free the communicator
+	 */
+	~NeighborComm();
+	/**
+	 * @brief Get the communicator that the graph was created from
+	 */
+	MPI_Comm getParentComm() const;
+	/**
+	 * @brief Get the graph communicator
+	 */
+	MPI_Comm getComm() const;
+	/**
+	 * @brief Get the ranks that messages are recieved from
+	 */
+	const std::vector<int> &getSources() const;
+	/**
+	 * @brief Get the ranks that messages are sent to
+	 */
+	const std::vector<int> &getDestinations() const;
+	/**
+	 * @brief Start an exchange with all of the neighbors
+	 *
+	 * The counts and displacements are in the order of the destinations and the sources.
+	 *
+	 * @param send_buffer the values to send
+	 * @param send_counts the number of values to send to each destination
+	 * @param send_displs the offset in send_buffer for each destination
+	 * @param recv_buffer the buffer to recieve into
+	 * @param recv_counts the number of values to recieve from each source
+	 * @param recv_displs the offset in recv_buffer for each source
+	 * @param type the type of the values
+	 * @param request the request to wait on
+	 */
+	void alltoallvStart(const void *send_buffer, const std::vector<int> &send_counts,
+	                    const std::vector<int> &send_displs, void *recv_buffer,
+	                    const std::vector<int> &recv_counts, const std::vector<int> &recv_displs,
+	                    MPI_Datatype type, MPI_Request *request) const;
+};
+} // namespace ThunderEgg
+#endif
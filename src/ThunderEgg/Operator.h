@@ -44,6 +44,26 @@ template <int D> class Operator
 	 * @param b the output vector.
 	 */
 	virtual void apply(std::shared_ptr<const Vector<D>> x, std::shared_ptr<Vector<D>> b) const = 0;
+	/**
+	 * @brief Compute the residual r = f - A u
+	 *
+	 * The default implementation calls apply and then subtracts from f. Derived classes can
+	 * override this to compute the residual without the extra pass over r.
+	 *
+	 * @param f the right hand side
+	 * @param u the left hand side
+	 * @param r the residual, can not be the same vector as f or u
+	 * @param compute_norm if true, the two norm of the residual is also computed, which is a
+	 * collective call over the communicator of r
+	 * @return double the two norm of the residual if compute_norm is true, otherwise 0
+	 */
+	virtual double residual(std::shared_ptr<const Vector<D>> f, std::shared_ptr<const Vector<D>> u,
+	                        std::shared_ptr<Vector<D>> r, bool compute_norm = false) const
+	{
+		apply(u, r);
+		r->scaleThenAdd(-1, f);
+		return compute_norm ? r->twoNorm() : 0;
+	}
 };
 } // namespace ThunderEgg
 #endif
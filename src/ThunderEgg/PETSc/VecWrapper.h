@@ -198,6 +198,22 @@ template <int D> class VecWrapper : public Vector<D>
 		               + component_index * component_stride;
 		return LocalData<D>(data, strides, lengths, num_ghost_cells, std::move(ldm));
 	}
+	/**
+	 * @brief getLocalData uses VecGetArray, which is not thread safe
+	 */
+	bool isThreadSafe() const override
+	{
+		return false;
+	}
+	/**
+	 * @brief Get the local size of the Vec in bytes
+	 */
+	size_t getNumLocalBytes() const override
+	{
+		int vec_size;
+		VecGetLocalSize(vec, &vec_size);
+		return vec_size * sizeof(double);
+	}
 	int getNumGhostCells() const
 	{
 		return num_ghost_cells;
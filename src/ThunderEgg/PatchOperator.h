@@ -77,8 +77,8 @@ template <int D> class PatchOperator : public Operator<D>
 	 * not be used
 	 */
 	virtual void applySinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                              const std::vector<LocalData<D>> &   us,
-	                              std::vector<LocalData<D>> &         fs,
+	                              const PatchView<D> &                us,
+	                              PatchView<D> &                      fs,
 	                              bool treat_interior_boundary_as_dirichlet) const = 0;
 	/**
 	 * @brief Treat the internal patch boundaries as an dirichlet boundary condition, and modify the
@@ -91,25 +91,120 @@ template <int D> class PatchOperator : public Operator<D>
 	 * @param fs the right hand side
 	 */
 	virtual void addGhostToRHS(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                           const std::vector<LocalData<D>> &   us,
-	                           std::vector<LocalData<D>> &         fs) const = 0;
+	                           const PatchView<D> &                us,
+	                           PatchView<D> &                      fs) const = 0;
+	/**
+	 * @brief Compute the residual r = f - A u on a single patch
+	 *
+	 * The ghost values in u will be updated to the latest values. The default implementation
+	 * calls applySinglePatch and then subtracts from f while the patch is still in cache. Derived
+	 * classes can override this to compute the residual in the same pass as the stencil.
+	 *
+	 * @param pinfo the patch
+	 * @param fs the right hand side
+	 * @param us the left hand side
+	 * @param rs the residual
+	 */
+	virtual void residualSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
+	                                 const PatchView<D> &fs, const PatchView<D> &us,
+	                                 PatchView<D> &rs) const
+	{
+		applySinglePatch(pinfo, us, rs, false);
+		for (size_t c = 0; c < rs.size(); c++) {
+			cell_loop<D>(
+			rs[c].getStart(), rs[c].getEnd(),
+			[](const double &f_value, double &r_value) { r_value = f_value - r_value; }, fs[c],
+			rs[c]);
+		}
+	}
 
 	/**
 	 * @brief Apply the operator
 	 *
-	 * This will update the ghost values in u, and then will call applySinglePatch for each patch
+	 * This will update the ghost values in u, and then will call applySinglePatch for each patch.
+	 * The patches that do not need ghost values from other ranks are applied while the ghost
+	 * values from other ranks are being communicated.
 	 *
 	 * @param u the left hand side
 	 * @param f the right hand side
 	 */
 	void apply(std::shared_ptr<const Vector<D>> u, std::shared_ptr<Vector<D>> f) const override
 	{
-		ghost_filler->fillGhost(u);
+		ghost_filler->fillGhostStart(u);
 		for (auto pinfo : domain->getPatchInfoVector()) {
-			auto us = u->getLocalDatas(pinfo->local_index);
+			if (!ghost_filler->needsFillGhostFinish(pinfo->local_index)) {
+				auto us = u->getLocalDatas(pinfo->local_index);
+				auto fs = f->getLocalDatas(pinfo->local_index);
+				applySinglePatch(pinfo, us, fs, false);
+			}
+		}
+		ghost_filler->fillGhostFinish(u);
+		for (auto pinfo : domain->getPatchInfoVector()) {
+			if (ghost_filler->needsFillGhostFinish(pinfo->local_index)) {
+				auto us = u->getLocalDatas(pinfo->local_index);
+				auto fs = f->getLocalDatas(pinfo->local_index);
+				applySinglePatch(pinfo, us, fs, false);
+			}
+		}
+	}
+	/**
+	 * @brief Compute the residual r = f - A u
+	 *
+	 * This will update the ghost values in u, and then will call residualSinglePatch for each
+	 * patch, overlapping the communication like apply does. The norm is computed from each patch
+	 * right after its residual, while it is still in cache, so the norm matches r->twoNorm() up to
+	 * rounding.
+	 *
+	 * @param f the right hand side
+	 * @param u the left hand side
+	 * @param r the residual
+	 * @param compute_norm if true, the two norm of the residual is also computed
+	 * @return double the two norm of the residual if compute_norm is true, otherwise 0
+	 */
+	double residual(std::shared_ptr<const Vector<D>> f, std::shared_ptr<const Vector<D>> u,
+	                std::shared_ptr<Vector<D>> r, bool compute_norm = false) const override
+	{
+		std::vector<double> patch_sums(compute_norm ? domain->getNumLocalPatches() : 0);
+
+		auto residual_patch = [&](std::shared_ptr<const PatchInfo<D>> pinfo) {
 			auto fs = f->getLocalDatas(pinfo->local_index);
-			applySinglePatch(pinfo, us, fs, false);
+			auto us = u->getLocalDatas(pinfo->local_index);
+			auto rs = r->getLocalDatas(pinfo->local_index);
+			residualSinglePatch(pinfo, fs, us, rs);
+			if (compute_norm) {
+				double patch_sum = 0;
+				for (const auto &ld : rs) {
+					cell_loop<D>(
+					ld.getStart(), ld.getEnd(),
+					[&](const double &value) { patch_sum += value * value; }, ld);
+				}
+				patch_sums[pinfo->local_index] = patch_sum;
+			}
+		};
+
+		ghost_filler->fillGhostStart(u);
+		for (auto pinfo : domain->getPatchInfoVector()) {
+			if (!ghost_filler->needsFillGhostFinish(pinfo->local_index)) {
+				residual_patch(pinfo);
+			}
+		}
+		ghost_filler->fillGhostFinish(u);
+		for (auto pinfo : domain->getPatchInfoVector()) {
+			if (ghost_filler->needsFillGhostFinish(pinfo->local_index)) {
+				residual_patch(pinfo);
+			}
+		}
+
+		if (!compute_norm) {
+			return 0;
+		}
+		double sum = 0;
+		for (double patch_sum : patch_sums) {
+			sum += patch_sum;
 		}
+		double global_sum;
+		MPI_Allreduce(&sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, r->getMPIComm());
+		return sqrt(global_sum);
 	}
 	/**
 	 * @brief Get the Domain object associated with this PatchOperator
@@ -0,0 +1,136 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_PATCHSIZEDISPATCH_H
+#define THUNDEREGG_PATCHSIZEDISPATCH_H
+#include <ThunderEgg/LocalData.h>
+#include <ThunderEgg/Loops.h>
+#include <array>
+#include <utility>
+namespace ThunderEgg
+{
+/**
+ * @brief Dispatch from the runtime patch size to kernels that are specialized for a fixed size
+ *
+ * Most meshes use patches with 8, 16, 32, or 64 cells in each direction. When the number of cells
+ * is a compile time constant, the compiler can unroll and vectorize the inner loops of a kernel.
+ * Dispatch calls the kernel that matches the patch size, and returns false if there is no match,
+ * so that the caller can fall back to its generic implementation.
+ *
+ * 		if (!PatchSizeDispatch::Dispatch<MyKernel, D>(ns, args...)) {
+ * 			// generic implementation
+ * 		}
+ *
+ * A kernel is a class template `template <int D, int N> struct MyKernel` with a static run
+ * function, where N is the number of cells in each direction of the patch.
+ */
+namespace PatchSizeDispatch
+{
+/**
+ * @brief Set whether the specialized kernels are used. They are enabled by default.
+ *
+ * @param enabled true if the specialized kernels should be used
+ */
+void SetEnabled(bool enabled);
+/**
+ * @brief Check if the specialized kernels are used
+ *
+ * @return true if the specialized kernels are used
+ */
+bool IsEnabled();
+/**
+ * @brief Get the specialized size for a patch
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @param ns the number of cells in each direction of the patch
+ * @return int the size that there is a specialization for, 0 if there is no specialization
+ */
+template <int D> int GetSpecializedSize(const std::array<int, D> &ns)
+{
+	int n = ns[0];
+	for (size_t i = 1; i < D; i++) {
+		if (ns[i] != n) {
+			return 0;
+		}
+	}
+	switch (n) {
+		case 8:
+		case 16:
+		case 32:
+		case 64:
+			return n;
+		default:
+			return 0;
+	}
+}
+/**
+ * @brief Call the kernel specialized for the patch size
+ *
+ * @tparam Kernel the kernel class template
+ * @tparam D the number of Cartesian dimensions
+ * @param ns the number of cells in each direction of the patch
+ * @param args the arguments to pass to the kernel's run function
+ * @return true if a specialized kernel was called
+ * @return false if there was no specialized kernel, or they are disabled
+ */
+template <template <int, int> class Kernel, int D, typename... Args>
+bool Dispatch(const std::array<int, D> &ns, Args &&... args)
+{
+	if (!IsEnabled()) {
+		return false;
+	}
+	switch (GetSpecializedSize<D>(ns)) {
+		case 8:
+			Kernel<D, 8>::run(std::forward<Args>(args)...);
+			return true;
+		case 16:
+			Kernel<D, 16>::run(std::forward<Args>(args)...);
+			return true;
+		case 32:
+			Kernel<D, 32>::run(std::forward<Args>(args)...);
+			return true;
+		case 64:
+			Kernel<D, 64>::run(std::forward<Args>(args)...);
+			return true;
+		default:
+			return false;
+	}
+}
+/**
+ * @brief Loop over the rows of a patch with N cells in each direction
+ *
+ * A row is the set of cells along the first axis.
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @tparam N the number of cells in each direction
+ * @param lambda called with the coordinate of the first cell in each row
+ */
+template <int D, int N, typename T> inline void ForEachRow(T lambda)
+{
+	std::array<int, D> start;
+	std::array<int, D> end;
+	start.fill(0);
+	end.fill(N - 1);
+	row_loop<D>(start, end, lambda);
+}
+} // namespace PatchSizeDispatch
+} // namespace ThunderEgg
+#endif
@@ -47,6 +47,29 @@ template <int D> class PatchSolver : public virtual Operator<D>, public virtual
 	 */
 	std::shared_ptr<const GhostFiller<D>> ghost_filler;
 
+	private:
+	/**
+	 * @brief Solve a single patch as part of smooth
+	 *
+	 * @param pinfo the PatchInfo for the patch
+	 * @param f the rhs vector
+	 * @param u the lhs vector
+	 */
+	void smoothSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
+	                       std::shared_ptr<const Vector<D>>    f,
+	                       std::shared_ptr<Vector<D>>          u) const
+	{
+		if (domain->hasTimer()) {
+			domain->getTimer()->startPatchTiming(pinfo->id, domain->getId(), "Single Patch Solve");
+		}
+		auto fs = f->getLocalDatas(pinfo->local_index);
+		auto us = u->getLocalDatas(pinfo->local_index);
+		solveSinglePatch(pinfo, fs, us);
+		if (domain->hasTimer()) {
+			domain->getTimer()->stopPatchTiming(pinfo->id, domain->getId(), "Single Patch Solve");
+		}
+	}
+
 	public:
 	/**
 	 * @brief Construct a new PatchSolver object
@@ -91,8 +114,8 @@ template <int D> class PatchSolver : public virtual Operator<D>, public virtual
 	 * @param fs the right hand side
 	 */
 	virtual void solveSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                              const std::vector<LocalData<D>> &   fs,
-	                              std::vector<LocalData<D>> &         us) const = 0;
+	                              const PatchView<D> &                fs,
+	                              PatchView<D> &                      us) const = 0;
 	/**
 	 * @brief Solve all the patches in the domain, assuming zero boundary conditions for the patches
 	 *
@@ -124,6 +147,9 @@ template <int D> class PatchSolver : public virtual Operator<D>, public virtual
 	/**
 	 * @brief Solve all the patches in the domain, using the values in u for the boundary conditions
 	 *
+	 * The patches that do not need ghost values from other ranks are solved while the ghost values
+	 * from other ranks are being communicated.
+	 *
 	 * @param f the rhs vector
 	 * @param u the lhs vector
 	 */
@@ -133,18 +159,16 @@ template <int D> class PatchSolver : public virtual Operator<D>, public virtual
 		if (domain->hasTimer()) {
 			domain->getTimer()->startDomainTiming(domain->getId(), "Total Patch Smooth");
 		}
-		ghost_filler->fillGhost(u);
+		ghost_filler->fillGhostStart(u);
 		for (std::shared_ptr<const PatchInfo<D>> pinfo : domain->getPatchInfoVector()) {
-			if (domain->hasTimer()) {
-				domain->getTimer()->startPatchTiming(pinfo->id, domain->getId(),
-				                                     "Single Patch Solve");
+			if (!ghost_filler->needsFillGhostFinish(pinfo->local_index)) {
+				smoothSinglePatch(pinfo, f, u);
 			}
-			auto fs = f->getLocalDatas(pinfo->local_index);
-			auto us = u->getLocalDatas(pinfo->local_index);
-			solveSinglePatch(pinfo, fs, us);
-			if (domain->hasTimer()) {
-				domain->getTimer()->stopPatchTiming(pinfo->id, domain->getId(),
-				                                    "Single Patch Solve");
+		}
+		ghost_filler->fillGhostFinish(u);
+		for (std::shared_ptr<const PatchInfo<D>> pinfo : domain->getPatchInfoVector()) {
+			if (ghost_filler->needsFillGhostFinish(pinfo->local_index)) {
+				smoothSinglePatch(pinfo, f, u);
 			}
 		}
 		if (domain->hasTimer()) {
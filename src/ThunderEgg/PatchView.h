@@ -0,0 +1,146 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_PATCHVIEW_H
+#define THUNDEREGG_PATCHVIEW_H
+#include <ThunderEgg/LocalData.h>
+#include <array>
+#include <initializer_list>
+#include <vector>
+namespace ThunderEgg
+{
+/**
+ * @brief The LocalData objects for each component of a patch
+ *
+ * This is a replacement for std::vector<LocalData<D>> that does not allocate memory when the
+ * number of components is small. Up to InlineCapacity LocalData objects are stored in the object
+ * itself, larger sets fall back to a std::vector.
+ *
+ * Like LocalData, this is a view into the vector's memory. The LocalData objects are moved in, so
+ * creating a PatchView does not touch the LocalDataManager reference counts.
+ *
+ * @tparam D the number of Cartesian dimensions
+ */
+template <int D> class PatchView
+{
+	public:
+	/**
+	 * @brief The number of LocalData objects that can be stored without allocating memory
+	 */
+	static const int InlineCapacity = 4;
+
+	private:
+	/**
+	 * @brief the number of components
+	 */
+	int num_components = 0;
+	/**
+	 * @brief storage used when num_components <= InlineCapacity
+	 */
+	std::array<LocalData<D>, InlineCapacity> inline_datas;
+	/**
+	 * @brief storage used when num_components > InlineCapacity
+	 */
+	std::vector<LocalData<D>> heap_datas;
+
+	public:
+	/**
+	 * @brief Construct a new empty PatchView object
+	 */
+	PatchView() {}
+	/**
+	 * @brief Construct a new PatchView object with default constructed LocalData objects
+	 *
+	 * @param num_components the number of components
+	 */
+	explicit PatchView(int num_components) : num_components(num_components)
+	{
+		if (num_components > InlineCapacity) {
+			heap_datas.resize(num_components);
+		}
+	}
+	/**
+	 * @brief Construct a new PatchView object from a list of LocalData objects
+	 *
+	 * @param local_datas the LocalData objects, the index corresponds to the component index
+	 */
+	PatchView(std::initializer_list<LocalData<D>> local_datas) : PatchView(local_datas.size())
+	{
+		std::copy(local_datas.begin(), local_datas.end(), begin());
+	}
+	/**
+	 * @brief Get the number of components
+	 */
+	size_t size() const
+	{
+		return num_components;
+	}
+	/**
+	 * @brief Get a pointer to the first LocalData object
+	 */
+	LocalData<D> *data()
+	{
+		return num_components > InlineCapacity ? heap_datas.data() : inline_datas.data();
+	}
+	/**
+	 * @brief Get a pointer to the first LocalData object
+	 */
+	const LocalData<D> *data() const
+	{
+		return num_components > InlineCapacity ? heap_datas.data() : inline_datas.data();
+	}
+	/**
+	 * @brief Get the LocalData object for a component
+	 *
+	 * @param component_index the index of the component
+	 */
+	LocalData<D> &operator[](size_t component_index)
+	{
+		return data()[component_index];
+	}
+	/**
+	 * @brief Get the LocalData object for a component
+	 *
+	 * @param component_index the index of the component
+	 */
+	const LocalData<D> &operator[](size_t component_index) const
+	{
+		return data()[component_index];
+	}
+	LocalData<D> *begin()
+	{
+		return data();
+	}
+	LocalData<D> *end()
+	{
+		return data() + num_components;
+	}
+	const LocalData<D> *begin() const
+	{
+		return data();
+	}
+	const LocalData<D> *end() const
+	{
+		return data() + num_components;
+	}
+};
+} // namespace ThunderEgg
+#endif
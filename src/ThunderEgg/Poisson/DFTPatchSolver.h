@@ -389,8 +389,8 @@ template <int D> class DFTPatchSolver : public PatchSolver<D>
 		}
 	}
 	void solveSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                      const std::vector<LocalData<D>> &   fs,
-	                      std::vector<LocalData<D>> &         us) const override
+	                      const PatchView<D> &                fs,
+	                      PatchView<D> &                      us) const override
 	{
 		LocalData<D> f_copy_ld = f_copy->getLocalData(0, 0);
 		LocalData<D> tmp_ld    = tmp->getLocalData(0, 0);
@@ -398,7 +398,7 @@ template <int D> class DFTPatchSolver : public PatchSolver<D>
 		nested_loop<D>(f_copy_ld.getStart(), f_copy_ld.getEnd(),
 		               [&](std::array<int, D> coord) { f_copy_ld[coord] = fs[0][coord]; });
 
-		std::vector<LocalData<D>> f_copy_lds = {f_copy_ld};
+		PatchView<D> f_copy_lds = {f_copy_ld};
 		op->addGhostToRHS(pinfo, us, f_copy_lds);
 
 		executePlan(plan1.at(pinfo), f_copy_ld, tmp_ld);
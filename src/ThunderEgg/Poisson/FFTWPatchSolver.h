@@ -212,15 +212,15 @@ template <int D> class FFTWPatchSolver : public PatchSolver<D>
 		}
 	}
 	void solveSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                      const std::vector<LocalData<D>> &   fs,
-	                      std::vector<LocalData<D>> &         us) const override
+	                      const PatchView<D> &                fs,
+	                      PatchView<D> &                      us) const override
 	{
 		LocalData<D> f_copy_ld = f_copy->getLocalData(0, 0);
 
 		nested_loop<D>(f_copy_ld.getStart(), f_copy_ld.getEnd(),
 		               [&](std::array<int, D> coord) { f_copy_ld[coord] = fs[0][coord]; });
 
-		std::vector<LocalData<D>> f_copy_lds = {f_copy_ld};
+		PatchView<D> f_copy_lds = {f_copy_ld};
 		op->addGhostToRHS(pinfo, us, f_copy_lds);
 
 		fftw_execute(plan1.at(pinfo));
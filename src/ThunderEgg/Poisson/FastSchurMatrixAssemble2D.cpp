@@ -185,7 +185,7 @@ std::shared_ptr<const PatchInfo<2>> pinfo, std::vector<double> &block)
 	auto new_pinfo                    = make_shared<PatchInfo<2>>(*pinfo);
 	new_pinfo->nbr_info[0]            = nullptr;
 	new_pinfo->nbr_info[s.getIndex()] = make_shared<FineNbrInfo<2>>();
-	std::vector<LocalData<2>> us      = {u};
+	PatchView<2> us                   = {u};
 	ghost_filler->fillGhostCellsForLocalPatch(new_pinfo, us);
 	auto slice       = u.getSliceOnSide(s);
 	auto ghost_slice = u.getGhostSliceOnSide(s, 1);
@@ -214,7 +214,7 @@ void FillBlockColumnForFineToFineInterface(int j, const LocalData<2> &u, Side<2>
 	auto new_pinfo                    = make_shared<PatchInfo<2>>(*pinfo);
 	new_pinfo->nbr_info[0]            = nullptr;
 	new_pinfo->nbr_info[s.getIndex()] = make_shared<CoarseNbrInfo<2>>(100, type.getOrthant());
-	std::vector<LocalData<2>> us      = {u};
+	PatchView<2> us                   = {u};
 	ghost_filler->fillGhostCellsForLocalPatch(new_pinfo, us);
 	auto slice       = u.getSliceOnSide(s);
 	auto ghost_slice = u.getGhostSliceOnSide(s, 1);
@@ -243,10 +243,9 @@ void FillBlockColumnForCoarseToFineInterface(int j, const LocalData<2> &u, Side<
 	auto new_pinfo                    = make_shared<PatchInfo<2>>(*pinfo);
 	new_pinfo->nbr_info[0]            = nullptr;
 	new_pinfo->nbr_info[s.getIndex()] = make_shared<FineNbrInfo<2>>();
-	vector<double>            ghosts(n);
-	std::vector<LocalData<2>> us = {u};
-	std::vector<LocalData<2>> nbr_datas
-	= {getLocalDataForBuffer(ghosts.data(), pinfo, s.opposite())};
+	vector<double> ghosts(n);
+	PatchView<2>   us        = {u};
+	PatchView<2>   nbr_datas = {getLocalDataForBuffer(ghosts.data(), pinfo, s.opposite())};
 	ghost_filler->fillGhostCellsForNbrPatch(
 	new_pinfo, us, nbr_datas, s, NbrType::Fine,
 	Orthant<2>::getValuesOnSide(s)[type.getOrthant().getIndex()]);
@@ -274,10 +273,9 @@ void FillBlockColumnForFineToCoarseInterface(int j, const LocalData<2> &u, Side<
 	auto new_pinfo                    = make_shared<PatchInfo<2>>(*pinfo);
 	new_pinfo->nbr_info[0]            = nullptr;
 	new_pinfo->nbr_info[s.getIndex()] = make_shared<CoarseNbrInfo<2>>(100, type.getOrthant());
-	vector<double>            ghosts(n);
-	std::vector<LocalData<2>> us = {u};
-	std::vector<LocalData<2>> nbr_datas
-	= {getLocalDataForBuffer(ghosts.data(), pinfo, s.opposite())};
+	vector<double> ghosts(n);
+	PatchView<2>   us        = {u};
+	PatchView<2>   nbr_datas = {getLocalDataForBuffer(ghosts.data(), pinfo, s.opposite())};
 	ghost_filler->fillGhostCellsForNbrPatch(
 	new_pinfo, us, nbr_datas, s, NbrType::Coarse,
 	Orthant<2>::getValuesOnSide(s.opposite())[type.getOrthant().getIndex()]);
@@ -239,7 +239,7 @@ std::shared_ptr<const PatchInfo<3>> pinfo, std::vector<double> &block)
 	auto new_pinfo                    = make_shared<PatchInfo<3>>(*pinfo);
 	new_pinfo->nbr_info[0]            = nullptr;
 	new_pinfo->nbr_info[s.getIndex()] = make_shared<FineNbrInfo<3>>();
-	std::vector<LocalData<3>> us      = {u};
+	PatchView<3> us                   = {u};
 	ghost_filler->fillGhostCellsForLocalPatch(new_pinfo, us);
 	auto slice       = u.getSliceOnSide(s);
 	auto ghost_slice = u.getGhostSliceOnSide(s, 1);
@@ -270,7 +270,7 @@ void FillBlockColumnForFineToFineInterface(int j, const LocalData<3> &u, Side<3>
 	auto new_pinfo                    = make_shared<PatchInfo<3>>(*pinfo);
 	new_pinfo->nbr_info[0]            = nullptr;
 	new_pinfo->nbr_info[s.getIndex()] = make_shared<CoarseNbrInfo<3>>(100, type.getOrthant());
-	std::vector<LocalData<3>> us      = {u};
+	PatchView<3> us                   = {u};
 	ghost_filler->fillGhostCellsForLocalPatch(new_pinfo, us);
 	auto slice       = u.getSliceOnSide(s);
 	auto ghost_slice = u.getGhostSliceOnSide(s, 1);
@@ -301,10 +301,9 @@ void FillBlockColumnForCoarseToFineInterface(int j, const LocalData<3> &u, Side<
 	auto new_pinfo                    = make_shared<PatchInfo<3>>(*pinfo);
 	new_pinfo->nbr_info[0]            = nullptr;
 	new_pinfo->nbr_info[s.getIndex()] = make_shared<FineNbrInfo<3>>();
-	vector<double>            ghosts(n * n);
-	std::vector<LocalData<3>> us = {u};
-	std::vector<LocalData<3>> nbr_datas
-	= {getLocalDataForBuffer(ghosts.data(), pinfo, s.opposite())};
+	vector<double> ghosts(n * n);
+	PatchView<3>   us        = {u};
+	PatchView<3>   nbr_datas = {getLocalDataForBuffer(ghosts.data(), pinfo, s.opposite())};
 	ghost_filler->fillGhostCellsForNbrPatch(
 	new_pinfo, us, nbr_datas, s, NbrType::Fine,
 	Orthant<3>::getValuesOnSide(s)[type.getOrthant().getIndex()]);
@@ -334,10 +333,9 @@ void FillBlockColumnForFineToCoarseInterface(int j, const LocalData<3> &u, Side<
 	auto new_pinfo                    = make_shared<PatchInfo<3>>(*pinfo);
 	new_pinfo->nbr_info[0]            = nullptr;
 	new_pinfo->nbr_info[s.getIndex()] = make_shared<CoarseNbrInfo<3>>(100, type.getOrthant());
-	vector<double>            ghosts(n * n);
-	std::vector<LocalData<3>> us = {u};
-	std::vector<LocalData<3>> nbr_datas
-	= {getLocalDataForBuffer(ghosts.data(), pinfo, s.opposite())};
+	vector<double> ghosts(n * n);
+	PatchView<3>   us        = {u};
+	PatchView<3>   nbr_datas = {getLocalDataForBuffer(ghosts.data(), pinfo, s.opposite())};
 	ghost_filler->fillGhostCellsForNbrPatch(
 	new_pinfo, us, nbr_datas, s, NbrType::Coarse,
 	Orthant<3>::getValuesOnSide(s.opposite())[type.getOrthant().getIndex()]);
@@ -0,0 +1,288 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_POISSON_STARJACOBISMOOTHER_H
+#define THUNDEREGG_POISSON_STARJACOBISMOOTHER_H
+
+#include <ThunderEgg/GMG/Smoother.h>
+#include <ThunderEgg/Loops.h>
+#include <ThunderEgg/MPIGhostFiller.h>
+#include <ThunderEgg/Poisson/StarPatchOperator.h>
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/Tiling.h>
+
+namespace ThunderEgg
+{
+namespace Poisson
+{
+/**
+ * @brief Weighted Jacobi smoother for the 2nd order laplacian of StarPatchOperator
+ *
+ * With k layers of ghost cells, the ghost cells are exchanged once for every k sweeps. The first
+ * sweep after an exchange updates the cells of the patch and the k-1 nearest layers of ghost
+ * cells, and each following sweep updates one less layer, so that the last sweep only updates the
+ * cells of the patch. This does redundant work on the ghost cells, but takes k times fewer
+ * exchanges, which helps on coarse levels where the exchanges are bound by latency.
+ *
+ * The edge and corner regions of the ghost cells are needed, so with more than one layer of ghost
+ * cells the ghost filler has to fill the corners (see MPIGhostFiller::setFillCorners). The domain
+ * has to be uniformly refined and rectangular.
+ *
+ * @tparam D the number of Cartesian dimensions
+ */
+template <int D> class StarJacobiSmoother : public GMG::Smoother<D>
+{
+	private:
+	/**
+	 * @brief The domain that the smoother is associated with
+	 */
+	std::shared_ptr<const Domain<D>> domain;
+	/**
+	 * @brief The ghost filler
+	 */
+	std::shared_ptr<const MPIGhostFiller<D>> ghost_filler;
+	/**
+	 * @brief The number of sweeps in each call to smooth
+	 */
+	int num_sweeps;
+	/**
+	 * @brief The weight of the Jacobi update
+	 */
+	double omega;
+	/**
+	 * @brief Whether or not to use Neumann boundary conditions
+	 */
+	bool neumann;
+	/**
+	 * @brief The tile sizes of the residual, see tiled_row_loop
+	 */
+	std::array<int, D> tile_sizes;
+	/**
+	 * @brief Get the box of cells that are updated by a sweep
+	 *
+	 * @param pinfo the patch
+	 * @param extension the number of ghost layers to update on sides with neighbors
+	 * @param start the first cell of the box
+	 * @param end the last cell of the box
+	 */
+	void getRegion(const PatchInfo<D> &pinfo, int extension, std::array<int, D> &start,
+	               std::array<int, D> &end) const
+	{
+		for (size_t axis = 0; axis < D; axis++) {
+			bool lower_nbr = pinfo.hasNbr(Side<D>::LowerSideOnAxis(axis));
+			bool upper_nbr = pinfo.hasNbr(Side<D>::HigherSideOnAxis(axis));
+			start[axis]    = lower_nbr ? -extension : 0;
+			end[axis]      = pinfo.ns[axis] - 1 + (upper_nbr ? extension : 0);
+		}
+	}
+	/**
+	 * @brief Set the first layer of ghost cells on the physical boundaries next to a box of cells
+	 *
+	 * @param pinfo the patch
+	 * @param u the solution on the patch
+	 * @param start the first cell of the box
+	 * @param end the last cell of the box
+	 */
+	void setBoundaryGhosts(const PatchInfo<D> &pinfo, LocalData<D> &u,
+	                       const std::array<int, D> &start, const std::array<int, D> &end) const
+	{
+		double sign = neumann ? 1 : -1;
+		for (Side<D> s : Side<D>::getValues()) {
+			if (!pinfo.hasNbr(s)) {
+				size_t             axis       = s.getAxisIndex();
+				std::array<int, D> side_start = start;
+				std::array<int, D> side_end   = end;
+				side_start[axis]              = s.isLowerOnAxis() ? 0 : pinfo.ns[axis] - 1;
+				side_end[axis]                = side_start[axis];
+
+				int ghost_offset = s.isLowerOnAxis() ? -u.getStrides()[axis] : u.getStrides()[axis];
+				nested_loop<D>(side_start, side_end, [&](const std::array<int, D> &coord) {
+					double *ptr       = u.getPtr(coord);
+					ptr[ghost_offset] = sign * ptr[0];
+				});
+			}
+		}
+	}
+	/**
+	 * @brief Do a weighted Jacobi sweep over a box of cells
+	 *
+	 * The residual of the whole box is computed before u is updated.
+	 *
+	 * @param pinfo the patch
+	 * @param f the RHS on the patch
+	 * @param u the solution on the patch
+	 * @param r scratch space for the residual, with the same shape as u
+	 * @param start the first cell of the box
+	 * @param end the last cell of the box
+	 */
+	void sweep(const PatchInfo<D> &pinfo, const LocalData<D> &f, LocalData<D> &u,
+	           LocalData<D> &r, const std::array<int, D> &start,
+	           const std::array<int, D> &end) const
+	{
+		std::array<double, D> h2;
+		double                diag = 0;
+		for (size_t axis = 0; axis < D; axis++) {
+			h2[axis] = pinfo.spacings[axis] * pinfo.spacings[axis];
+			diag -= 2 / h2[axis];
+		}
+
+		if (is_tiled<D>(tile_sizes) && rows_are_contiguous(f, u, r)) {
+			std::array<int, D> strides = u.getStrides();
+			tiled_nested_row_loop<D>(
+			start, end, tile_sizes,
+			[&](int n, const double *f_row, const double *u_row, double *r_row) {
+				for (int i = 0; i < n; i++) {
+					r_row[i] = f_row[i] - StarStencil<D>(u_row + i, strides, h2);
+				}
+			},
+			f, u, r);
+		} else if (rows_are_contiguous(f, u, r)) {
+			nested_row_loop<D>(
+			start, end,
+			[&](int n, const double *f_row, const double *u_row, double *r_row) {
+				for (int i = 0; i < n; i++) {
+					r_row[i] = f_row[i] - (u_row[i + 1] - 2 * u_row[i] + u_row[i - 1]) / h2[0];
+				}
+			},
+			f, u, r);
+			for (int axis = 1; axis < D; axis++) {
+				int stride = u.getStrides()[axis];
+				nested_row_loop<D>(
+				start, end,
+				[&](int n, const double *u_row, double *r_row) {
+					for (int i = 0; i < n; i++) {
+						r_row[i]
+						-= (u_row[i + stride] - 2 * u_row[i] + u_row[i - stride]) / h2[axis];
+					}
+				},
+				u, r);
+			}
+		} else {
+			nested_loop<D>(start, end, [&](const std::array<int, D> &coord) {
+				const double *ptr      = u.getPtr(coord);
+				double        residual = f[coord];
+				for (size_t axis = 0; axis < D; axis++) {
+					int stride = u.getStrides()[axis];
+					residual -= (ptr[stride] - 2 * ptr[0] + ptr[-stride]) / h2[axis];
+				}
+				r[coord] = residual;
+			});
+		}
+
+		double scale = omega / diag;
+		cell_loop<D>(
+		start, end, [&](double &u_val, const double &r_val) { u_val += scale * r_val; }, u, r);
+	}
+
+	public:
+	/**
+	 * @brief Construct a new StarJacobiSmoother object
+	 *
+	 * @param domain the domain that the smoother is associated with
+	 * @param ghost_filler the ghost filler, it has to fill the corners if there is more than one
+	 * layer of ghost cells
+	 * @param num_sweeps the number of sweeps in each call to smooth
+	 * @param omega the weight of the Jacobi update
+	 * @param neumann whether or not to use Neumann boundary conditions
+	 */
+	StarJacobiSmoother(std::shared_ptr<const Domain<D>>         domain,
+	                   std::shared_ptr<const MPIGhostFiller<D>> ghost_filler,
+	                   int num_sweeps = 1, double omega = 2.0 / 3.0, bool neumann = false)
+	: domain(domain), ghost_filler(ghost_filler), num_sweeps(num_sweeps), omega(omega),
+	  neumann(neumann)
+	{
+		if (domain->getNumGhostCells() < 1) {
+			throw RuntimeError("StarJacobiSmoother needs at least one set of ghost cells");
+		}
+		if (domain->getNumGhostCells() > 1 && !ghost_filler->getFillCorners()) {
+			throw RuntimeError(
+			"StarJacobiSmoother needs a ghost filler that fills corners with more than one set of "
+			"ghost cells");
+		}
+		// the residual uses three planes of u, and one of f and r
+		tile_sizes = Tiling::ChooseTileSizes<D>(domain->getNs(), domain->getNumGhostCells(), 5);
+	}
+	/**
+	 * @brief Set the tile sizes of the residual
+	 *
+	 * If any of the tile sizes is positive, the residual of each sweep is computed in one pass
+	 * over each tile (see tiled_row_loop), instead of a pass over the patch for each axis. This
+	 * keeps the planes of u in cache on large 3D patches. The default is chosen from the cache
+	 * size with Tiling::ChooseTileSizes, which does not tile patches that fit.
+	 *
+	 * @param tile_sizes the number of cells in a tile on each axis, 0 to not split that axis
+	 */
+	void setTileSizes(const std::array<int, D> &tile_sizes)
+	{
+		this->tile_sizes = tile_sizes;
+	}
+	/**
+	 * @brief Get the tile sizes of the residual
+	 */
+	const std::array<int, D> &getTileSizes() const
+	{
+		return tile_sizes;
+	}
+	void smooth(std::shared_ptr<const Vector<D>> f, std::shared_ptr<Vector<D>> u) const override
+	{
+		int                num_ghost = domain->getNumGhostCells();
+		std::array<int, D> ns        = domain->getNs();
+
+		// scratch space for the residual of a patch, with the same shape as the patches of u
+		std::array<int, D> strides;
+		int                size   = 1;
+		int                offset = 0;
+		for (size_t axis = 0; axis < D; axis++) {
+			strides[axis] = size;
+			offset += num_ghost * size;
+			size *= ns[axis] + 2 * num_ghost;
+		}
+		std::vector<double> r_data(size);
+		LocalData<D>        r(r_data.data() + offset, strides, ns, num_ghost);
+
+		// f only has to be exchanged once
+		std::vector<std::shared_ptr<const Vector<D>>> fill_vectors = {f, u};
+		for (int sweeps_done = 0; sweeps_done < num_sweeps;) {
+			int sweeps_per_fill = std::min(num_ghost, num_sweeps - sweeps_done);
+			ghost_filler->fillGhost(fill_vectors);
+			fill_vectors = {u};
+
+			for (auto pinfo : domain->getPatchInfoVector()) {
+				const LocalData<D> f_ld = f->getLocalData(0, pinfo->local_index);
+				LocalData<D>       u_ld = u->getLocalData(0, pinfo->local_index);
+				for (int i = 0; i < sweeps_per_fill; i++) {
+					std::array<int, D> start;
+					std::array<int, D> end;
+					getRegion(*pinfo, sweeps_per_fill - 1 - i, start, end);
+					setBoundaryGhosts(*pinfo, u_ld, start, end);
+					sweep(*pinfo, f_ld, u_ld, r, start, end);
+				}
+			}
+			sweeps_done += sweeps_per_fill;
+		}
+	}
+};
+extern template class StarJacobiSmoother<2>;
+extern template class StarJacobiSmoother<3>;
+
+} // namespace Poisson
+} // namespace ThunderEgg
+#endif
@@ -19,20 +19,41 @@
  *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
  ***************************************************************************/
 
-#ifndef THUNDEREGG_VARPOISSON_STARPATCHOPERATOR_H
-#define THUNDEREGG_VARPOISSON_STARPATCHOPERATOR_H
+#ifndef THUNDEREGG_POISSON_STARPATCHOPERATOR_H
+#define THUNDEREGG_POISSON_STARPATCHOPERATOR_H
 
 #include <ThunderEgg/DomainTools.h>
 #include <ThunderEgg/GMG/Level.h>
 #include <ThunderEgg/GhostFiller.h>
 #include <ThunderEgg/PatchOperator.h>
 #include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/Tiling.h>
 #include <ThunderEgg/ValVector.h>
 
 namespace ThunderEgg
 {
 namespace Poisson
 {
+/**
+ * @brief The star stencil at a cell, summed over every axis
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @param u pointer to the value of the cell
+ * @param strides the strides of the patch
+ * @param h2 the square of the cell spacings
+ * @return double the value of the stencil
+ */
+template <int D>
+inline double StarStencil(const double *u, const std::array<int, D> &strides,
+                          const std::array<double, D> &h2)
+{
+	double sum = (u[1] - 2 * u[0] + u[-1]) / h2[0];
+	for (int axis = 1; axis < D; axis++) {
+		int stride = strides[axis];
+		sum += (u[stride] - 2 * u[0] + u[-stride]) / h2[axis];
+	}
+	return sum;
+}
 /**
  * @brief Implements 2nd order laplacian operator
  *
@@ -43,38 +64,23 @@ namespace Poisson
 template <int D> class StarPatchOperator : public PatchOperator<D>
 {
 	private:
-	constexpr int addValue(int axis) const
-	{
-		return (axis == 0) ? 0 : 1;
-	}
 	bool neumann;
-
-	public:
 	/**
-	 * @brief Construct a new StarPatchOperator object
+	 * @brief the tile sizes of the stencil, see tiled_row_loop
+	 */
+	std::array<int, D> tile_sizes;
+	/**
+	 * @brief Set the ghost cells of u on the physical boundaries, and on the interior boundaries
+	 * if they are treated as Dirichlet boundaries
 	 *
-	 * @param domain_in the Domain that the operator is associated with
-	 * @param ghost_filler_in the GhostFiller to use before calling applySinglePatch
-	 * @param neumann_in whether or not to use Neumann boundary conditions
+	 * @param pinfo the patch
+	 * @param us the patch that the operator is applied to
+	 * @param treat_interior_boundary_as_dirichlet if true, the ghost cells on the interior
+	 * boundaries are also set
 	 */
-	StarPatchOperator(std::shared_ptr<const Domain<D>>      domain_in,
-	                  std::shared_ptr<const GhostFiller<D>> ghost_filler_in,
-	                  bool                                  neumann_in = false)
-	: PatchOperator<D>(domain_in, ghost_filler_in), neumann(neumann_in)
+	void setBoundaryGhosts(std::shared_ptr<const PatchInfo<D>> pinfo, const PatchView<D> &us,
+	                       bool treat_interior_boundary_as_dirichlet) const
 	{
-		if (this->domain->getNumGhostCells() < 1) {
-			throw RuntimeError("StarPatchOperator needs at least one set of ghost cells");
-		}
-	}
-	void applySinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                      const std::vector<LocalData<D>> &us, std::vector<LocalData<D>> &fs,
-	                      bool treat_interior_boundary_as_dirichlet) const override
-	{
-		std::array<double, D> h2 = pinfo->spacings;
-		for (size_t i = 0; i < D; i++) {
-			h2[i] *= h2[i];
-		}
-
 		loop<0, D - 1>([&](int axis) {
 			Side<D>                lower_side = Side<D>::LowerSideOnAxis(axis);
 			Side<D>                upper_side = Side<D>::HigherSideOnAxis(axis);
@@ -100,19 +106,145 @@ template <int D> class StarPatchOperator : public PatchOperator<D>
 				upper_mid.getStart(), upper_mid.getEnd(),
 				[&](std::array<int, D - 1> coord) { upper[coord] = -upper_mid[coord]; });
 			}
-			int stride = us[0].getStrides()[axis];
-			nested_loop<D>(us[0].getStart(), us[0].getEnd(), [&](std::array<int, D> coord) {
-				const double *ptr   = us[0].getPtr(coord);
-				double        lower = *(ptr - stride);
-				double        mid   = *ptr;
-				double        upper = *(ptr + stride);
-				fs[0][coord] = addValue(axis) * fs[0][coord] + (upper - 2 * mid + lower) / h2[axis];
-			});
 		});
 	}
+
+	public:
+	/**
+	 * @brief Construct a new StarPatchOperator object
+	 *
+	 * @param domain_in the Domain that the operator is associated with
+	 * @param ghost_filler_in the GhostFiller to use before calling applySinglePatch
+	 * @param neumann_in whether or not to use Neumann boundary conditions
+	 */
+	StarPatchOperator(std::shared_ptr<const Domain<D>>      domain_in,
+	                  std::shared_ptr<const GhostFiller<D>> ghost_filler_in,
+	                  bool                                  neumann_in = false)
+	: PatchOperator<D>(domain_in, ghost_filler_in), neumann(neumann_in)
+	{
+		if (this->domain->getNumGhostCells() < 1) {
+			throw RuntimeError("StarPatchOperator needs at least one set of ghost cells");
+		}
+		// the residual uses three planes of u, and one of f and r
+		tile_sizes = Tiling::ChooseTileSizes<D>(this->domain->getNs(),
+		                                        this->domain->getNumGhostCells(), 5);
+	}
+	void applySinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
+	                      const PatchView<D> &us, PatchView<D> &fs,
+	                      bool treat_interior_boundary_as_dirichlet) const override
+	{
+		std::array<double, D> h2 = pinfo->spacings;
+		for (size_t i = 0; i < D; i++) {
+			h2[i] *= h2[i];
+		}
+
+		setBoundaryGhosts(pinfo, us, treat_interior_boundary_as_dirichlet);
+
+		std::array<int, D> strides = us[0].getStrides();
+		if (rows_are_contiguous(us[0], fs[0])) {
+			tiled_nested_row_loop<D>(
+			us[0].getStart(), us[0].getEnd(), tile_sizes,
+			[&](int n, const double *u_row, double *f_row) {
+				for (int i = 0; i < n; i++) {
+					f_row[i] = StarStencil<D>(u_row + i, strides, h2);
+				}
+			},
+			us[0], fs[0]);
+			return;
+		}
+		nested_loop<D>(us[0].getStart(), us[0].getEnd(), [&](const std::array<int, D> &coord) {
+			fs[0][coord] = StarStencil<D>(us[0].getPtr(coord), strides, h2);
+		});
+	}
+	/**
+	 * @brief Compute r = f - A u on a single patch, in one pass over the patch
+	 */
+	void residualSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo, const PatchView<D> &fs,
+	                         const PatchView<D> &us, PatchView<D> &rs) const override
+	{
+		std::array<double, D> h2 = pinfo->spacings;
+		for (size_t i = 0; i < D; i++) {
+			h2[i] *= h2[i];
+		}
+
+		setBoundaryGhosts(pinfo, us, false);
+
+		std::array<int, D> strides = us[0].getStrides();
+		if (rows_are_contiguous(fs[0], us[0], rs[0])) {
+			tiled_nested_row_loop<D>(
+			us[0].getStart(), us[0].getEnd(), tile_sizes,
+			[&](int n, const double *f_row, const double *u_row, double *r_row) {
+				for (int i = 0; i < n; i++) {
+					r_row[i] = f_row[i] - StarStencil<D>(u_row + i, strides, h2);
+				}
+			},
+			fs[0], us[0], rs[0]);
+			return;
+		}
+		nested_loop<D>(us[0].getStart(), us[0].getEnd(), [&](const std::array<int, D> &coord) {
+			rs[0][coord] = fs[0][coord] - StarStencil<D>(us[0].getPtr(coord), strides, h2);
+		});
+	}
+	/**
+	 * @brief Get the inverse of the diagonal of the operator
+	 *
+	 * The ghost cells on the physical boundaries depend on the cells next to them, so they add to
+	 * the diagonal. The ghost cells on the interior boundaries are filled from the neighbors, and
+	 * are treated as independent. This is the preconditioner of GMG::ChebyshevSmoother.
+	 *
+	 * @param inv_diag the inverse of the diagonal, every component is set
+	 */
+	void getInverseDiagonal(std::shared_ptr<Vector<D>> inv_diag) const
+	{
+		for (auto pinfo : this->domain->getPatchInfoVector()) {
+			double diag = 0;
+			for (int axis = 0; axis < D; axis++) {
+				diag -= 2 / (pinfo->spacings[axis] * pinfo->spacings[axis]);
+			}
+			double       boundary_sign = neumann ? 1 : -1;
+			PatchView<D> lds           = inv_diag->getLocalDatas(pinfo->local_index);
+			for (LocalData<D> &ld : lds) {
+				cell_loop<D>(
+				ld.getStart(), ld.getEnd(), [&](double &value) { value = diag; }, ld);
+				for (Side<D> s : Side<D>::getValues()) {
+					if (!pinfo->hasNbr(s)) {
+						double           h2    = pow(pinfo->spacings[s.getAxisIndex()], 2);
+						LocalData<D - 1> inner = ld.getSliceOnSide(s);
+						nested_loop<D - 1>(inner.getStart(), inner.getEnd(),
+						                   [&](const std::array<int, D - 1> &coord) {
+							                   inner[coord] += boundary_sign / h2;
+						                   });
+					}
+				}
+				cell_loop<D>(
+				ld.getStart(), ld.getEnd(), [&](double &value) { value = 1 / value; }, ld);
+			}
+		}
+	}
+	/**
+	 * @brief Set the tile sizes of the stencil and the residual
+	 *
+	 * On large 3D patches, the planes of u that a stencil needs do not fit in cache, so they are
+	 * loaded again for each plane of f. Splitting the patch into tiles (see tiled_row_loop) keeps
+	 * them in cache. The default is chosen from the cache size with Tiling::ChooseTileSizes, which
+	 * does not tile patches that fit. The tile sizes do not change the result.
+	 *
+	 * @param tile_sizes the number of cells in a tile on each axis, 0 to not split that axis
+	 */
+	void setTileSizes(const std::array<int, D> &tile_sizes)
+	{
+		this->tile_sizes = tile_sizes;
+	}
+	/**
+	 * @brief Get the tile sizes of the stencil and the residual
+	 */
+	const std::array<int, D> &getTileSizes() const
+	{
+		return tile_sizes;
+	}
 	void addGhostToRHS(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                   const std::vector<LocalData<D>> &   us,
-	                   std::vector<LocalData<D>> &         fs) const override
+	                   const PatchView<D> &                us,
+	                   PatchView<D> &                      fs) const override
 	{
 		for (Side<D> s : Side<D>::getValues()) {
 			if (pinfo->hasNbr(s)) {
@@ -0,0 +1,201 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_POOLEDVECTORGENERATOR_H
+#define THUNDEREGG_POOLEDVECTORGENERATOR_H
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/VectorGenerator.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+namespace ThunderEgg
+{
+/**
+ * @brief VectorGenerator that recycles the vectors of another VectorGenerator
+ *
+ * Vectors are taken from a free list when one is available, and are returned to the free list when
+ * the last std::shared_ptr to them is released. Since all the vectors of the wrapped generator have
+ * the same shape, each generator has its own free list. Wrap the generator of each level
+ * separately to get a free list per level.
+ *
+ * Recycled vectors are set to zero (including ghost cells) before they are handed out, so they can
+ * be used in place of newly allocated vectors.
+ *
+ * 		auto vg = std::make_shared<PooledVectorGenerator<2>>(
+ * 		std::make_shared<ValVectorGenerator<2>>(domain, 1));
+ *
+ * @tparam D the number of Cartesian dimensions
+ */
+template <int D> class PooledVectorGenerator : public VectorGenerator<D>
+{
+	private:
+	/**
+	 * @brief The free list and statistics, this is shared with the vectors that are handed out
+	 */
+	struct Pool {
+		/**
+		 * @brief vectors that are ready to be handed out
+		 */
+		std::vector<std::shared_ptr<Vector<D>>> free_vectors;
+		/**
+		 * @brief the number of vectors that were taken from the free list
+		 */
+		int num_hits = 0;
+		/**
+		 * @brief the number of vectors that had to be allocated
+		 */
+		int num_misses = 0;
+		/**
+		 * @brief the number of bytes owned by the pool, both in use and free
+		 */
+		size_t num_bytes = 0;
+		/**
+		 * @brief the largest value of num_bytes
+		 */
+		size_t peak_num_bytes = 0;
+	};
+	/**
+	 * @brief Deleter that returns a vector to the pool instead of deleting it
+	 */
+	class ReturnToPool
+	{
+		private:
+		/**
+		 * @brief the pool, the vector is deleted if the pool no longer exists
+		 */
+		std::weak_ptr<Pool> pool;
+		/**
+		 * @brief the owning pointer to the vector
+		 */
+		std::shared_ptr<Vector<D>> vec;
+
+		public:
+		/**
+		 * @brief Construct a new ReturnToPool object
+		 *
+		 * @param pool the pool
+		 * @param vec the owning pointer to the vector
+		 */
+		ReturnToPool(std::weak_ptr<Pool> pool, std::shared_ptr<Vector<D>> vec)
+		: pool(pool), vec(vec)
+		{
+		}
+		void operator()(Vector<D> *)
+		{
+			std::shared_ptr<Pool> locked_pool = pool.lock();
+			if (locked_pool != nullptr) {
+				locked_pool->free_vectors.push_back(vec);
+			}
+			vec = nullptr;
+		}
+	};
+	/**
+	 * @brief the generator that vectors are allocated with
+	 */
+	std::shared_ptr<const VectorGenerator<D>> generator;
+	/**
+	 * @brief the free list and statistics
+	 */
+	std::shared_ptr<Pool> pool;
+
+
+	public:
+	/**
+	 * @brief Construct a new PooledVectorGenerator object
+	 *
+	 * @param generator the generator that vectors are allocated with
+	 */
+	explicit PooledVectorGenerator(std::shared_ptr<const VectorGenerator<D>> generator)
+	: generator(generator), pool(std::make_shared<Pool>())
+	{
+		if (generator == nullptr) {
+			throw RuntimeError("PooledVectorGenerator was given a null generator");
+		}
+	}
+	std::shared_ptr<Vector<D>> getNewVector() const override
+	{
+		std::shared_ptr<Vector<D>> vec;
+		if (pool->free_vectors.empty()) {
+			vec = generator->getNewVector();
+			pool->num_misses++;
+			pool->num_bytes += vec->getNumLocalBytes();
+			pool->peak_num_bytes = std::max(pool->peak_num_bytes, pool->num_bytes);
+		} else {
+			vec = pool->free_vectors.back();
+			pool->free_vectors.pop_back();
+			pool->num_hits++;
+			vec->setWithGhost(0);
+		}
+		return std::shared_ptr<Vector<D>>(vec.get(), ReturnToPool(pool, vec));
+	}
+	/**
+	 * @brief Release the vectors in the free list
+	 *
+	 * Vectors that are in use are not affected.
+	 */
+	void clear()
+	{
+		for (const std::shared_ptr<Vector<D>> &vec : pool->free_vectors) {
+			pool->num_bytes -= vec->getNumLocalBytes();
+		}
+		pool->free_vectors.clear();
+	}
+	/**
+	 * @brief Get the number of vectors that were taken from the free list
+	 */
+	int getNumHits() const
+	{
+		return pool->num_hits;
+	}
+	/**
+	 * @brief Get the number of vectors that had to be allocated
+	 */
+	int getNumMisses() const
+	{
+		return pool->num_misses;
+	}
+	/**
+	 * @brief Get the number of vectors in the free list
+	 */
+	int getNumFreeVectors() const
+	{
+		return pool->free_vectors.size();
+	}
+	/**
+	 * @brief Get the number of bytes that are currently allocated by this generator, for both the
+	 * vectors in use and the vectors in the free list
+	 *
+	 * The size of each vector is given by Vector::getNumLocalBytes.
+	 */
+	size_t getNumBytes() const
+	{
+		return pool->num_bytes;
+	}
+	/**
+	 * @brief Get the largest number of bytes that were allocated at once by this generator
+	 */
+	size_t getPeakNumBytes() const
+	{
+		return pool->peak_num_bytes;
+	}
+};
+} // namespace ThunderEgg
+#endif
@@ -0,0 +1,405 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_REDUCTIONBATCH_H
+#define THUNDEREGG_REDUCTIONBATCH_H
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/Threading.h>
+#include <ThunderEgg/Vector.h>
+#include <memory>
+#include <mpi.h>
+#include <vector>
+namespace ThunderEgg
+{
+/**
+ * @brief Evaluates several global reductions (dot products and norms) with a single
+ * MPI_Allreduce.
+ *
+ * Reductions are added to the batch, then evaluate() computes all of them. The local sums are
+ * computed patch by patch, so reductions that share vectors reuse the patch data while it is still
+ * in cache. The patches are divided among the threads, and the per patch sums are combined in
+ * patch order, so the results do not depend on the number of threads. All of the sums are then
+ * reduced in one MPI_Allreduce call. If the batch contains infinity norms, those are reduced in a
+ * second MPI_Allreduce with MPI_MAX.
+ *
+ * 		ReductionBatch<2> batch;
+ * 		int r_dot_r  = batch.addDot(r, r);
+ * 		int b_norm   = batch.addTwoNorm(b);
+ * 		batch.evaluate();
+ * 		double residual = sqrt(batch.getResult(r_dot_r)) / batch.getResult(b_norm);
+ *
+ * The evaluation can also be split with evaluateStart() and evaluateFinish(), the global
+ * reductions are then done with MPI_Iallreduce, and work that does not depend on the results can
+ * be done while they are in progress.
+ *
+ * @tparam D the number of Cartesian dimensions
+ */
+template <int D> class ReductionBatch
+{
+	private:
+	/**
+	 * @brief The types of reductions that are supported
+	 */
+	enum class ReductionType { Dot, TwoNorm, InfNorm };
+	/**
+	 * @brief A reduction that has been added to the batch
+	 */
+	struct Reduction {
+		/**
+		 * @brief the type of reduction
+		 */
+		ReductionType type;
+		/**
+		 * @brief the first vector
+		 */
+		std::shared_ptr<const Vector<D>> a;
+		/**
+		 * @brief the second vector, only used for dot products
+		 */
+		std::shared_ptr<const Vector<D>> b;
+		/**
+		 * @brief the index in either the sum or max buffer
+		 */
+		int buffer_index;
+	};
+	/**
+	 * @brief The reductions in the batch, in the order they were added
+	 */
+	std::vector<Reduction> reductions;
+	/**
+	 * @brief The number of reductions that are summed
+	 */
+	int num_sums = 0;
+	/**
+	 * @brief The number of reductions that use a max
+	 */
+	int num_maxes = 0;
+	/**
+	 * @brief The results, index corresponds to the index in reductions
+	 */
+	std::vector<double> results;
+	/**
+	 * @brief true if evaluate has been called since the last reduction was added
+	 */
+	bool evaluated = false;
+	/**
+	 * @brief true if evaluateStart has been called, and evaluateFinish has not
+	 */
+	bool in_progress = false;
+	/**
+	 * @brief The local values, the sums followed by the maxes
+	 */
+	std::vector<double> local_values;
+	/**
+	 * @brief The global values, valid after the requests have completed
+	 */
+	std::vector<double> global_values;
+	/**
+	 * @brief The requests for the sums and the maxes
+	 */
+	MPI_Request requests[2] = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+
+	/**
+	 * @brief Check that a vector is compatible with the vectors already in the batch
+	 *
+	 * @param vec the vector
+	 */
+	void checkVector(const std::shared_ptr<const Vector<D>> &vec) const
+	{
+		if (vec == nullptr) {
+			throw RuntimeError("ReductionBatch was given a null vector");
+		}
+		if (!reductions.empty()) {
+			const Vector<D> &first = *reductions.front().a;
+			if (vec->getNumLocalPatches() != first.getNumLocalPatches()
+			    || vec->getNumComponents() != first.getNumComponents()) {
+				throw RuntimeError("ReductionBatch was given vectors with different layouts");
+			}
+		}
+	}
+	/**
+	 * @brief Add a reduction to the batch
+	 *
+	 * @return int the index of the reduction
+	 */
+	int addReduction(ReductionType type, std::shared_ptr<const Vector<D>> a,
+	                 std::shared_ptr<const Vector<D>> b)
+	{
+		if (in_progress) {
+			throw RuntimeError("ReductionBatch can not be modified while it is being evaluated");
+		}
+		checkVector(a);
+		checkVector(b);
+		int buffer_index;
+		if (type == ReductionType::InfNorm) {
+			buffer_index = num_maxes++;
+		} else {
+			buffer_index = num_sums++;
+		}
+		reductions.push_back({type, a, b, buffer_index});
+		evaluated = false;
+		return reductions.size() - 1;
+	}
+
+	public:
+	ReductionBatch()                       = default;
+	ReductionBatch(const ReductionBatch &) = delete;
+	ReductionBatch &operator=(const ReductionBatch &) = delete;
+	/**
+	 * @brief Waits for the global reductions if evaluateFinish() was not called
+	 */
+	~ReductionBatch()
+	{
+		if (in_progress) {
+			MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+		}
+	}
+	/**
+	 * @brief Add a dot product to the batch
+	 *
+	 * @param a the first vector
+	 * @param b the second vector
+	 * @return int the index of the result
+	 */
+	int addDot(std::shared_ptr<const Vector<D>> a, std::shared_ptr<const Vector<D>> b)
+	{
+		return addReduction(ReductionType::Dot, a, b);
+	}
+	/**
+	 * @brief Add a l2 norm to the batch
+	 *
+	 * @param a the vector
+	 * @return int the index of the result
+	 */
+	int addTwoNorm(std::shared_ptr<const Vector<D>> a)
+	{
+		return addReduction(ReductionType::TwoNorm, a, a);
+	}
+	/**
+	 * @brief Add an infinity norm to the batch
+	 *
+	 * @param a the vector
+	 * @return int the index of the result
+	 */
+	int addInfNorm(std::shared_ptr<const Vector<D>> a)
+	{
+		return addReduction(ReductionType::InfNorm, a, a);
+	}
+	/**
+	 * @brief Get the number of reductions in the batch
+	 */
+	int getNumReductions() const
+	{
+		return reductions.size();
+	}
+	/**
+	 * @brief Evaluate all the reductions in the batch
+	 *
+	 * This is a collective call over the MPI_Comm of the vectors.
+	 */
+	void evaluate()
+	{
+		evaluateStart();
+		evaluateFinish();
+	}
+	/**
+	 * @brief Evaluate all the reductions in the batch, calling a function on each patch before the
+	 * reductions for the patch are computed
+	 *
+	 * This is used to fuse an update of the vectors with the reductions, so that the reductions
+	 * read the patch while it is still in cache. The patches are divided among the threads if all
+	 * the vectors are thread safe, so the function has to be thread safe.
+	 *
+	 * This is a collective call over the MPI_Comm of the vectors.
+	 *
+	 * @param before_patch the function, the local index of the patch is passed to it
+	 * @param parallel set to false to process the patches serially
+	 */
+	template <typename T> void evaluate(T before_patch, bool parallel = true)
+	{
+		evaluateStart(before_patch, parallel);
+		evaluateFinish();
+	}
+	/**
+	 * @brief Compute the local part of the reductions and start the global reductions, without
+	 * waiting for them to complete
+	 *
+	 * The vectors can be modified after this returns. evaluateFinish() has to be called before the
+	 * results can be used.
+	 *
+	 * This is a collective call over the MPI_Comm of the vectors.
+	 */
+	void evaluateStart()
+	{
+		evaluateStart([](int) {});
+	}
+	/**
+	 * @brief Compute the local part of the reductions and start the global reductions, calling a
+	 * function on each patch before the reductions for the patch are computed
+	 *
+	 * See evaluate(T,bool) for how the function is called, and evaluateStart() for how the
+	 * reductions are completed.
+	 *
+	 * This is a collective call over the MPI_Comm of the vectors.
+	 *
+	 * @param before_patch the function, the local index of the patch is passed to it
+	 * @param parallel set to false to process the patches serially
+	 */
+	template <typename T> void evaluateStart(T before_patch, bool parallel = true)
+	{
+		if (in_progress) {
+			throw RuntimeError("ReductionBatch is already being evaluated");
+		}
+		evaluated = false;
+		if (reductions.empty()) {
+			in_progress = true;
+			return;
+		}
+		int num_values        = num_sums + num_maxes;
+		int num_local_patches = reductions.front().a->getNumLocalPatches();
+		int num_components    = reductions.front().a->getNumComponents();
+		for (const Reduction &reduction : reductions) {
+			parallel = parallel && reduction.a->isThreadSafe() && reduction.b->isThreadSafe();
+		}
+
+		// each patch has its own partial values, they are combined in patch order so that the
+		// result does not depend on the number of threads
+		std::vector<double> patch_values(num_local_patches * num_values, 0.0);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			before_patch(i);
+			double *sums  = patch_values.data() + i * num_values;
+			double *maxes = sums + num_sums;
+			for (const Reduction &reduction : reductions) {
+				for (int c = 0; c < num_components; c++) {
+					const LocalData<D> a_ld = reduction.a->getLocalData(c, i);
+					switch (reduction.type) {
+						case ReductionType::Dot: {
+							const LocalData<D> b_ld = reduction.b->getLocalData(c, i);
+							double &           sum  = sums[reduction.buffer_index];
+							cell_loop<D>(
+							a_ld.getStart(), a_ld.getEnd(),
+							[&](const double &a, const double &b) { sum += a * b; }, a_ld, b_ld);
+						} break;
+						case ReductionType::TwoNorm: {
+							double &sum = sums[reduction.buffer_index];
+							cell_loop<D>(
+							a_ld.getStart(), a_ld.getEnd(), [&](const double &a) { sum += a * a; },
+							a_ld);
+						} break;
+						case ReductionType::InfNorm: {
+							double &max = maxes[reduction.buffer_index];
+							cell_loop<D>(
+							a_ld.getStart(), a_ld.getEnd(),
+							[&](const double &a) { max = fmax(fabs(a), max); }, a_ld);
+						} break;
+					}
+				}
+			}
+		},
+		parallel);
+
+		local_values.assign(num_values, 0.0);
+		double *sums  = local_values.data();
+		double *maxes = local_values.data() + num_sums;
+		for (int i = 0; i < num_local_patches; i++) {
+			const double *patch_sums  = patch_values.data() + i * num_values;
+			const double *patch_maxes = patch_sums + num_sums;
+			for (int j = 0; j < num_sums; j++) {
+				sums[j] += patch_sums[j];
+			}
+			for (int j = 0; j < num_maxes; j++) {
+				maxes[j] = fmax(patch_maxes[j], maxes[j]);
+			}
+		}
+
+		global_values.resize(num_values);
+		MPI_Comm comm = reductions.front().a->getMPIComm();
+		if (num_sums > 0) {
+			MPI_Iallreduce(sums, global_values.data(), num_sums, MPI_DOUBLE, MPI_SUM, comm,
+			               &requests[0]);
+		}
+		if (num_maxes > 0) {
+			MPI_Iallreduce(maxes, global_values.data() + num_sums, num_maxes, MPI_DOUBLE, MPI_MAX,
+			               comm, &requests[1]);
+		}
+		in_progress = true;
+	}
+	/**
+	 * @brief Wait for the global reductions that were started by evaluateStart() to complete
+	 */
+	void evaluateFinish()
+	{
+		if (!in_progress) {
+			throw RuntimeError("ReductionBatch evaluation has not been started");
+		}
+		MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+		in_progress = false;
+
+		results.resize(reductions.size());
+		for (size_t r = 0; r < reductions.size(); r++) {
+			const Reduction &reduction = reductions[r];
+			switch (reduction.type) {
+				case ReductionType::Dot:
+					results[r] = global_values[reduction.buffer_index];
+					break;
+				case ReductionType::TwoNorm:
+					results[r] = sqrt(global_values[reduction.buffer_index]);
+					break;
+				case ReductionType::InfNorm:
+					results[r] = global_values[num_sums + reduction.buffer_index];
+					break;
+			}
+		}
+		evaluated = true;
+	}
+	/**
+	 * @brief Get the number of local patches in the vectors of the batch, 0 if the batch is empty
+	 */
+	int getNumLocalPatches() const
+	{
+		return reductions.empty() ? 0 : reductions.front().a->getNumLocalPatches();
+	}
+	/**
+	 * @brief Get the result of a reduction
+	 *
+	 * evaluate() has to be called before this
+	 *
+	 * @param index the index that was returned when the reduction was added
+	 * @return double the result
+	 */
+	double getResult(int index) const
+	{
+		if (!evaluated) {
+			throw RuntimeError("ReductionBatch has not been evaluated");
+		}
+		if (index < 0 || index >= (int) results.size()) {
+			throw RuntimeError("ReductionBatch index out of range");
+		}
+		return results[index];
+	}
+};
+extern template class ReductionBatch<1>;
+extern template class ReductionBatch<2>;
+extern template class ReductionBatch<3>;
+} // namespace ThunderEgg
+#endif
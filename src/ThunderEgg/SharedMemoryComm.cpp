@@ -0,0 +1,84 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include <ThunderEgg/SharedMemoryComm.h>
+#include <numeric>
+namespace ThunderEgg
+{
+SharedMemoryComm::SharedMemoryComm(MPI_Comm parent_comm) : parent_comm(parent_comm)
+{
+	int rank;
+	MPI_Comm_rank(parent_comm, &rank);
+	MPI_Comm_split_type(parent_comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &comm);
+
+	int parent_size;
+	MPI_Comm_size(parent_comm, &parent_size);
+	std::vector<int> parent_ranks(parent_size);
+	std::iota(parent_ranks.begin(), parent_ranks.end(), 0);
+	node_ranks.resize(parent_size);
+
+	MPI_Group parent_group;
+	MPI_Group group;
+	MPI_Comm_group(parent_comm, &parent_group);
+	MPI_Comm_group(comm, &group);
+	MPI_Group_translate_ranks(parent_group, parent_size, parent_ranks.data(), group,
+	                          node_ranks.data());
+	MPI_Group_free(&parent_group);
+	MPI_Group_free(&group);
+}
+SharedMemoryComm::~SharedMemoryComm()
+{
+	int finalized;
+	MPI_Finalized(&finalized);
+	if (!finalized) {
+		MPI_Comm_free(&comm);
+	}
+}
+MPI_Comm SharedMemoryComm::getParentComm() const
+{
+	return parent_comm;
+}
+MPI_Comm SharedMemoryComm::getComm() const
+{
+	return comm;
+}
+int SharedMemoryComm::getSize() const
+{
+	int size;
+	MPI_Comm_size(comm, &size);
+	return size;
+}
+bool SharedMemoryComm::contains(int parent_rank) const
+{
+	return getNodeRank(parent_rank) != MPI_UNDEFINED;
+}
+int SharedMemoryComm::getNodeRank(int parent_rank) const
+{
+	if (parent_rank < 0 || parent_rank >= (int) node_ranks.size()) {
+		return MPI_UNDEFINED;
+	}
+	return node_ranks[parent_rank];
+}
+void SharedMemoryComm::barrier() const
+{
+	MPI_Barrier(comm);
+}
+} // namespace ThunderEgg
@@ -0,0 +1,99 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_SHAREDMEMORYCOMM_H
+#define THUNDEREGG_SHAREDMEMORYCOMM_H
+#include <mpi.h>
+#include <vector>
+namespace ThunderEgg
+{
+/**
+ * @brief The ranks of a communicator that can share memory with this rank
+ *
+ * This wraps the communicator that is created with MPI_Comm_split_type and MPI_COMM_TYPE_SHARED,
+ * which usually contains the ranks that are on the same node.
+ *
+ * The object can not be copied, share it with a shared_ptr.
+ */
+class SharedMemoryComm
+{
+	private:
+	/**
+	 * @brief the communicator that was split
+	 */
+	MPI_Comm parent_comm;
+	/**
+	 * @brief the communicator of the ranks that can share memory
+	 */
+	MPI_Comm comm;
+	/**
+	 * @brief the rank in comm for each rank in parent_comm, MPI_UNDEFINED if the rank is not in
+	 * comm
+	 */
+	std::vector<int> node_ranks;
+
+	public:
+	/**
+	 * @brief Construct a new SharedMemoryComm object
+	 *
+	 * This is a collective call over parent_comm.
+	 *
+	 * @param parent_comm the communicator to split
+	 */
+	explicit SharedMemoryComm(MPI_Comm parent_comm);
+	SharedMemoryComm(const SharedMemoryComm &) = delete;
+	SharedMemoryComm &operator=(const SharedMemoryComm &) = delete;
+	/**
+	 * @brief Free the communicator
+	 */
+	~SharedMemoryComm();
+	/**
+	 * @brief Get the communicator that was split
+	 */
+	MPI_Comm getParentComm() const;
+	/**
+	 * @brief Get the communicator of the ranks that can share memory with this rank
+	 */
+	MPI_Comm getComm() const;
+	/**
+	 * @brief Get the number of ranks that can share memory with this rank, including this rank
+	 */
+	int getSize() const;
+	/**
+	 * @brief Check if a rank can share memory with this rank
+	 *
+	 * @param parent_rank the rank in the parent communicator
+	 */
+	bool contains(int parent_rank) const;
+	/**
+	 * @brief Get the rank in the shared memory communicator
+	 *
+	 * @param parent_rank the rank in the parent communicator
+	 * @return int the rank, MPI_UNDEFINED if the rank can not share memory with this rank
+	 */
+	int getNodeRank(int parent_rank) const;
+	/**
+	 * @brief Wait for all the ranks that can share memory with this rank
+	 */
+	void barrier() const;
+};
+} // namespace ThunderEgg
+#endif
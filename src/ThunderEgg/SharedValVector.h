@@ -0,0 +1,254 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_SHAREDVALVECTOR_H
+#define THUNDEREGG_SHAREDVALVECTOR_H
+#include <ThunderEgg/Domain.h>
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/SharedMemoryComm.h>
+#include <ThunderEgg/Vector.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+namespace ThunderEgg
+{
+/**
+ * @brief Vector class that stores its values in an MPI shared memory window
+ *
+ * The values of every rank on a node are allocated in one window with MPI_Win_allocate_shared, so
+ * that the patches of the other ranks on the node can be read directly with getNodeLocalData. The
+ * layout of each patch is the same as in ValVector.
+ *
+ * The window is locked for the lifetime of the vector. Before reading values that were written by
+ * another rank, both ranks have to call sync and then wait for each other, with
+ * SharedMemoryComm::barrier for example.
+ *
+ * Constructing and destroying the vector are collective calls over the SharedMemoryComm.
+ *
+ * @tparam D the number of Cartesian dimensions
+ */
+template <int D> class SharedValVector : public Vector<D>
+{
+	private:
+	/**
+	 * @brief the ranks that share the window
+	 */
+	std::shared_ptr<const SharedMemoryComm> shared_comm;
+	/**
+	 * @brief striding to next patch
+	 */
+	int patch_stride;
+	/**
+	 * @brief striding to next component
+	 */
+	int component_stride;
+	/**
+	 * @brief the number of non-ghost cells in each direction of the patch
+	 */
+	std::array<int, D> lengths;
+	/**
+	 * @brief the strides for each axis of the patch
+	 */
+	std::array<int, D> strides;
+	/**
+	 * @brief the number of ghost cells on each side of the patch
+	 */
+	int num_ghost_cells;
+	/**
+	 * @brief the offset of the first element in each patch
+	 */
+	int first_offset;
+	/**
+	 * @brief the shared memory window
+	 */
+	MPI_Win win;
+	/**
+	 * @brief the start of the values of this rank
+	 */
+	double *my_data;
+	/**
+	 * @brief the start of the values of each rank in the shared memory communicator
+	 */
+	std::vector<double *> node_datas;
+
+	/**
+	 * @brief Calculate the number of local (non-ghost) cells
+	 *
+	 * @param lengths the number of cells in each direction
+	 * @param num_patches the number of patches in this vector
+	 * @return int the number of local (non-ghost) cells
+	 */
+	static int GetNumLocalCells(const std::array<int, D> &lengths, int num_patches)
+	{
+		int num_cells_in_patch = 1;
+		for (size_t i = 0; i < D; i++) {
+			num_cells_in_patch *= lengths[i];
+		}
+		return num_patches * num_cells_in_patch;
+	}
+	/**
+	 * @brief Get the LocalData for a patch in the values of a rank
+	 *
+	 * @param data the start of the values of the rank
+	 * @param component_index the index of the component
+	 * @param patch_local_index the local index of the patch on the rank
+	 */
+	LocalData<D> getLocalData(double *data, int component_index, int patch_local_index) const
+	{
+		data += patch_stride * patch_local_index + first_offset
+		        + component_stride * component_index;
+		return LocalData<D>(data, strides, lengths, num_ghost_cells, nullptr);
+	}
+
+	public:
+	/**
+	 * @brief Construct a new SharedValVector object
+	 *
+	 * @param shared_comm the ranks that share the window
+	 * @param lengths the nubmer of (non-ghost) cells in each direction of a patch
+	 * @param num_ghost_cells the number of ghost cells padding each side of a patch
+	 * @param num_components the number of components for each cell
+	 * @param num_patches the number of patches in this vector
+	 */
+	SharedValVector(std::shared_ptr<const SharedMemoryComm> shared_comm,
+	                const std::array<int, D> &lengths, int num_ghost_cells, int num_components,
+	                int num_patches)
+	: Vector<D>(shared_comm->getParentComm(), num_components, num_patches,
+	            GetNumLocalCells(lengths, num_patches)),
+	  shared_comm(shared_comm), lengths(lengths), num_ghost_cells(num_ghost_cells)
+	{
+		int size            = 1;
+		int my_first_offset = 0;
+		for (size_t i = 0; i < D; i++) {
+			strides[i] = size;
+			size *= (this->lengths[i] + 2 * num_ghost_cells);
+			my_first_offset += strides[i] * num_ghost_cells;
+		}
+		first_offset     = my_first_offset;
+		component_stride = size;
+		size *= num_components;
+		patch_stride = size;
+		size *= num_patches;
+
+		MPI_Win_allocate_shared(size * sizeof(double), sizeof(double), MPI_INFO_NULL,
+		                        shared_comm->getComm(), &my_data, &win);
+		MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+
+		node_datas.resize(shared_comm->getSize());
+		for (int r = 0; r < (int) node_datas.size(); r++) {
+			MPI_Aint r_size;
+			int      disp_unit;
+			MPI_Win_shared_query(win, r, &r_size, &disp_unit, &node_datas[r]);
+		}
+		std::fill(my_data, my_data + size, 0.0);
+	}
+	SharedValVector(const SharedValVector &) = delete;
+	SharedValVector &operator=(const SharedValVector &) = delete;
+	/**
+	 * @brief Free the window, this is a collective call over the SharedMemoryComm
+	 */
+	~SharedValVector()
+	{
+		int finalized;
+		MPI_Finalized(&finalized);
+		if (!finalized) {
+			MPI_Win_unlock_all(win);
+			MPI_Win_free(&win);
+		}
+	}
+	/**
+	 * @brief Get a new SharedValVector object for a given Domain
+	 *
+	 * @param shared_comm the ranks that share the window
+	 * @param domain the Domain
+	 * @param num_components the number of components for each cell
+	 * @return std::shared_ptr<SharedValVector<D>> the new Vector
+	 */
+	static std::shared_ptr<SharedValVector<D>>
+	GetNewVector(std::shared_ptr<const SharedMemoryComm> shared_comm,
+	             std::shared_ptr<const Domain<D>> domain, int num_components)
+	{
+		return std::make_shared<SharedValVector<D>>(shared_comm, domain->getNs(),
+		                                            domain->getNumGhostCells(), num_components,
+		                                            domain->getNumLocalPatches());
+	}
+	/**
+	 * @brief Get the number of bytes that this rank allocated in the window
+	 */
+	size_t getNumLocalBytes() const override
+	{
+		return (size_t) patch_stride * this->getNumLocalPatches() * sizeof(double);
+	}
+	/**
+	 * @brief Get the ranks that share the window
+	 */
+	std::shared_ptr<const SharedMemoryComm> getSharedMemoryComm() const
+	{
+		return shared_comm;
+	}
+	LocalData<D> getLocalData(int component_index, int patch_local_index) override
+	{
+		return getLocalData(my_data, component_index, patch_local_index);
+	}
+	const LocalData<D> getLocalData(int component_index, int patch_local_index) const override
+	{
+		return getLocalData(my_data, component_index, patch_local_index);
+	}
+	/**
+	 * @brief Get the LocalData for a patch that is owned by a rank on the same node
+	 *
+	 * @param rank the rank that owns the patch, in the communicator of the vector
+	 * @param component_index the index of the component
+	 * @param patch_local_index the local index of the patch on the owning rank
+	 * @return const LocalData<D> the LocalData
+	 */
+	const LocalData<D> getNodeLocalData(int rank, int component_index,
+	                                    int patch_local_index) const
+	{
+		int node_rank = shared_comm->getNodeRank(rank);
+		if (node_rank == MPI_UNDEFINED) {
+			throw RuntimeError("SharedValVector: rank " + std::to_string(rank)
+			                   + " does not share memory with this rank");
+		}
+		return getLocalData(node_datas[node_rank], component_index, patch_local_index);
+	}
+	/**
+	 * @brief Check if the patches of a rank can be read with getNodeLocalData
+	 *
+	 * @param rank the rank, in the communicator of the vector
+	 */
+	bool isOnNode(int rank) const
+	{
+		return shared_comm->contains(rank);
+	}
+	/**
+	 * @brief Synchronize the public and private copies of the window
+	 *
+	 * Call this after writing values that will be read by other ranks, and before reading values
+	 * that were written by other ranks.
+	 */
+	void sync() const
+	{
+		MPI_Win_sync(win);
+	}
+};
+} // namespace ThunderEgg
+#endif
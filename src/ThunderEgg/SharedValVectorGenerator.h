@@ -0,0 +1,91 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_SHAREDVALVECTORGENERATOR_H
+#define THUNDEREGG_SHAREDVALVECTORGENERATOR_H
+#include <ThunderEgg/SharedValVector.h>
+#include <ThunderEgg/VectorGenerator.h>
+namespace ThunderEgg
+{
+/**
+ * @brief Generates new SharedValVector objects for a given Domain
+ *
+ * Every vector that is generated uses the same SharedMemoryComm. Since creating a SharedValVector
+ * is a collective call, every rank has to generate the same number of vectors in the same order.
+ *
+ * @tparam D the number of Cartesian dimensions
+ */
+template <int D> class SharedValVectorGenerator : public VectorGenerator<D>
+{
+	private:
+	/**
+	 * @brief the ranks that share the windows
+	 */
+	std::shared_ptr<const SharedMemoryComm> shared_comm;
+	/**
+	 * @brief the Domain to generate SharedValVector objects for
+	 */
+	std::shared_ptr<const Domain<D>> domain;
+	/**
+	 * @brief The number of components in each cell
+	 */
+	int num_components;
+
+	public:
+	/**
+	 * @brief Construct a new SharedValVectorGenerator object
+	 *
+	 * This is a collective call over MPI_COMM_WORLD.
+	 *
+	 * @param domain the Domain to generate SharedValVector objects for
+	 * @param num_components the number of components for each cell
+	 */
+	SharedValVectorGenerator(std::shared_ptr<const Domain<D>> domain, int num_components)
+	: shared_comm(std::make_shared<SharedMemoryComm>(MPI_COMM_WORLD)), domain(domain),
+	  num_components(num_components)
+	{
+	}
+	/**
+	 * @brief Construct a new SharedValVectorGenerator object
+	 *
+	 * @param shared_comm the ranks that share the windows
+	 * @param domain the Domain to generate SharedValVector objects for
+	 * @param num_components the number of components for each cell
+	 */
+	SharedValVectorGenerator(std::shared_ptr<const SharedMemoryComm> shared_comm,
+	                         std::shared_ptr<const Domain<D>> domain, int num_components)
+	: shared_comm(shared_comm), domain(domain), num_components(num_components)
+	{
+	}
+	std::shared_ptr<Vector<D>> getNewVector() const override
+	{
+		return SharedValVector<D>::GetNewVector(shared_comm, domain, num_components);
+	}
+	/**
+	 * @brief Get the ranks that share the windows
+	 */
+	std::shared_ptr<const SharedMemoryComm> getSharedMemoryComm() const
+	{
+		return shared_comm;
+	}
+};
+} // namespace ThunderEgg
+#endif
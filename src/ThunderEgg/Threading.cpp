@@ -0,0 +1,66 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/Threading.h>
+#include <cstdlib>
+namespace ThunderEgg
+{
+namespace Threading
+{
+namespace
+{
+/**
+ * @brief Get the initial number of threads from the THUNDEREGG_NUM_THREADS environment variable
+ */
+int GetInitialNumThreads()
+{
+	const char *env = getenv("THUNDEREGG_NUM_THREADS");
+	if (env != nullptr) {
+		int num_threads = atoi(env);
+		if (num_threads >= 1) {
+			return num_threads;
+		}
+	}
+	return 1;
+}
+/**
+ * @brief the number of threads that was set
+ */
+int num_threads = GetInitialNumThreads();
+} // namespace
+void SetNumThreads(int num_threads_in)
+{
+	if (num_threads_in < 1) {
+		throw RuntimeError("Number of threads has to be at least 1");
+	}
+	num_threads = num_threads_in;
+}
+int GetNumThreads()
+{
+#ifdef _OPENMP
+	return num_threads;
+#else
+	return 1;
+#endif
+}
+} // namespace Threading
+} // namespace ThunderEgg
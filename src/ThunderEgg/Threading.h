@@ -0,0 +1,117 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_THREADING_H
+#define THUNDEREGG_THREADING_H
+#include <algorithm>
+#include <cmath>
+#include <vector>
+namespace ThunderEgg
+{
+/**
+ * @brief Thread parallel loops over the local patches
+ *
+ * The loops are threaded with OpenMP when ThunderEgg is built with it, otherwise they run
+ * serially. The number of threads defaults to 1, so that runs with one MPI rank per core are not
+ * oversubscribed. It can be changed with SetNumThreads, or with the THUNDEREGG_NUM_THREADS
+ * environment variable.
+ *
+ * The reductions compute one partial result per iteration and combine them in iteration order, so
+ * their results do not depend on the number of threads.
+ */
+namespace Threading
+{
+/**
+ * @brief Set the number of threads to use
+ *
+ * @param num_threads the number of threads, has to be at least 1
+ */
+void SetNumThreads(int num_threads);
+/**
+ * @brief Get the number of threads that will be used
+ *
+ * This is always 1 if ThunderEgg is not built with OpenMP.
+ */
+int GetNumThreads();
+/**
+ * @brief Call f(i) for each i in [0,n)
+ *
+ * @param n the number of iterations
+ * @param f the function, iterations may run concurrently
+ * @param parallel set to false to run serially, for when f is not thread safe
+ */
+template <typename T> void ParallelFor(int n, T f, bool parallel = true)
+{
+#ifdef _OPENMP
+	int num_threads = parallel ? std::min(GetNumThreads(), n) : 1;
+	if (num_threads > 1) {
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+		for (int i = 0; i < n; i++) {
+			f(i);
+		}
+		return;
+	}
+#endif
+	for (int i = 0; i < n; i++) {
+		f(i);
+	}
+}
+/**
+ * @brief Get the sum of f(i) for each i in [0,n)
+ *
+ * The values are summed in order of i, so the result is the same for any number of threads.
+ *
+ * @param n the number of iterations
+ * @param f the function, iterations may run concurrently
+ * @param parallel set to false to run serially, for when f is not thread safe
+ * @return double the sum
+ */
+template <typename T> double ParallelSum(int n, T f, bool parallel = true)
+{
+	std::vector<double> partials(n);
+	ParallelFor(n, [&](int i) { partials[i] = f(i); }, parallel);
+	double sum = 0;
+	for (double partial : partials) {
+		sum += partial;
+	}
+	return sum;
+}
+/**
+ * @brief Get the maximum of f(i) for each i in [0,n), or 0 if n is 0
+ *
+ * @param n the number of iterations
+ * @param f the function, iterations may run concurrently
+ * @param parallel set to false to run serially, for when f is not thread safe
+ * @return double the maximum
+ */
+template <typename T> double ParallelMax(int n, T f, bool parallel = true)
+{
+	std::vector<double> partials(n);
+	ParallelFor(n, [&](int i) { partials[i] = f(i); }, parallel);
+	double max = 0;
+	for (double partial : partials) {
+		max = fmax(partial, max);
+	}
+	return max;
+}
+} // namespace Threading
+} // namespace ThunderEgg
+#endif
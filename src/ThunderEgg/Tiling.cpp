@@ -0,0 +1,70 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/Tiling.h>
+#include <cstdlib>
+#include <unistd.h>
+namespace ThunderEgg
+{
+namespace Tiling
+{
+namespace
+{
+/**
+ * @brief Get the initial cache size from the THUNDEREGG_CACHE_SIZE environment variable, or the
+ * size of the L2 cache
+ */
+long GetInitialCacheSize()
+{
+	const char *env = getenv("THUNDEREGG_CACHE_SIZE");
+	if (env != nullptr) {
+		long cache_size = atol(env);
+		if (cache_size > 0) {
+			return cache_size;
+		}
+	}
+#ifdef _SC_LEVEL2_CACHE_SIZE
+	long l2_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+	if (l2_size > 0) {
+		return l2_size;
+	}
+#endif
+	return 1 << 20;
+}
+/**
+ * @brief the cache size that was set
+ */
+long cache_size = GetInitialCacheSize();
+} // namespace
+void SetCacheSize(long cache_size_in)
+{
+	if (cache_size_in <= 0) {
+		throw RuntimeError("Cache size has to be positive");
+	}
+	cache_size = cache_size_in;
+}
+long GetCacheSize()
+{
+	return cache_size;
+}
+} // namespace Tiling
+} // namespace ThunderEgg
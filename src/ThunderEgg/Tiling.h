@@ -0,0 +1,86 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_TILING_H
+#define THUNDEREGG_TILING_H
+#include <array>
+namespace ThunderEgg
+{
+/**
+ * @brief Choosing tile sizes for the cache blocked stencils (see tiled_row_loop)
+ *
+ * The tiles are chosen so that the planes of a stencil that are in use at the same time fit in
+ * half of the cache size. The cache size defaults to the size of the L2 cache if it can be
+ * queried, otherwise 1 MiB. It can be changed with SetCacheSize, or with the
+ * THUNDEREGG_CACHE_SIZE environment variable (in bytes).
+ */
+namespace Tiling
+{
+/**
+ * @brief Set the cache size used to choose the tile sizes
+ *
+ * @param cache_size the size in bytes, has to be positive
+ */
+void SetCacheSize(long cache_size);
+/**
+ * @brief Get the cache size used to choose the tile sizes, in bytes
+ */
+long GetCacheSize();
+/**
+ * @brief Choose the tile sizes for a stencil on patches of ns cells
+ *
+ * The stencil sweeps through a tile one plane of the last axis at a time, so only the planes that
+ * are in use have to stay in cache. If they do not fit for the whole patch, the second to last
+ * axis is split into equal tiles that fit. 2D patches and patches that fit are not tiled.
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @param ns the number of cells on each axis of the patches
+ * @param num_ghost the number of ghost cells on each side of the patches
+ * @param num_planes the number of planes that are in use at a time, for example 4 for f=A*u with a
+ * star stencil, three planes of u and one of f
+ * @return std::array<int, D> the tile sizes, 0 for axes that are not split
+ */
+template <int D>
+std::array<int, D> ChooseTileSizes(const std::array<int, D> &ns, int num_ghost, int num_planes)
+{
+	std::array<int, D> tile_sizes;
+	tile_sizes.fill(0);
+	if (D < 3) {
+		return tile_sizes;
+	}
+	const int axis       = D - 2;
+	long      row_bytes  = (ns[0] + 2 * num_ghost) * (long) sizeof(double) * num_planes;
+	long      max_bytes  = GetCacheSize() / 2;
+	int       num_tiles  = 1;
+	int       tile_size  = ns[axis];
+	auto      tile_bytes = [&](int size) { return row_bytes * (size + 2 * num_ghost); };
+	while (tile_size > 1 && tile_bytes(tile_size) > max_bytes) {
+		num_tiles++;
+		tile_size = (ns[axis] + num_tiles - 1) / num_tiles;
+	}
+	if (num_tiles > 1) {
+		tile_sizes[axis] = tile_size;
+	}
+	return tile_sizes;
+}
+} // namespace Tiling
+} // namespace ThunderEgg
+#endif
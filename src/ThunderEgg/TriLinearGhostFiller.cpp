@@ -46,8 +46,8 @@ static std::array<int, 2> getOffset(const std::array<int, 3> ns, Side<3> s, Orth
 	return offset;
 }
 void TriLinearGhostFiller::fillGhostCellsForNbrPatch(std::shared_ptr<const PatchInfo<3>> pinfo,
-                                                     const std::vector<LocalData<3>> &local_datas,
-                                                     const std::vector<LocalData<3>> &nbr_datas,
+                                                     const PatchView<3> &local_datas,
+                                                     const PatchView<3> &nbr_datas,
                                                      const Side<3> side, const NbrType nbr_type,
                                                      const Orthant<3> orthant) const
 {
@@ -94,8 +94,13 @@ void TriLinearGhostFiller::fillGhostCellsForNbrPatch(std::shared_ptr<const Patch
 	}
 }
 
-void TriLinearGhostFiller::fillGhostCellsForLocalPatch(
-std::shared_ptr<const PatchInfo<3>> pinfo, const std::vector<LocalData<3>> &local_datas) const
+bool TriLinearGhostFiller::copiesNormalNbrGhosts() const
+{
+	return true;
+}
+
+void TriLinearGhostFiller::fillGhostCellsForLocalPatch(std::shared_ptr<const PatchInfo<3>> pinfo,
+                                                       const PatchView<3> &local_datas) const
 {
 	for (auto &local_data : local_datas) {
 		for (Side<3> side : Side<3>::getValues()) {
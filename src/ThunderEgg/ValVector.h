@@ -21,7 +21,11 @@
 
 #ifndef THUNDEREGG_VALVECTOR_H
 #define THUNDEREGG_VALVECTOR_H
+#include <ThunderEgg/Domain.h>
+#include <ThunderEgg/Threading.h>
+#include <ThunderEgg/ValVectorLayout.h>
 #include <ThunderEgg/Vector.h>
+#include <cstdint>
 #include <valarray>
 namespace ThunderEgg
 {
@@ -58,6 +62,16 @@ template <int D> class ValVector : public Vector<D>
 	 * @brief the offset of the first element in each patch
 	 */
 	int first_offset;
+	/**
+	 * @brief the memory layout options
+	 */
+	ValVectorLayout layout;
+	/**
+	 * @brief the offset of the start of the data in the underlying valarray
+	 *
+	 * This is nonzero when the data is shifted to get the requested alignment.
+	 */
+	size_t data_offset = 0;
 	/**
 	 * @brief the underlying vector
 	 */
@@ -78,6 +92,134 @@ template <int D> class ValVector : public Vector<D>
 		}
 		return num_patches * num_cells_in_patch;
 	}
+	/**
+	 * @brief Get a pointer to the first element of the underlying valarray
+	 */
+	double *getData()
+	{
+		return vec.size() > 0 ? &vec[data_offset] : nullptr;
+	}
+	/**
+	 * @brief Get a pointer to the first element of the underlying valarray
+	 */
+	const double *getData() const
+	{
+		return vec.size() > 0 ? &vec[data_offset] : nullptr;
+	}
+	/**
+	 * @brief Get the other vector as a ValVector if it has the same layout as this vector
+	 *
+	 * @param b the other vector
+	 * @return const ValVector<D>* the other vector, nullptr if it is not a ValVector with the same
+	 * layout
+	 */
+	const ValVector<D> *getSameLayout(const std::shared_ptr<const Vector<D>> &b) const
+	{
+		const ValVector<D> *b_vv = dynamic_cast<const ValVector<D> *>(b.get());
+		if (b_vv != nullptr && b_vv->lengths == lengths && b_vv->strides == strides
+		    && b_vv->num_ghost_cells == num_ghost_cells
+		    && b_vv->getNumComponents() == this->getNumComponents()
+		    && b_vv->getNumLocalPatches() == this->getNumLocalPatches()) {
+			return b_vv;
+		}
+		return nullptr;
+	}
+	/**
+	 * @brief Call a function for each row of non-ghost cells in a patch
+	 *
+	 * A row is the set of cells along the first axis, these are contiguous in memory.
+	 *
+	 * @param patch the local index of the patch
+	 * @param lambda the function, the offset of the first cell in the row is passed to it
+	 */
+	template <typename T> void forEachRowInPatch(int patch, T lambda) const
+	{
+		std::array<int, D> start;
+		std::array<int, D> end;
+		start.fill(0);
+		for (size_t i = 0; i < D; i++) {
+			end[i] = lengths[i] - 1;
+		}
+		for (int c = 0; c < this->getNumComponents(); c++) {
+			int patch_offset = patch_stride * patch + component_stride * c + first_offset;
+			row_loop<D>(start, end, [&](const std::array<int, D> &coord) {
+				int offset = patch_offset;
+				for (size_t axis = 1; axis < D; axis++) {
+					offset += strides[axis] * coord[axis];
+				}
+				lambda(offset);
+			});
+		}
+	}
+	/**
+	 * @brief Call a function for each row of non-ghost cells in the vector
+	 *
+	 * The patches are divided among the threads, so lambda has to be thread safe.
+	 *
+	 * @param lambda the function, the offset of the first cell in the row is passed to it
+	 */
+	template <typename T> void forEachRow(T lambda) const
+	{
+		Threading::ParallelFor(this->getNumLocalPatches(),
+		                       [&](int i) { forEachRowInPatch(i, lambda); });
+	}
+	/**
+	 * @brief Sum a function over each row of non-ghost cells in the vector
+	 *
+	 * The rows of each patch are summed, and then the patch sums are summed in order, so the
+	 * result does not depend on the number of threads.
+	 *
+	 * @param lambda the function, the offset of the first cell in the row is passed to it
+	 * @return double the sum
+	 */
+	template <typename T> double sumRows(T lambda) const
+	{
+		return Threading::ParallelSum(this->getNumLocalPatches(), [&](int i) {
+			double sum = 0;
+			forEachRowInPatch(i, [&](int offset) { sum += lambda(offset); });
+			return sum;
+		});
+	}
+	/**
+	 * @brief Call a function for the range of values, including ghost cells and padding, of each
+	 * patch
+	 *
+	 * @param lambda the function, the offset of the first value and the number of values are
+	 * passed to it
+	 */
+	template <typename T> void forEachPatchRange(T lambda) const
+	{
+		Threading::ParallelFor(this->getNumLocalPatches(),
+		                       [&](int i) { lambda(patch_stride * i, patch_stride); });
+	}
+	/**
+	 * @brief Dot product of two contiguous rows
+	 *
+	 * Uses several partial sums so that the loop can be vectorized.
+	 *
+	 * @param a the first row
+	 * @param b the second row
+	 * @param n the length of the rows
+	 * @return double the dot product
+	 */
+	static double RowDot(const double *a, const double *b, int n)
+	{
+		double sum0 = 0;
+		double sum1 = 0;
+		double sum2 = 0;
+		double sum3 = 0;
+		int    i    = 0;
+		for (; i + 3 < n; i += 4) {
+			sum0 += a[i] * b[i];
+			sum1 += a[i + 1] * b[i + 1];
+			sum2 += a[i + 2] * b[i + 2];
+			sum3 += a[i + 3] * b[i + 3];
+		}
+		for (; i < n; i++) {
+			sum0 += a[i] * b[i];
+		}
+		return (sum0 + sum1) + (sum2 + sum3);
+	}
 
 	public:
 	/**
@@ -88,17 +230,25 @@ template <int D> class ValVector : public Vector<D>
 	 * @param num_ghost_cells the number of ghost cells padding each side of a patch
 	 * @param num_components the number of components for each cell
 	 * @param num_patches the number of patches in this vector
+	 * @param layout the memory layout options
 	 */
 	ValVector(MPI_Comm comm, const std::array<int, D> &lengths, int num_ghost_cells,
-	          int num_components, int num_patches)
+	          int num_components, int num_patches,
+	          const ValVectorLayout &layout = ValVectorLayout())
 	: Vector<D>(comm, num_components, num_patches, GetNumLocalCells(lengths, num_patches)),
-	  lengths(lengths), num_ghost_cells(num_ghost_cells)
+	  lengths(lengths), num_ghost_cells(num_ghost_cells), layout(layout)
 	{
+		const int align = layout.aligned ? ValVectorLayout::Alignment / sizeof(double) : 1;
+
 		int size            = 1;
 		int my_first_offset = 0;
 		for (size_t i = 0; i < D; i++) {
 			strides[i] = size;
 			size *= (this->lengths[i] + 2 * num_ghost_cells);
+			if (i == 0) {
+				// pad the rows so that every row starts at a multiple of the alignment
+				size = (size + align - 1) / align * align;
+			}
 			my_first_offset += strides[i] * num_ghost_cells;
 		}
 		first_offset     = my_first_offset;
@@ -106,35 +256,305 @@ template <int D> class ValVector : public Vector<D>
 		size *= num_components;
 		patch_stride = size;
 		size *= num_patches;
-		vec.resize(size);
+		if (layout.aligned) {
+			// allocate extra values so that the data can be shifted to align the first non-ghost
+			// cell of each row
+			vec.resize(size + align - 1);
+			const uintptr_t alignment  = ValVectorLayout::Alignment;
+			uintptr_t       first_cell = reinterpret_cast<uintptr_t>(&vec[num_ghost_cells]);
+			data_offset = (alignment - first_cell % alignment) % alignment / sizeof(double);
+		} else {
+			vec.resize(size);
+		}
+		if (layout.huge_pages && vec.size() > 0) {
+			AdviseHugePages(&vec[0], vec.size() * sizeof(double));
+		}
 	}
 	/**
 	 * @brief Get a new ValVector object for a given Domain
 	 *
 	 * @param domain the Domain
 	 * @param num_components the number of components for each cell
+	 * @param layout the memory layout options
 	 * @return std::shared_ptr<ValVector<D>> the new Vector
 	 */
-	static std::shared_ptr<ValVector<D>> GetNewVector(std::shared_ptr<const Domain<D>> domain,
-	                                                  int num_components)
+	static std::shared_ptr<ValVector<D>>
+	GetNewVector(std::shared_ptr<const Domain<D>> domain, int num_components,
+	             const ValVectorLayout &layout = ValVectorLayout())
 	{
 		return std::shared_ptr<ValVector<D>>(
 		new ValVector<D>(MPI_COMM_WORLD, domain->getNs(), domain->getNumGhostCells(),
-		                 num_components, domain->getNumLocalPatches()));
+		                 num_components, domain->getNumLocalPatches(), layout));
 	}
 	LocalData<D> getLocalData(int component_index, int local_patch_index) override
 	{
-		double *data = &vec[patch_stride * local_patch_index + first_offset
-		                    + component_stride * component_index];
+		double *data = getData() + patch_stride * local_patch_index + first_offset
+		               + component_stride * component_index;
 		return LocalData<D>(data, strides, lengths, num_ghost_cells, nullptr);
 	}
 	const LocalData<D> getLocalData(int component_index, int local_patch_index) const override
 	{
-		double *data = const_cast<double *>(
-		&vec[patch_stride * local_patch_index + first_offset + component_stride * component_index]);
+		double *data = const_cast<double *>(getData() + patch_stride * local_patch_index
+		                                    + first_offset + component_stride * component_index);
 		return LocalData<D>(data, strides, lengths, num_ghost_cells, nullptr);
 	}
 
+	void set(double alpha) override
+	{
+		double *data = getData();
+		int     n    = lengths[0];
+		forEachRow([&](int offset) {
+			double *row = data + offset;
+			for (int i = 0; i < n; i++) {
+				row[i] = alpha;
+			}
+		});
+	}
+	void setWithGhost(double alpha) override
+	{
+		double *data = getData();
+		forEachPatchRange([&](int offset, int n) {
+			double *patch = data + offset;
+			for (int i = 0; i < n; i++) {
+				patch[i] = alpha;
+			}
+		});
+	}
+	void scale(double alpha) override
+	{
+		double *data = getData();
+		int     n    = lengths[0];
+		forEachRow([&](int offset) {
+			double *row = data + offset;
+			for (int i = 0; i < n; i++) {
+				row[i] *= alpha;
+			}
+		});
+	}
+	void shift(double delta) override
+	{
+		double *data = getData();
+		int     n    = lengths[0];
+		forEachRow([&](int offset) {
+			double *row = data + offset;
+			for (int i = 0; i < n; i++) {
+				row[i] += delta;
+			}
+		});
+	}
+	void copy(std::shared_ptr<const Vector<D>> b) override
+	{
+		const ValVector<D> *b_vv = getSameLayout(b);
+		if (b_vv == nullptr) {
+			Vector<D>::copy(b);
+			return;
+		}
+		double *      data   = getData();
+		const double *b_data = b_vv->getData();
+		int           n      = lengths[0];
+		forEachRow([&](int offset) {
+			double *      row   = data + offset;
+			const double *b_row = b_data + offset;
+			for (int i = 0; i < n; i++) {
+				row[i] = b_row[i];
+			}
+		});
+	}
+	void add(std::shared_ptr<const Vector<D>> b) override
+	{
+		const ValVector<D> *b_vv = getSameLayout(b);
+		if (b_vv == nullptr) {
+			Vector<D>::add(b);
+			return;
+		}
+		double *      data   = getData();
+		const double *b_data = b_vv->getData();
+		int           n      = lengths[0];
+		forEachRow([&](int offset) {
+			double *      row   = data + offset;
+			const double *b_row = b_data + offset;
+			for (int i = 0; i < n; i++) {
+				row[i] += b_row[i];
+			}
+		});
+	}
+	void addScaled(double alpha, std::shared_ptr<const Vector<D>> b) override
+	{
+		const ValVector<D> *b_vv = getSameLayout(b);
+		if (b_vv == nullptr) {
+			Vector<D>::addScaled(alpha, b);
+			return;
+		}
+		double *      data   = getData();
+		const double *b_data = b_vv->getData();
+		int           n      = lengths[0];
+		forEachRow([&](int offset) {
+			double *      row   = data + offset;
+			const double *b_row = b_data + offset;
+			for (int i = 0; i < n; i++) {
+				row[i] += alpha * b_row[i];
+			}
+		});
+	}
+	void addScaled(double alpha, std::shared_ptr<const Vector<D>> a, double beta,
+	               std::shared_ptr<const Vector<D>> b) override
+	{
+		const ValVector<D> *a_vv = getSameLayout(a);
+		const ValVector<D> *b_vv = getSameLayout(b);
+		if (a_vv == nullptr || b_vv == nullptr) {
+			Vector<D>::addScaled(alpha, a, beta, b);
+			return;
+		}
+		double *      data   = getData();
+		const double *a_data = a_vv->getData();
+		const double *b_data = b_vv->getData();
+		int           n      = lengths[0];
+		forEachRow([&](int offset) {
+			double *      row   = data + offset;
+			const double *a_row = a_data + offset;
+			const double *b_row = b_data + offset;
+			for (int i = 0; i < n; i++) {
+				row[i] += alpha * a_row[i] + beta * b_row[i];
+			}
+		});
+	}
+	void scaleThenAdd(double alpha, std::shared_ptr<const Vector<D>> b) override
+	{
+		const ValVector<D> *b_vv = getSameLayout(b);
+		if (b_vv == nullptr) {
+			Vector<D>::scaleThenAdd(alpha, b);
+			return;
+		}
+		double *      data   = getData();
+		const double *b_data = b_vv->getData();
+		int           n      = lengths[0];
+		forEachRow([&](int offset) {
+			double *      row   = data + offset;
+			const double *b_row = b_data + offset;
+			for (int i = 0; i < n; i++) {
+				row[i] = alpha * row[i] + b_row[i];
+			}
+		});
+	}
+	void scaleThenAddScaled(double alpha, double beta, std::shared_ptr<const Vector<D>> b) override
+	{
+		const ValVector<D> *b_vv = getSameLayout(b);
+		if (b_vv == nullptr) {
+			Vector<D>::scaleThenAddScaled(alpha, beta, b);
+			return;
+		}
+		double *      data   = getData();
+		const double *b_data = b_vv->getData();
+		int           n      = lengths[0];
+		forEachRow([&](int offset) {
+			double *      row   = data + offset;
+			const double *b_row = b_data + offset;
+			for (int i = 0; i < n; i++) {
+				row[i] = alpha * row[i] + beta * b_row[i];
+			}
+		});
+	}
+	void scaleThenAddScaled(double alpha, double beta, std::shared_ptr<const Vector<D>> b,
+	                        double gamma, std::shared_ptr<const Vector<D>> c) override
+	{
+		const ValVector<D> *b_vv = getSameLayout(b);
+		const ValVector<D> *c_vv = getSameLayout(c);
+		if (b_vv == nullptr || c_vv == nullptr) {
+			Vector<D>::scaleThenAddScaled(alpha, beta, b, gamma, c);
+			return;
+		}
+		double *      data   = getData();
+		const double *b_data = b_vv->getData();
+		const double *c_data = c_vv->getData();
+		int           n      = lengths[0];
+		forEachRow([&](int offset) {
+			double *      row   = data + offset;
+			const double *b_row = b_data + offset;
+			const double *c_row = c_data + offset;
+			for (int i = 0; i < n; i++) {
+				row[i] = alpha * row[i] + beta * b_row[i] + gamma * c_row[i];
+			}
+		});
+	}
+	double localTwoNormSquared() const override
+	{
+		const double *data = getData();
+		int           n    = lengths[0];
+		return sumRows([&](int offset) { return RowDot(data + offset, data + offset, n); });
+	}
+	double localDot(std::shared_ptr<const Vector<D>> b) const override
+	{
+		const ValVector<D> *b_vv = getSameLayout(b);
+		if (b_vv == nullptr) {
+			return Vector<D>::localDot(b);
+		}
+		const double *data   = getData();
+		const double *b_data = b_vv->getData();
+		int           n      = lengths[0];
+		return sumRows([&](int offset) { return RowDot(data + offset, b_data + offset, n); });
+	}
+	/**
+	 * @brief copy the values of the other vector, including ghost cells
+	 *
+	 * This copies the whole buffer in one pass. Falls back to copy() if the other vector is not a
+	 * ValVector with the same layout.
+	 *
+	 * @param b the other vector
+	 */
+	void copyWithGhost(std::shared_ptr<const Vector<D>> b)
+	{
+		const ValVector<D> *b_vv = getSameLayout(b);
+		if (b_vv == nullptr) {
+			copy(b);
+			return;
+		}
+		double *      data   = getData();
+		const double *b_data = b_vv->getData();
+		forEachPatchRange([&](int offset, int n) {
+			double *      patch   = data + offset;
+			const double *b_patch = b_data + offset;
+			for (int i = 0; i < n; i++) {
+				patch[i] = b_patch[i];
+			}
+		});
+	}
+	/**
+	 * @brief scale all elements in the vector, including ghost cells
+	 *
+	 * @param alpha the value to scale by
+	 */
+	void scaleWithGhost(double alpha)
+	{
+		double *data = getData();
+		forEachPatchRange([&](int offset, int n) {
+			double *patch = data + offset;
+			for (int i = 0; i < n; i++) {
+				patch[i] *= alpha;
+			}
+		});
+	}
+	/**
+	 * @brief `this = this + alpha * b`, including ghost cells
+	 *
+	 * Falls back to addScaled() if the other vector is not a ValVector with the same layout.
+	 */
+	void addScaledWithGhost(double alpha, std::shared_ptr<const Vector<D>> b)
+	{
+		const ValVector<D> *b_vv = getSameLayout(b);
+		if (b_vv == nullptr) {
+			addScaled(alpha, b);
+			return;
+		}
+		double *      data   = getData();
+		const double *b_data = b_vv->getData();
+		forEachPatchRange([&](int offset, int n) {
+			double *      patch   = data + offset;
+			const double *b_patch = b_data + offset;
+			for (int i = 0; i < n; i++) {
+				patch[i] += alpha * b_patch[i];
+			}
+		});
+	}
 	/**
 	 * @brief Get the number of ghost cells padding each side of the patches
 	 *
@@ -144,9 +564,26 @@ template <int D> class ValVector : public Vector<D>
 	{
 		return num_ghost_cells;
 	}
+	/**
+	 * @brief Get the size of the underlying valarray in bytes, including the alignment padding
+	 */
+	size_t getNumLocalBytes() const override
+	{
+		return vec.size() * sizeof(double);
+	}
+	/**
+	 * @brief Get the memory layout options
+	 */
+	const ValVectorLayout &getLayout() const
+	{
+		return layout;
+	}
 	/**
 	 * @brief Get a reference to the underlying valarray
 	 *
+	 * With an aligned layout the valarray also contains padding, so the values should be accessed
+	 * with getLocalData instead.
+	 *
 	 * @return std::valarray<int>& a reference to the underlying valarray
 	 */
 	std::valarray<double> &getValArray()
@@ -42,6 +42,10 @@ template <int D> class ValVectorGenerator : public VectorGenerator<D>
 	 * @brief The number of components in each cell
 	 */
 	int num_components;
+	/**
+	 * @brief The memory layout of the generated vectors
+	 */
+	ValVectorLayout layout;
 
 	public:
 	/**
@@ -49,14 +53,23 @@ template <int D> class ValVectorGenerator : public VectorGenerator<D>
 	 *
 	 * @param domain the Domain to generate ValVector objects for
 	 * @param num_components the number of components for each cell
+	 * @param layout the memory layout of the generated vectors
 	 */
-	explicit ValVectorGenerator(std::shared_ptr<const Domain<D>> domain, int num_components)
-	: domain(domain), num_components(num_components)
+	explicit ValVectorGenerator(std::shared_ptr<const Domain<D>> domain, int num_components,
+	                            const ValVectorLayout &layout = ValVectorLayout())
+	: domain(domain), num_components(num_components), layout(layout)
 	{
 	}
 	std::shared_ptr<Vector<D>> getNewVector() const override
 	{
-		return ValVector<D>::GetNewVector(domain, num_components);
+		return ValVector<D>::GetNewVector(domain, num_components, layout);
+	}
+	/**
+	 * @brief Get the memory layout of the generated vectors
+	 */
+	const ValVectorLayout &getLayout() const
+	{
+		return layout;
 	}
 };
 } // namespace ThunderEgg
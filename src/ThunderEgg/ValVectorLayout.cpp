@@ -0,0 +1,55 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include <ThunderEgg/ValVectorLayout.h>
+#include <cstdint>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+namespace ThunderEgg
+{
+constexpr size_t ValVectorLayout::Alignment;
+bool AdviseHugePages(void *data, size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	const uintptr_t huge_page_size = 2 * 1024 * 1024;
+
+	uintptr_t start = reinterpret_cast<uintptr_t>(data);
+	uintptr_t end   = start + size;
+	start           = (start + huge_page_size - 1) & ~(huge_page_size - 1);
+	end             = end & ~(huge_page_size - 1);
+	if (end <= start) {
+		return false;
+	}
+	void * aligned_data = reinterpret_cast<void *>(start);
+	size_t aligned_size = end - start;
+	if (madvise(aligned_data, aligned_size, MADV_HUGEPAGE) != 0) {
+		return false;
+	}
+	// the pages were already touched when the buffer was zeroed, drop them so that they are
+	// faulted back in as huge pages
+	madvise(aligned_data, aligned_size, MADV_DONTNEED);
+	return true;
+#else
+	return false;
+#endif
+}
+} // namespace ThunderEgg
@@ -0,0 +1,76 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_VALVECTORLAYOUT_H
+#define THUNDEREGG_VALVECTORLAYOUT_H
+#include <cstddef>
+namespace ThunderEgg
+{
+/**
+ * @brief Options for how a ValVector stores its patches in memory
+ *
+ * By default the patches are packed with no padding. With aligned set, the rows of each patch are
+ * padded so that the first non-ghost cell of every row starts on a 64 byte boundary. This lets the
+ * compiler use aligned vector loads in the row kernels, at the cost of a few extra values per row.
+ *
+ * 		ValVectorLayout layout;
+ * 		layout.aligned    = true;
+ * 		layout.huge_pages = true;
+ * 		ValVectorGenerator<3> vg(domain, 1, layout);
+ */
+struct ValVectorLayout {
+	/**
+	 * @brief The alignment in bytes of the first non-ghost cell of each row, if aligned is set
+	 */
+	static constexpr size_t Alignment = 64;
+	/**
+	 * @brief Pad the rows so that the first non-ghost cell of each row is aligned
+	 */
+	bool aligned = false;
+	/**
+	 * @brief Ask the operating system to back the storage with transparent huge pages
+	 *
+	 * This only has an effect on Linux, and only on vectors that span at least one huge page.
+	 */
+	bool huge_pages = false;
+	/**
+	 * @brief Compare two layouts
+	 *
+	 * @return true if the layouts have the same options
+	 */
+	bool operator==(const ValVectorLayout &other) const
+	{
+		return aligned == other.aligned && huge_pages == other.huge_pages;
+	}
+};
+/**
+ * @brief Advise the operating system to back a zero-filled buffer with transparent huge pages
+ *
+ * Only the part of the buffer that covers whole huge pages is advised. That part is released and
+ * will be faulted back in as zero-filled huge pages, so the buffer has to contain only zeros.
+ *
+ * @param data the buffer
+ * @param size the size of the buffer in bytes
+ * @return true if the advice was given
+ */
+bool AdviseHugePages(void *data, size_t size);
+} // namespace ThunderEgg
+#endif
@@ -27,12 +27,74 @@
 #include <ThunderEgg/GhostFiller.h>
 #include <ThunderEgg/PatchOperator.h>
 #include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/Tiling.h>
 #include <ThunderEgg/ValVector.h>
 
 namespace ThunderEgg
 {
 namespace VarPoisson
 {
+/**
+ * @brief The variable coefficient star stencil at a cell, summed over every axis
+ *
+ * The axes are added in order, so the result is the same as adding one axis at a time.
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @param u pointer to the value of the cell
+ * @param c pointer to the coefficient of the cell
+ * @param strides the strides of u
+ * @param c_strides the strides of c
+ * @param h2 the square of the cell spacings
+ * @return double the value of the stencil
+ */
+template <int D>
+inline double StarStencil(const double *u, const double *c, const std::array<int, D> &strides,
+                          const std::array<int, D> &c_strides, const std::array<double, D> &h2)
+{
+	double sum = 0;
+	for (int axis = 0; axis < D; axis++) {
+		int    stride   = strides[axis];
+		int    c_stride = c_strides[axis];
+		double lower    = u[-stride];
+		double mid      = u[0];
+		double upper    = u[stride];
+		double c_lower  = c[-c_stride];
+		double c_mid    = c[0];
+		double c_upper  = c[c_stride];
+		sum += ((c_upper + c_mid) * (upper - mid) - (c_lower + c_mid) * (mid - lower))
+		       / (2 * h2[axis]);
+	}
+	return sum;
+}
+/**
+ * @brief The variable coefficient star stencil at a cell, using precomputed face coefficients
+ *
+ * The face coefficient between two cells is (c_lower + c_upper) / (2 * h2).
+ *
+ * @tparam D the number of Cartesian dimensions
+ * @param u pointer to the value of the cell
+ * @param t pointer to the coefficient of the lower face of the cell for each axis
+ * @param strides the strides of u
+ * @param t_strides the distance from the lower face to the upper face of the cell on each axis
+ * @return double the value of the stencil
+ */
+template <int D>
+inline double CachedStarStencil(const double *u, const std::array<const double *, D> &t,
+                                const std::array<int, D> &strides,
+                                const std::array<int, D> &t_strides)
+{
+	double sum = 0;
+	for (int axis = 0; axis < D; axis++) {
+		int    stride  = strides[axis];
+		double lower   = u[-stride];
+		double mid     = u[0];
+		double upper   = u[stride];
+		double t_lower = t[axis][0];
+		double t_upper = t[axis][t_strides[axis]];
+		sum += t_upper * (upper - mid) - t_lower * (mid - lower);
+	}
+	return sum;
+}
 /**
  * @brief Implements a variable coefficient Laplacian f=Div[h*Grad[u]]
  *
@@ -44,11 +106,143 @@ template <int D> class StarPatchOperator : public PatchOperator<D>
 {
 	protected:
 	std::shared_ptr<const Vector<D>> coeffs;
+	/**
+	 * @brief The face coefficients of every local patch, empty if they are not cached
+	 *
+	 * For each patch, there is a block for each axis. The block for an axis has ns[axis]+1 faces
+	 * on that axis, and ns cells on the other axes, with the first axis varying fastest.
+	 */
+	std::vector<double> face_coeffs;
+	/**
+	 * @brief The strides of the face coefficient block of each axis
+	 */
+	std::array<std::array<int, D>, D> face_strides;
+	/**
+	 * @brief The offset of the face coefficient block of each axis in a patch
+	 */
+	std::array<int, D> face_offsets;
+	/**
+	 * @brief The number of face coefficients for each patch
+	 */
+	int face_patch_size = 0;
+	/**
+	 * @brief the tile sizes of the fused stencils, see tiled_row_loop
+	 */
+	std::array<int, D> tile_sizes;
 
 	constexpr int addValue(int axis) const
 	{
 		return (axis == 0) ? 0 : 1;
 	}
+	/**
+	 * @brief Set the ghost cells of u on the physical boundaries, and on the interior boundaries
+	 * if they are treated as Dirichlet boundaries
+	 *
+	 * @param pinfo the patch
+	 * @param us the patch that the operator is applied to
+	 * @param treat_interior_boundary_as_dirichlet if true, the ghost cells on the interior
+	 * boundaries are also set
+	 */
+	void setBoundaryGhosts(std::shared_ptr<const PatchInfo<D>> pinfo, const PatchView<D> &us,
+	                       bool treat_interior_boundary_as_dirichlet) const
+	{
+		loop<0, D - 1>([&](int axis) {
+			Side<D> lower_side(axis * 2);
+			Side<D> upper_side(axis * 2 + 1);
+			if (!pinfo->hasNbr(lower_side) || treat_interior_boundary_as_dirichlet) {
+				LocalData<D - 1>       lower = us[0].getGhostSliceOnSide(lower_side, 1);
+				const LocalData<D - 1> mid   = us[0].getSliceOnSide(lower_side);
+				nested_loop<D - 1>(mid.getStart(), mid.getEnd(), [&](std::array<int, D - 1> coord) {
+					lower[coord] = -mid[coord];
+				});
+			}
+			if (!pinfo->hasNbr(upper_side) || treat_interior_boundary_as_dirichlet) {
+				LocalData<D - 1>       upper = us[0].getGhostSliceOnSide(upper_side, 1);
+				const LocalData<D - 1> mid   = us[0].getSliceOnSide(upper_side);
+				nested_loop<D - 1>(mid.getStart(), mid.getEnd(), [&](std::array<int, D - 1> coord) {
+					upper[coord] = -mid[coord];
+				});
+			}
+		});
+	}
+	/**
+	 * @brief Compute the face coefficients of every local patch from the cell centered
+	 * coefficients
+	 */
+	void computeFaceCoeffs()
+	{
+		const std::array<int, D> &ns = this->domain->getNs();
+		face_patch_size              = 0;
+		for (int axis = 0; axis < D; axis++) {
+			int stride = 1;
+			for (int b = 0; b < D; b++) {
+				face_strides[axis][b] = stride;
+				stride *= (b == axis) ? ns[b] + 1 : ns[b];
+			}
+			face_offsets[axis] = face_patch_size;
+			face_patch_size += stride;
+		}
+		face_coeffs.resize(face_patch_size * this->domain->getNumLocalPatches());
+		for (auto pinfo : this->domain->getPatchInfoVector()) {
+			const LocalData<D> c = coeffs->getLocalData(0, pinfo->local_index);
+			double *           t = face_coeffs.data() + pinfo->local_index * face_patch_size;
+			for (int axis = 0; axis < D; axis++) {
+				double             h2    = pinfo->spacings[axis] * pinfo->spacings[axis];
+				std::array<int, D> start = c.getStart();
+				std::array<int, D> end   = c.getEnd();
+				end[axis]++;
+				nested_loop<D>(start, end, [&](const std::array<int, D> &coord) {
+					std::array<int, D> lower_coord = coord;
+					lower_coord[axis]--;
+					int idx = face_offsets[axis];
+					for (int b = 0; b < D; b++) {
+						idx += coord[b] * face_strides[axis][b];
+					}
+					t[idx] = (c[lower_coord] + c[coord]) / (2 * h2);
+				});
+			}
+		}
+	}
+	/**
+	 * @brief Loop over the rows of a patch with the cached face coefficients
+	 *
+	 * The rows are visited tile by tile. The lambda is called with the length of the row, the
+	 * coordinate of the first cell of the row, and pointers to the coefficient of the lower face
+	 * of that cell on each axis.
+	 */
+	template <typename T>
+	void cachedRowLoop(std::shared_ptr<const PatchInfo<D>> pinfo, T lambda) const
+	{
+		const double *     t = face_coeffs.data() + pinfo->local_index * face_patch_size;
+		std::array<int, D> start;
+		std::array<int, D> end;
+		for (int axis = 0; axis < D; axis++) {
+			start[axis] = 0;
+			end[axis]   = pinfo->ns[axis] - 1;
+		}
+		tiled_row_loop<D>(start, end, tile_sizes, [&](const std::array<int, D> &coord, int n) {
+			std::array<const double *, D> t_row;
+			for (int axis = 0; axis < D; axis++) {
+				int idx = face_offsets[axis];
+				for (int b = 0; b < D; b++) {
+					idx += coord[b] * face_strides[axis][b];
+				}
+				t_row[axis] = t + idx;
+			}
+			lambda(n, coord, t_row);
+		});
+	}
+	/**
+	 * @brief The distance from the lower face to the upper face of a cell on each axis
+	 */
+	std::array<int, D> getFaceCoeffStrides() const
+	{
+		std::array<int, D> t_strides;
+		for (int axis = 0; axis < D; axis++) {
+			t_strides[axis] = face_strides[axis][axis];
+		}
+		return t_strides;
+	}
 
 	public:
 	/**
@@ -67,9 +261,12 @@ template <int D> class StarPatchOperator : public PatchOperator<D>
 			throw RuntimeError("StarPatchOperator needs at least one set of ghost cells");
 		}
 		this->ghost_filler->fillGhost(this->coeffs);
+		// the residual uses three planes of u and c, and one of f and r
+		tile_sizes = Tiling::ChooseTileSizes<D>(this->domain->getNs(),
+		                                        this->domain->getNumGhostCells(), 8);
 	}
 	void applySinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                      const std::vector<LocalData<D>> &us, std::vector<LocalData<D>> &fs,
+	                      const PatchView<D> &us, PatchView<D> &fs,
 	                      bool treat_interior_boundary_as_dirichlet) const override
 	{
 		const LocalData<D>    c  = coeffs->getLocalData(0, pinfo->local_index);
@@ -77,23 +274,66 @@ template <int D> class StarPatchOperator : public PatchOperator<D>
 		for (size_t i = 0; i < D; i++) {
 			h2[i] *= h2[i];
 		}
-		loop<0, D - 1>([&](int axis) {
-			Side<D> lower_side(axis * 2);
-			Side<D> upper_side(axis * 2 + 1);
-			if (!pinfo->hasNbr(lower_side) || treat_interior_boundary_as_dirichlet) {
-				LocalData<D - 1>       lower = us[0].getGhostSliceOnSide(lower_side, 1);
-				const LocalData<D - 1> mid   = us[0].getSliceOnSide(lower_side);
-				nested_loop<D - 1>(mid.getStart(), mid.getEnd(), [&](std::array<int, D - 1> coord) {
-					lower[coord] = -mid[coord];
-				});
-			}
-			if (!pinfo->hasNbr(upper_side) || treat_interior_boundary_as_dirichlet) {
-				LocalData<D - 1>       upper = us[0].getGhostSliceOnSide(upper_side, 1);
-				const LocalData<D - 1> mid   = us[0].getSliceOnSide(upper_side);
-				nested_loop<D - 1>(mid.getStart(), mid.getEnd(), [&](std::array<int, D - 1> coord) {
-					upper[coord] = -mid[coord];
-				});
+		setBoundaryGhosts(pinfo, us, treat_interior_boundary_as_dirichlet);
+
+		if (getCachedCoefficients() && rows_are_contiguous(us[0], fs[0])) {
+			std::array<int, D> strides   = us[0].getStrides();
+			std::array<int, D> t_strides = getFaceCoeffStrides();
+			cachedRowLoop(pinfo, [&](int n, const std::array<int, D> &coord,
+			                         std::array<const double *, D> t_row) {
+				const double *u_row = us[0].getPtr(coord);
+				double *      f_row = fs[0].getPtr(coord);
+				for (int i = 0; i < n; i++) {
+					f_row[i] = CachedStarStencil<D>(u_row + i, t_row, strides, t_strides);
+					for (int axis = 0; axis < D; axis++) {
+						t_row[axis]++;
+					}
+				}
+			});
+			return;
+		}
+
+		bool contiguous
+		= c.getStrides()[0] == 1 && us[0].getStrides()[0] == 1 && fs[0].getStrides()[0] == 1;
+		if (contiguous && is_tiled<D>(tile_sizes)) {
+			std::array<int, D> strides   = us[0].getStrides();
+			std::array<int, D> c_strides = c.getStrides();
+			tiled_nested_row_loop<D>(
+			us[0].getStart(), us[0].getEnd(), tile_sizes,
+			[&](int n, const double *u_row, const double *c_row, double *f_row) {
+				for (int i = 0; i < n; i++) {
+					f_row[i] = StarStencil<D>(u_row + i, c_row + i, strides, c_strides, h2);
+				}
+			},
+			us[0], c, fs[0]);
+			return;
+		}
+		if (contiguous) {
+			for (int axis = 0; axis < D; axis++) {
+				int    stride   = us[0].getStrides()[axis];
+				int    c_stride = c.getStrides()[axis];
+				double add      = addValue(axis);
+				nested_row_loop<D>(
+				us[0].getStart(), us[0].getEnd(),
+				[&](int n, const double *u_row, const double *c_row, double *f_row) {
+					for (int i = 0; i < n; i++) {
+						double lower   = u_row[i - stride];
+						double mid     = u_row[i];
+						double upper   = u_row[i + stride];
+						double c_lower = c_row[i - c_stride];
+						double c_mid   = c_row[i];
+						double c_upper = c_row[i + c_stride];
+						f_row[i]
+						= add * f_row[i]
+						  + ((c_upper + c_mid) * (upper - mid) - (c_lower + c_mid) * (mid - lower))
+						    / (2 * h2[axis]);
+					}
+				},
+				us[0], c, fs[0]);
 			}
+			return;
+		}
+		loop<0, D - 1>([&](int axis) {
 			int stride   = us[0].getStrides()[axis];
 			int c_stride = c.getStrides()[axis];
 			nested_loop<D>(us[0].getStart(), us[0].getEnd(), [&](std::array<int, D> coord) {
@@ -112,9 +352,159 @@ template <int D> class StarPatchOperator : public PatchOperator<D>
 			});
 		});
 	}
+	/**
+	 * @brief Compute r = f - A u on a single patch, in one pass over the patch
+	 */
+	void residualSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo, const PatchView<D> &fs,
+	                         const PatchView<D> &us, PatchView<D> &rs) const override
+	{
+		const LocalData<D>    c  = coeffs->getLocalData(0, pinfo->local_index);
+		std::array<double, D> h2 = pinfo->spacings;
+		for (size_t i = 0; i < D; i++) {
+			h2[i] *= h2[i];
+		}
+
+		setBoundaryGhosts(pinfo, us, false);
+
+		std::array<int, D> strides = us[0].getStrides();
+		if (getCachedCoefficients() && rows_are_contiguous(fs[0], us[0], rs[0])) {
+			std::array<int, D> t_strides = getFaceCoeffStrides();
+			cachedRowLoop(pinfo, [&](int n, const std::array<int, D> &coord,
+			                         std::array<const double *, D> t_row) {
+				const double *f_row = fs[0].getPtr(coord);
+				const double *u_row = us[0].getPtr(coord);
+				double *      r_row = rs[0].getPtr(coord);
+				for (int i = 0; i < n; i++) {
+					r_row[i]
+					= f_row[i] - CachedStarStencil<D>(u_row + i, t_row, strides, t_strides);
+					for (int axis = 0; axis < D; axis++) {
+						t_row[axis]++;
+					}
+				}
+			});
+			return;
+		}
+		std::array<int, D> c_strides = c.getStrides();
+		if (rows_are_contiguous(fs[0], us[0], c, rs[0])) {
+			tiled_nested_row_loop<D>(
+			us[0].getStart(), us[0].getEnd(), tile_sizes,
+			[&](int n, const double *f_row, const double *u_row, const double *c_row,
+			    double *r_row) {
+				for (int i = 0; i < n; i++) {
+					r_row[i]
+					= f_row[i] - StarStencil<D>(u_row + i, c_row + i, strides, c_strides, h2);
+				}
+			},
+			fs[0], us[0], c, rs[0]);
+			return;
+		}
+		nested_loop<D>(us[0].getStart(), us[0].getEnd(), [&](const std::array<int, D> &coord) {
+			rs[0][coord] = fs[0][coord]
+			               - StarStencil<D>(us[0].getPtr(coord), c.getPtr(coord), strides,
+			                                c_strides, h2);
+		});
+	}
+	/**
+	 * @brief Set whether the face coefficients are precomputed
+	 *
+	 * The cached face coefficients replace the three coefficient loads, two additions, and two
+	 * divisions per axis per cell with two loads, at the cost of storing about D times as many
+	 * values as the cell centered coefficients. The results differ from the uncached stencil only
+	 * by rounding.
+	 *
+	 * The face coefficients are computed from the current coefficients when this is called with
+	 * true, so it has to be called again if the coefficients are changed. Calling it with false
+	 * frees the cache.
+	 *
+	 * @param cached true to precompute and use the face coefficients
+	 */
+	void setCachedCoefficients(bool cached)
+	{
+		if (cached) {
+			computeFaceCoeffs();
+		} else {
+			face_coeffs.clear();
+			face_coeffs.shrink_to_fit();
+			face_patch_size = 0;
+		}
+	}
+	/**
+	 * @brief Check if the face coefficients are precomputed
+	 */
+	bool getCachedCoefficients() const
+	{
+		return face_patch_size > 0;
+	}
+	/**
+	 * @brief Get the inverse of the diagonal of the operator
+	 *
+	 * The ghost cells on the physical boundaries depend on the cells next to them, so they add to
+	 * the diagonal. The ghost cells on the interior boundaries are filled from the neighbors, and
+	 * are treated as independent. This is the preconditioner of GMG::ChebyshevSmoother.
+	 *
+	 * @param inv_diag the inverse of the diagonal, every component is set
+	 */
+	void getInverseDiagonal(std::shared_ptr<Vector<D>> inv_diag) const
+	{
+		for (auto pinfo : this->domain->getPatchInfoVector()) {
+			const LocalData<D>    c  = coeffs->getLocalData(0, pinfo->local_index);
+			std::array<double, D> h2 = pinfo->spacings;
+			for (size_t i = 0; i < D; i++) {
+				h2[i] *= h2[i];
+			}
+			PatchView<D> lds = inv_diag->getLocalDatas(pinfo->local_index);
+			for (LocalData<D> &ld : lds) {
+				nested_loop<D>(ld.getStart(), ld.getEnd(), [&](const std::array<int, D> &coord) {
+					const double *c_ptr = c.getPtr(coord);
+					double        diag  = 0;
+					for (int axis = 0; axis < D; axis++) {
+						int stride = c.getStrides()[axis];
+						diag -= (c_ptr[-stride] + 2 * c_ptr[0] + c_ptr[stride]) / (2 * h2[axis]);
+					}
+					ld[coord] = diag;
+				});
+				for (Side<D> s : Side<D>::getValues()) {
+					if (!pinfo->hasNbr(s)) {
+						double                 side_h2 = h2[s.getAxisIndex()];
+						LocalData<D - 1>       inner   = ld.getSliceOnSide(s);
+						const LocalData<D - 1> c_ghost = c.getSliceOnSide(s, -1);
+						const LocalData<D - 1> c_inner = c.getSliceOnSide(s);
+						nested_loop<D - 1>(
+						inner.getStart(), inner.getEnd(), [&](const std::array<int, D - 1> &coord) {
+							inner[coord] -= (c_inner[coord] + c_ghost[coord]) / (2 * side_h2);
+						});
+					}
+				}
+				cell_loop<D>(
+				ld.getStart(), ld.getEnd(), [&](double &value) { value = 1 / value; }, ld);
+			}
+		}
+	}
+	/**
+	 * @brief Set the tile sizes of the stencil
+	 *
+	 * If any of the tile sizes is positive, the stencil adds up every axis in one pass over each
+	 * tile (see tiled_row_loop), so that the planes of u and the coefficients that it needs stay
+	 * in cache on large 3D patches. The residual, and the stencil with cached coefficients, are
+	 * always one pass, and are also split into the tiles. The default is chosen from the cache
+	 * size with Tiling::ChooseTileSizes, which does not tile patches that fit.
+	 *
+	 * @param tile_sizes the number of cells in a tile on each axis, 0 to not split that axis
+	 */
+	void setTileSizes(const std::array<int, D> &tile_sizes)
+	{
+		this->tile_sizes = tile_sizes;
+	}
+	/**
+	 * @brief Get the tile sizes of the stencil
+	 */
+	const std::array<int, D> &getTileSizes() const
+	{
+		return tile_sizes;
+	}
 	void addGhostToRHS(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                   const std::vector<LocalData<D>> &   us,
-	                   std::vector<LocalData<D>> &         fs) const override
+	                   const PatchView<D> &                us,
+	                   PatchView<D> &                      fs) const override
 	{
 		const LocalData<D> c = coeffs->getLocalData(0, pinfo->local_index);
 		for (Side<D> s : Side<D>::getValues()) {
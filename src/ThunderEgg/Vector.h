@@ -21,9 +21,12 @@
 
 #ifndef THUNDEREGG_VECTOR_H
 #define THUNDEREGG_VECTOR_H
+#include <ThunderEgg/AsyncReduction.h>
 #include <ThunderEgg/LocalData.h>
 #include <ThunderEgg/Loops.h>
+#include <ThunderEgg/PatchView.h>
 #include <ThunderEgg/Side.h>
+#include <ThunderEgg/Threading.h>
 #include <algorithm>
 #include <cmath>
 #include <memory>
@@ -125,14 +128,13 @@ template <int D> class Vector
 	 * index of LocalData object will correspond to component index
 	 *
 	 * @param patch_local_index the local index of the patch
-	 * @return LocalData<D> the LocalData object
+	 * @return PatchView<D> the LocalData objects
 	 */
-	std::vector<LocalData<D>> getLocalDatas(int patch_local_index)
+	PatchView<D> getLocalDatas(int patch_local_index)
 	{
-		std::vector<LocalData<D>> local_datas;
-		local_datas.reserve(num_components);
+		PatchView<D> local_datas(num_components);
 		for (int c = 0; c < num_components; c++) {
-			local_datas.emplace_back(std::move(getLocalData(c, patch_local_index)));
+			local_datas[c] = getLocalData(c, patch_local_index);
 		}
 		return local_datas;
 	}
@@ -141,18 +143,39 @@ template <int D> class Vector
 	 * index of LocalData object will correspond to component index
 	 *
 	 * @param patch_local_index the local index of the patch
-	 * @return LocalData<D> the LocalData object
+	 * @return PatchView<D> the LocalData objects
 	 */
-	const std::vector<LocalData<D>> getLocalDatas(int patch_local_index) const
+	const PatchView<D> getLocalDatas(int patch_local_index) const
 	{
-		std::vector<LocalData<D>> local_datas;
-		local_datas.reserve(num_components);
+		PatchView<D> local_datas(num_components);
 		for (int c = 0; c < num_components; c++) {
-			local_datas.emplace_back(std::move(getLocalData(c, patch_local_index)));
+			local_datas[c] = getLocalData(c, patch_local_index);
 		}
 		return local_datas;
 	}
 
+	/**
+	 * @brief Check if getLocalData can be called concurrently from multiple threads
+	 *
+	 * If this is false, the operations on this vector will not be threaded.
+	 *
+	 * @return true if getLocalData is thread safe
+	 */
+	virtual bool isThreadSafe() const
+	{
+		return true;
+	}
+	/**
+	 * @brief Get the number of bytes of storage that this vector uses on this rank
+	 *
+	 * This includes ghost cells and any padding. The default returns 0.
+	 *
+	 * @return size_t the number of bytes
+	 */
+	virtual size_t getNumLocalBytes() const
+	{
+		return 0;
+	}
 	/**
 	 * @brief set all value in the vector
 	 *
@@ -160,13 +183,16 @@ template <int D> class Vector
 	 */
 	virtual void set(double alpha)
 	{
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>> lds = getLocalDatas(i);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			PatchView<D> lds = getLocalDatas(i);
 			for (auto &ld : lds) {
-				nested_loop<D>(ld.getStart(), ld.getEnd(),
-				               [&](std::array<int, D> coord) { ld[coord] = alpha; });
+				cell_loop<D>(
+				ld.getStart(), ld.getEnd(), [&](double &value) { value = alpha; }, ld);
 			}
-		}
+		},
+		isThreadSafe());
 	}
 	/**
 	 * @brief set all values in the vector (including ghost cells)
@@ -175,13 +201,16 @@ template <int D> class Vector
 	 */
 	virtual void setWithGhost(double alpha)
 	{
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>> lds = getLocalDatas(i);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			PatchView<D> lds = getLocalDatas(i);
 			for (auto &ld : lds) {
-				nested_loop<D>(ld.getGhostStart(), ld.getGhostEnd(),
-				               [&](std::array<int, D> coord) { ld[coord] = alpha; });
+				cell_loop<D>(
+				ld.getGhostStart(), ld.getGhostEnd(), [&](double &value) { value = alpha; }, ld);
 			}
-		}
+		},
+		isThreadSafe());
 	}
 	/**
 	 * @brief scale all elements in the vector
@@ -190,13 +219,16 @@ template <int D> class Vector
 	 */
 	virtual void scale(double alpha)
 	{
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>> lds = getLocalDatas(i);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			PatchView<D> lds = getLocalDatas(i);
 			for (auto &ld : lds) {
-				nested_loop<D>(ld.getStart(), ld.getEnd(),
-				               [&](std::array<int, D> coord) { ld[coord] *= alpha; });
+				cell_loop<D>(
+				ld.getStart(), ld.getEnd(), [&](double &value) { value *= alpha; }, ld);
 			}
-		}
+		},
+		isThreadSafe());
 	}
 	/**
 	 * @brief shift all the values in the vector
@@ -205,13 +237,16 @@ template <int D> class Vector
 	 */
 	virtual void shift(double delta)
 	{
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>> lds = getLocalDatas(i);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			PatchView<D> lds = getLocalDatas(i);
 			for (auto &ld : lds) {
-				nested_loop<D>(ld.getStart(), ld.getEnd(),
-				               [&](std::array<int, D> coord) { ld[coord] += delta; });
+				cell_loop<D>(
+				ld.getStart(), ld.getEnd(), [&](double &value) { value += delta; }, ld);
 			}
-		}
+		},
+		isThreadSafe());
 	}
 	/**
 	 * @brief copy the values of the other vector
@@ -220,14 +255,18 @@ template <int D> class Vector
 	 */
 	virtual void copy(std::shared_ptr<const Vector<D>> b)
 	{
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>>       lds   = getLocalDatas(i);
-			const std::vector<LocalData<D>> lds_b = b->getLocalDatas(i);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			PatchView<D>       lds   = getLocalDatas(i);
+			const PatchView<D> lds_b = b->getLocalDatas(i);
 			for (int c = 0; c < num_components; c++) {
-				nested_loop<D>(lds[c].getStart(), lds[c].getEnd(),
-				               [&](std::array<int, D> coord) { lds[c][coord] = lds_b[c][coord]; });
+				cell_loop<D>(
+				lds[c].getStart(), lds[c].getEnd(),
+				[&](double &value, const double &b_value) { value = b_value; }, lds[c], lds_b[c]);
 			}
-		}
+		},
+		isThreadSafe() && b->isThreadSafe());
 	}
 	/**
 	 * @brief add the other vector to this vector
@@ -236,29 +275,37 @@ template <int D> class Vector
 	 */
 	virtual void add(std::shared_ptr<const Vector<D>> b)
 	{
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>>       lds   = getLocalDatas(i);
-			const std::vector<LocalData<D>> lds_b = b->getLocalDatas(i);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			PatchView<D>       lds   = getLocalDatas(i);
+			const PatchView<D> lds_b = b->getLocalDatas(i);
 			for (int c = 0; c < num_components; c++) {
-				nested_loop<D>(lds[c].getStart(), lds[c].getEnd(),
-				               [&](std::array<int, D> coord) { lds[c][coord] += lds_b[c][coord]; });
+				cell_loop<D>(
+				lds[c].getStart(), lds[c].getEnd(),
+				[&](double &value, const double &b_value) { value += b_value; }, lds[c], lds_b[c]);
 			}
-		}
+		},
+		isThreadSafe() && b->isThreadSafe());
 	}
 	/**
 	 * @brief `this = this + alpha * b`
 	 */
 	virtual void addScaled(double alpha, std::shared_ptr<const Vector<D>> b)
 	{
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>>       lds   = getLocalDatas(i);
-			const std::vector<LocalData<D>> lds_b = b->getLocalDatas(i);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			PatchView<D>       lds   = getLocalDatas(i);
+			const PatchView<D> lds_b = b->getLocalDatas(i);
 			for (int c = 0; c < num_components; c++) {
-				nested_loop<D>(lds[c].getStart(), lds[c].getEnd(), [&](std::array<int, D> coord) {
-					lds[c][coord] += lds_b[c][coord] * alpha;
-				});
+				cell_loop<D>(
+				lds[c].getStart(), lds[c].getEnd(),
+				[&](double &value, const double &b_value) { value += b_value * alpha; }, lds[c],
+				lds_b[c]);
 			}
-		}
+		},
+		isThreadSafe() && b->isThreadSafe());
 	}
 	/**
 	 * @brief `this = this + alpha * a + beta * b`
@@ -266,46 +313,62 @@ template <int D> class Vector
 	virtual void addScaled(double alpha, std::shared_ptr<const Vector<D>> a, double beta,
 	                       std::shared_ptr<const Vector<D>> b)
 	{
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>>       lds   = getLocalDatas(i);
-			const std::vector<LocalData<D>> lds_a = a->getLocalDatas(i);
-			const std::vector<LocalData<D>> lds_b = b->getLocalDatas(i);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			PatchView<D>       lds   = getLocalDatas(i);
+			const PatchView<D> lds_a = a->getLocalDatas(i);
+			const PatchView<D> lds_b = b->getLocalDatas(i);
 			for (int c = 0; c < num_components; c++) {
-				nested_loop<D>(lds[c].getStart(), lds[c].getEnd(), [&](std::array<int, D> coord) {
-					lds[c][coord] += lds_a[c][coord] * alpha + lds_b[c][coord] * beta;
-				});
+				cell_loop<D>(
+				lds[c].getStart(), lds[c].getEnd(),
+				[&](double &value, const double &a_value, const double &b_value) {
+					value += a_value * alpha + b_value * beta;
+				},
+				lds[c], lds_a[c], lds_b[c]);
 			}
-		}
+		},
+		isThreadSafe() && a->isThreadSafe() && b->isThreadSafe());
 	}
 	/**
 	 * @brief `this = alpha * this + b`
 	 */
 	virtual void scaleThenAdd(double alpha, std::shared_ptr<const Vector<D>> b)
 	{
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>>       lds   = getLocalDatas(i);
-			const std::vector<LocalData<D>> lds_b = b->getLocalDatas(i);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			PatchView<D>       lds   = getLocalDatas(i);
+			const PatchView<D> lds_b = b->getLocalDatas(i);
 			for (int c = 0; c < num_components; c++) {
-				nested_loop<D>(lds[c].getStart(), lds[c].getEnd(), [&](std::array<int, D> coord) {
-					lds[c][coord] = alpha * lds[c][coord] + lds_b[c][coord];
-				});
+				cell_loop<D>(
+				lds[c].getStart(), lds[c].getEnd(),
+				[&](double &value, const double &b_value) { value = alpha * value + b_value; },
+				lds[c], lds_b[c]);
 			}
-		}
+		},
+		isThreadSafe() && b->isThreadSafe());
 	}
 	/**
 	 * @brief `this = alpha * this + beta * b`
 	 */
 	virtual void scaleThenAddScaled(double alpha, double beta, std::shared_ptr<const Vector<D>> b)
 	{
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>>       lds   = getLocalDatas(i);
-			const std::vector<LocalData<D>> lds_b = b->getLocalDatas(i);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			PatchView<D>       lds   = getLocalDatas(i);
+			const PatchView<D> lds_b = b->getLocalDatas(i);
 			for (int c = 0; c < num_components; c++) {
-				nested_loop<D>(lds[c].getStart(), lds[c].getEnd(), [&](std::array<int, D> coord) {
-					lds[c][coord] = alpha * lds[c][coord] + beta * lds_b[c][coord];
-				});
+				cell_loop<D>(
+				lds[c].getStart(), lds[c].getEnd(),
+				[&](double &value, const double &b_value) {
+					value = alpha * value + beta * b_value;
+				},
+				lds[c], lds_b[c]);
 			}
-		}
+		},
+		isThreadSafe() && b->isThreadSafe());
 	}
 	/**
 	 * @brief `this = alpha * this + beta * b + gamma * c`
@@ -313,32 +376,95 @@ template <int D> class Vector
 	virtual void scaleThenAddScaled(double alpha, double beta, std::shared_ptr<const Vector<D>> b,
 	                                double gamma, std::shared_ptr<const Vector<D>> c)
 	{
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>>       lds   = getLocalDatas(i);
-			const std::vector<LocalData<D>> lds_b = b->getLocalDatas(i);
-			const std::vector<LocalData<D>> lds_c = c->getLocalDatas(i);
+		Threading::ParallelFor(
+		num_local_patches,
+		[&](int i) {
+			PatchView<D>       lds   = getLocalDatas(i);
+			const PatchView<D> lds_b = b->getLocalDatas(i);
+			const PatchView<D> lds_c = c->getLocalDatas(i);
 			for (int comp = 0; comp < num_components; comp++) {
-				nested_loop<D>(
-				lds[comp].getStart(), lds[comp].getEnd(), [&](std::array<int, D> coord) {
-					lds[comp][coord] = alpha * lds[comp][coord] + beta * lds_b[comp][coord]
-					                   + gamma * lds_c[comp][coord];
-				});
+				cell_loop<D>(
+				lds[comp].getStart(), lds[comp].getEnd(),
+				[&](double &value, const double &b_value, const double &c_value) {
+					value = alpha * value + beta * b_value + gamma * c_value;
+				},
+				lds[comp], lds_b[comp], lds_c[comp]);
 			}
-		}
+		},
+		isThreadSafe() && b->isThreadSafe() && c->isThreadSafe());
 	}
 	/**
-	 * @brief get the l2norm
+	 * @brief get the sum of the squares of the values in the local patches, without any
+	 * communication
+	 *
+	 * The result does not depend on the number of threads.
 	 */
-	virtual double twoNorm() const
+	virtual double localTwoNormSquared() const
 	{
-		double sum = 0;
-		for (int i = 0; i < num_local_patches; i++) {
-			const std::vector<LocalData<D>> lds = getLocalDatas(i);
+		return Threading::ParallelSum(
+		num_local_patches,
+		[&](int i) {
+			double             patch_sum = 0;
+			const PatchView<D> lds       = getLocalDatas(i);
 			for (const auto &ld : lds) {
-				nested_loop<D>(ld.getStart(), ld.getEnd(),
-				               [&](std::array<int, D> coord) { sum += ld[coord] * ld[coord]; });
+				cell_loop<D>(
+				ld.getStart(), ld.getEnd(),
+				[&](const double &value) { patch_sum += value * value; }, ld);
 			}
-		}
+			return patch_sum;
+		},
+		isThreadSafe());
+	}
+	/**
+	 * @brief get the infnorm of the local patches, without any communication
+	 */
+	virtual double localInfNorm() const
+	{
+		return Threading::ParallelMax(
+		num_local_patches,
+		[&](int i) {
+			double             patch_max = 0;
+			const PatchView<D> lds       = getLocalDatas(i);
+			for (const auto &ld : lds) {
+				cell_loop<D>(
+				ld.getStart(), ld.getEnd(),
+				[&](const double &value) { patch_max = fmax(fabs(value), patch_max); }, ld);
+			}
+			return patch_max;
+		},
+		isThreadSafe());
+	}
+	/**
+	 * @brief get the dot product of the local patches, without any communication
+	 *
+	 * The result does not depend on the number of threads.
+	 */
+	virtual double localDot(std::shared_ptr<const Vector<D>> b) const
+	{
+		return Threading::ParallelSum(
+		num_local_patches,
+		[&](int i) {
+			double             patch_sum = 0;
+			const PatchView<D> lds       = getLocalDatas(i);
+			const PatchView<D> lds_b     = b->getLocalDatas(i);
+			for (int c = 0; c < num_components; c++) {
+				cell_loop<D>(
+				lds[c].getStart(), lds[c].getEnd(),
+				[&](const double &value, const double &b_value) { patch_sum += value * b_value; },
+				lds[c], lds_b[c]);
+			}
+			return patch_sum;
+		},
+		isThreadSafe() && b->isThreadSafe());
+	}
+	/**
+	 * @brief get the l2norm
+	 *
+	 * The result does not depend on the number of threads.
+	 */
+	virtual double twoNorm() const
+	{
+		double sum = localTwoNormSquared();
 		double global_sum;
 		MPI_Allreduce(&sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, comm);
 		return sqrt(global_sum);
@@ -348,37 +474,56 @@ template <int D> class Vector
 	 */
 	virtual double infNorm() const
 	{
-		double max = 0;
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>> lds = getLocalDatas(i);
-			for (const auto &ld : lds) {
-				nested_loop<D>(ld.getStart(), ld.getEnd(),
-				               [&](std::array<int, D> coord) { max = fmax(fabs(ld[coord]), max); });
-			}
-		}
+		double max = localInfNorm();
 		double global_max;
 		MPI_Allreduce(&max, &global_max, 1, MPI_DOUBLE, MPI_MAX, comm);
 		return global_max;
 	}
 	/**
 	 * @brief get the dot product
+	 *
+	 * The result does not depend on the number of threads.
 	 */
 	virtual double dot(std::shared_ptr<const Vector<D>> b) const
 	{
-		double retval = 0;
-		for (int i = 0; i < num_local_patches; i++) {
-			std::vector<LocalData<D>>       lds   = getLocalDatas(i);
-			const std::vector<LocalData<D>> lds_b = b->getLocalDatas(i);
-			for (int c = 0; c < num_components; c++) {
-				nested_loop<D>(lds[c].getStart(), lds[c].getEnd(), [&](std::array<int, D> coord) {
-					retval += lds[c][coord] * lds_b[c][coord];
-				});
-			}
-		}
+		double retval = localDot(b);
 		double global_retval;
 		MPI_Allreduce(&retval, &global_retval, 1, MPI_DOUBLE, MPI_SUM, comm);
 		return global_retval;
 	}
+	/**
+	 * @brief start computing the l2norm, without waiting for the global reduction
+	 *
+	 * The local part is computed before this returns, so the vector can be modified afterwards.
+	 *
+	 * @return AsyncReduction call finish() on this to get the norm
+	 */
+	AsyncReduction twoNormStart() const
+	{
+		return AsyncReduction::TwoNorm(localTwoNormSquared(), comm);
+	}
+	/**
+	 * @brief start computing the infnorm, without waiting for the global reduction
+	 *
+	 * The local part is computed before this returns, so the vector can be modified afterwards.
+	 *
+	 * @return AsyncReduction call finish() on this to get the norm
+	 */
+	AsyncReduction infNormStart() const
+	{
+		return AsyncReduction::Max(localInfNorm(), comm);
+	}
+	/**
+	 * @brief start computing the dot product, without waiting for the global reduction
+	 *
+	 * The local part is computed before this returns, so the vectors can be modified afterwards.
+	 *
+	 * @return AsyncReduction call finish() on this to get the dot product
+	 */
+	AsyncReduction dotStart(std::shared_ptr<const Vector<D>> b) const
+	{
+		return AsyncReduction::Sum(localDot(b), comm);
+	}
 };
 extern template class Vector<1>;
 extern template class Vector<2>;
@@ -0,0 +1,437 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#ifndef THUNDEREGG_VECTOREXPRESSION_H
+#define THUNDEREGG_VECTOREXPRESSION_H
+#include <ThunderEgg/ReductionBatch.h>
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/Threading.h>
+#include <ThunderEgg/Vector.h>
+#include <memory>
+#include <type_traits>
+namespace ThunderEgg
+{
+/**
+ * @brief A vector in a vector expression
+ *
+ * Vector expressions are linear combinations of vectors that are built with the +, - and scalar *
+ * operators on std::shared_ptr<Vector<D>>. They are not evaluated until they are passed to
+ * assign(), which evaluates the whole expression in one pass over each patch.
+ *
+ * 		assign(p, beta * (p - omega * ap) + resid);
+ *
+ * An expression node has to provide the following:
+ * 	- check(target) throws a RuntimeError if a vector is incompatible with the target
+ * 	- isThreadSafe() is true if all of the vectors are thread safe
+ * 	- bind(c, i, target, target_ld) gets the LocalData for component c of patch i
+ * 	- hasUnitStride() is true if all of the bound LocalData have a unit stride along the first axis
+ * 	- setRow(coord) sets the row that is being evaluated
+ * 	- eval<UnitStride>(i) gets the value of the ith cell in the row
+ *
+ * @tparam D the number of Cartesian dimensions
+ */
+template <int D> class VectorLeafExpression
+{
+	private:
+	/**
+	 * @brief the vector
+	 */
+	std::shared_ptr<const Vector<D>> vec;
+	/**
+	 * @brief the LocalData of the bound component and patch
+	 */
+	LocalData<D> ld;
+	/**
+	 * @brief pointer to the first value in the current row
+	 */
+	const double *row = nullptr;
+	/**
+	 * @brief the stride along the first axis
+	 */
+	int stride = 1;
+
+	public:
+	/**
+	 * @brief Construct a new VectorLeafExpression object
+	 *
+	 * @param vec the vector
+	 */
+	explicit VectorLeafExpression(std::shared_ptr<const Vector<D>> vec) : vec(vec)
+	{
+		if (vec == nullptr) {
+			throw RuntimeError("Vector expression was given a null vector");
+		}
+	}
+	void check(const Vector<D> &target) const
+	{
+		if (vec->getNumLocalPatches() != target.getNumLocalPatches()
+		    || vec->getNumComponents() != target.getNumComponents()) {
+			throw RuntimeError("Vector expression has vectors with different layouts");
+		}
+	}
+	bool isThreadSafe() const
+	{
+		return vec->isThreadSafe();
+	}
+	void bind(int component_index, int patch_local_index, const Vector<D> *target,
+	          const LocalData<D> &target_ld)
+	{
+		// reuse the LocalData of the target, so that a vector is not accessed twice at once
+		if (vec.get() == target) {
+			ld = target_ld;
+		} else {
+			ld = vec->getLocalData(component_index, patch_local_index);
+		}
+		stride = ld.getStrides()[0];
+	}
+	bool hasUnitStride() const
+	{
+		return stride == 1;
+	}
+	void setRow(const std::array<int, D> &coord)
+	{
+		row = ld.getPtr(coord);
+	}
+	template <bool UnitStride> double eval(int i) const
+	{
+		return UnitStride ? row[i] : row[i * stride];
+	}
+};
+/**
+ * @brief A vector expression multiplied by a scalar
+ *
+ * @tparam E the type of the expression
+ */
+template <typename E> class ScaledVectorExpression
+{
+	private:
+	/**
+	 * @brief the scalar
+	 */
+	double alpha;
+	/**
+	 * @brief the expression
+	 */
+	E expr;
+
+	public:
+	/**
+	 * @brief Construct a new ScaledVectorExpression object
+	 *
+	 * @param alpha the scalar
+	 * @param expr the expression
+	 */
+	ScaledVectorExpression(double alpha, const E &expr) : alpha(alpha), expr(expr) {}
+	template <int D> void check(const Vector<D> &target) const
+	{
+		expr.check(target);
+	}
+	bool isThreadSafe() const
+	{
+		return expr.isThreadSafe();
+	}
+	template <int D>
+	void bind(int component_index, int patch_local_index, const Vector<D> *target,
+	          const LocalData<D> &target_ld)
+	{
+		expr.bind(component_index, patch_local_index, target, target_ld);
+	}
+	bool hasUnitStride() const
+	{
+		return expr.hasUnitStride();
+	}
+	template <size_t D> void setRow(const std::array<int, D> &coord)
+	{
+		expr.setRow(coord);
+	}
+	template <bool UnitStride> double eval(int i) const
+	{
+		return alpha * expr.template eval<UnitStride>(i);
+	}
+};
+/**
+ * @brief The sum of two vector expressions
+ *
+ * @tparam L the type of the left expression
+ * @tparam R the type of the right expression
+ */
+template <typename L, typename R> class SumVectorExpression
+{
+	private:
+	/**
+	 * @brief the left expression
+	 */
+	L left;
+	/**
+	 * @brief the right expression
+	 */
+	R right;
+
+	public:
+	/**
+	 * @brief Construct a new SumVectorExpression object
+	 *
+	 * @param left the left expression
+	 * @param right the right expression
+	 */
+	SumVectorExpression(const L &left, const R &right) : left(left), right(right) {}
+	template <int D> void check(const Vector<D> &target) const
+	{
+		left.check(target);
+		right.check(target);
+	}
+	bool isThreadSafe() const
+	{
+		return left.isThreadSafe() && right.isThreadSafe();
+	}
+	template <int D>
+	void bind(int component_index, int patch_local_index, const Vector<D> *target,
+	          const LocalData<D> &target_ld)
+	{
+		left.bind(component_index, patch_local_index, target, target_ld);
+		right.bind(component_index, patch_local_index, target, target_ld);
+	}
+	bool hasUnitStride() const
+	{
+		return left.hasUnitStride() && right.hasUnitStride();
+	}
+	template <size_t D> void setRow(const std::array<int, D> &coord)
+	{
+		left.setRow(coord);
+		right.setRow(coord);
+	}
+	template <bool UnitStride> double eval(int i) const
+	{
+		return left.template eval<UnitStride>(i) + right.template eval<UnitStride>(i);
+	}
+};
+/**
+ * @brief Converts the operands of the vector expression operators to expression nodes
+ *
+ * Only vectors and expression nodes are operands, so the operators do not match anything else.
+ */
+template <typename T> struct VectorExpressionTraits {
+	static constexpr bool IsExpression = false;
+};
+template <int D> struct VectorExpressionTraits<std::shared_ptr<Vector<D>>> {
+	static constexpr bool IsExpression = true;
+	using Type                         = VectorLeafExpression<D>;
+	static Type Get(const std::shared_ptr<Vector<D>> &vec)
+	{
+		return Type(vec);
+	}
+};
+template <int D> struct VectorExpressionTraits<std::shared_ptr<const Vector<D>>> {
+	static constexpr bool IsExpression = true;
+	using Type                         = VectorLeafExpression<D>;
+	static Type Get(const std::shared_ptr<const Vector<D>> &vec)
+	{
+		return Type(vec);
+	}
+};
+template <int D> struct VectorExpressionTraits<VectorLeafExpression<D>> {
+	static constexpr bool IsExpression = true;
+	using Type                         = VectorLeafExpression<D>;
+	static const Type &Get(const Type &expr)
+	{
+		return expr;
+	}
+};
+template <typename E> struct VectorExpressionTraits<ScaledVectorExpression<E>> {
+	static constexpr bool IsExpression = true;
+	using Type                         = ScaledVectorExpression<E>;
+	static const Type &Get(const Type &expr)
+	{
+		return expr;
+	}
+};
+template <typename L, typename R> struct VectorExpressionTraits<SumVectorExpression<L, R>> {
+	static constexpr bool IsExpression = true;
+	using Type                         = SumVectorExpression<L, R>;
+	static const Type &Get(const Type &expr)
+	{
+		return expr;
+	}
+};
+/**
+ * @brief the expression node type of an operand
+ */
+template <typename T>
+using VectorExpressionType =
+typename std::enable_if<VectorExpressionTraits<T>::IsExpression,
+                        typename VectorExpressionTraits<T>::Type>::type;
+/**
+ * @brief `a + b`
+ */
+template <typename A, typename B>
+SumVectorExpression<VectorExpressionType<A>, VectorExpressionType<B>> operator+(const A &a,
+                                                                               const B &b)
+{
+	return SumVectorExpression<VectorExpressionType<A>, VectorExpressionType<B>>(
+	VectorExpressionTraits<A>::Get(a), VectorExpressionTraits<B>::Get(b));
+}
+/**
+ * @brief `alpha * a`
+ */
+template <typename A>
+ScaledVectorExpression<VectorExpressionType<A>> operator*(double alpha, const A &a)
+{
+	return ScaledVectorExpression<VectorExpressionType<A>>(alpha,
+	                                                       VectorExpressionTraits<A>::Get(a));
+}
+/**
+ * @brief `a * alpha`
+ */
+template <typename A>
+ScaledVectorExpression<VectorExpressionType<A>> operator*(const A &a, double alpha)
+{
+	return alpha * a;
+}
+/**
+ * @brief `-a`
+ */
+template <typename A> ScaledVectorExpression<VectorExpressionType<A>> operator-(const A &a)
+{
+	return -1.0 * a;
+}
+/**
+ * @brief `a - b`
+ */
+template <typename A, typename B>
+SumVectorExpression<VectorExpressionType<A>, ScaledVectorExpression<VectorExpressionType<B>>>
+operator-(const A &a, const B &b)
+{
+	return a + (-1.0 * b);
+}
+/**
+ * @brief Evaluate an expression for each cell of a patch, and store the result in the target
+ *
+ * @param target the target vector
+ * @param expr the expression, a copy is bound to the patch
+ * @param patch_local_index the local index of the patch
+ */
+template <int D, typename E>
+void AssignPatch(Vector<D> &target, E expr, int patch_local_index)
+{
+	for (int c = 0; c < target.getNumComponents(); c++) {
+		LocalData<D> ld = target.getLocalData(c, patch_local_index);
+		expr.bind(c, patch_local_index, &target, ld);
+
+		int n      = ld.getLengths()[0];
+		int stride = ld.getStrides()[0];
+		if (stride == 1 && expr.hasUnitStride()) {
+			row_loop<D>(ld.getStart(), ld.getEnd(), [&](const std::array<int, D> &coord) {
+				double *row = ld.getPtr(coord);
+				expr.setRow(coord);
+				for (int i = 0; i < n; i++) {
+					row[i] = expr.template eval<true>(i);
+				}
+			});
+		} else {
+			row_loop<D>(ld.getStart(), ld.getEnd(), [&](const std::array<int, D> &coord) {
+				double *row = ld.getPtr(coord);
+				expr.setRow(coord);
+				for (int i = 0; i < n; i++) {
+					row[i * stride] = expr.template eval<false>(i);
+				}
+			});
+		}
+	}
+}
+/**
+ * @brief Evaluate a vector expression and store the result in the target, `target = expr`
+ *
+ * The whole expression is evaluated in one pass over each patch. The target can appear in the
+ * expression.
+ *
+ * @param target the target vector
+ * @param expr the expression, or a vector
+ */
+template <int D, typename E> void assign(std::shared_ptr<Vector<D>> target, const E &expr)
+{
+	VectorExpressionType<E> node = VectorExpressionTraits<E>::Get(expr);
+	node.check(*target);
+	Threading::ParallelFor(
+	target->getNumLocalPatches(), [&](int i) { AssignPatch(*target, node, i); },
+	target->isThreadSafe() && node.isThreadSafe());
+}
+/**
+ * @brief Evaluate a vector expression, store the result in the target, and then start evaluating
+ * a ReductionBatch
+ *
+ * This is the same as assign(target, expr, batch), except that it does not wait for the global
+ * reductions. batch.evaluateFinish() has to be called before the results can be used.
+ *
+ * 		ReductionBatch<2> batch;
+ * 		int resid_norm = batch.addTwoNorm(resid);
+ * 		assignStart(resid, resid - alpha * ap, batch);
+ * 		assign(x, x + alpha * p);
+ * 		batch.evaluateFinish();
+ * 		double norm = batch.getResult(resid_norm);
+ *
+ * This is a collective call over the MPI_Comm of the vectors.
+ *
+ * @param target the target vector
+ * @param expr the expression, or a vector
+ * @param batch the batch to evaluate, the vectors have to have the same layout as the target
+ */
+template <int D, typename E>
+void assignStart(std::shared_ptr<Vector<D>> target, const E &expr, ReductionBatch<D> &batch)
+{
+	if (batch.getNumReductions() == 0) {
+		assign(target, expr);
+		batch.evaluateStart();
+		return;
+	}
+	if (batch.getNumLocalPatches() != target->getNumLocalPatches()) {
+		throw RuntimeError("ReductionBatch has vectors with a different layout than the target");
+	}
+	VectorExpressionType<E> node = VectorExpressionTraits<E>::Get(expr);
+	node.check(*target);
+	batch.evaluateStart([&](int i) { AssignPatch(*target, node, i); },
+	                    target->isThreadSafe() && node.isThreadSafe());
+}
+/**
+ * @brief Evaluate a vector expression, store the result in the target, and then evaluate a
+ * ReductionBatch
+ *
+ * The reductions of each patch are computed right after the expression is stored in the patch,
+ * so that reductions involving the target read the new values while they are still in cache.
+ *
+ * 		ReductionBatch<2> batch;
+ * 		int resid_norm = batch.addTwoNorm(resid);
+ * 		assign(resid, resid - alpha * ap, batch);
+ * 		double norm = batch.getResult(resid_norm);
+ *
+ * This is a collective call over the MPI_Comm of the vectors.
+ *
+ * @param target the target vector
+ * @param expr the expression, or a vector
+ * @param batch the batch to evaluate, the vectors have to have the same layout as the target
+ */
+template <int D, typename E>
+void assign(std::shared_ptr<Vector<D>> target, const E &expr, ReductionBatch<D> &batch)
+{
+	assignStart(target, expr, batch);
+	batch.evaluateFinish();
+}
+} // namespace ThunderEgg
+#endif
@@ -0,0 +1,82 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "catch.hpp"
+#include <ThunderEgg/AsyncReduction.h>
+#include <ThunderEgg/RuntimeError.h>
+#include <cmath>
+#include <utility>
+using namespace std;
+using namespace ThunderEgg;
+TEST_CASE("AsyncReduction Sum", "[AsyncReduction]")
+{
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	AsyncReduction sum = AsyncReduction::Sum(rank + 1, MPI_COMM_WORLD);
+	CHECK(sum.finish() == 3);
+	// later calls return the same result
+	CHECK(sum.finish() == 3);
+	CHECK(sum.test());
+}
+TEST_CASE("AsyncReduction TwoNorm", "[AsyncReduction]")
+{
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	AsyncReduction norm = AsyncReduction::TwoNorm((rank + 1) * (rank + 1), MPI_COMM_WORLD);
+	CHECK(norm.finish() == Approx(sqrt(5)));
+}
+TEST_CASE("AsyncReduction Max", "[AsyncReduction]")
+{
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	AsyncReduction max = AsyncReduction::Max(-rank, MPI_COMM_WORLD);
+	CHECK(max.finish() == 0);
+}
+TEST_CASE("AsyncReduction overlapping reductions", "[AsyncReduction]")
+{
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	AsyncReduction first  = AsyncReduction::Sum(rank, MPI_COMM_WORLD);
+	AsyncReduction second = AsyncReduction::Max(rank, MPI_COMM_WORLD);
+	CHECK(second.finish() == 1);
+	CHECK(first.finish() == 1);
+}
+TEST_CASE("AsyncReduction move", "[AsyncReduction]")
+{
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	AsyncReduction sum   = AsyncReduction::Sum(rank + 1, MPI_COMM_WORLD);
+	AsyncReduction moved = std::move(sum);
+	CHECK_THROWS_AS(sum.finish(), RuntimeError);
+	CHECK(moved.finish() == 3);
+
+	// the reduction that is replaced is waited for
+	moved = AsyncReduction::Max(rank, MPI_COMM_WORLD);
+	CHECK(moved.finish() == 1);
+}
+TEST_CASE("AsyncReduction destroyed without finish", "[AsyncReduction]")
+{
+	{
+		AsyncReduction sum = AsyncReduction::Sum(1, MPI_COMM_WORLD);
+	}
+	AsyncReduction sum = AsyncReduction::Sum(1, MPI_COMM_WORLD);
+	CHECK(sum.finish() == 2);
+}
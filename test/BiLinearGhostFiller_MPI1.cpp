@@ -1,6 +1,7 @@
 #include "utils/DomainReader.h"
 #include <ThunderEgg/BiLinearGhostFiller.h>
 #include <ThunderEgg/DomainTools.h>
+#include <ThunderEgg/RuntimeError.h>
 #include <ThunderEgg/ValVectorGenerator.h>
 
 #include "catch.hpp"
@@ -513,4 +514,13 @@ TEST_CASE("exchange various meshes 2D BiLinearGhostFiller ghost already set two
 			}
 		}
 	}
-}
\ No newline at end of file
+}
+TEST_CASE("BiLinearGhostFiller fill corners throws with refined mesh", "[BiLinearGhostFiller]")
+{
+	DomainReader<2>       domain_reader(refined_mesh_file, {4, 4}, 2);
+	shared_ptr<Domain<2>> d = domain_reader.getFinerDomain();
+
+	BiLinearGhostFiller blgf(d);
+	CHECK_THROWS_AS(blgf.setFillCorners(true), RuntimeError);
+	CHECK_FALSE(blgf.getFillCorners());
+}
@@ -117,4 +117,109 @@ TEST_CASE("exchange various meshes 2D BiLinearGhostFiller ghost already set",
 			}
 		}
 	}
-}
\ No newline at end of file
+}
+TEST_CASE("exchange various meshes 2D BiLinearGhostFiller two ghost layers",
+          "[BiLinearGhostFiller]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, uniform, refined);
+	INFO("MESH: " << mesh_file);
+	auto nx        = GENERATE(2, 10);
+	auto ny        = GENERATE(2, 10);
+	int  num_ghost = 2;
+
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d = domain_reader.getFinerDomain();
+
+	shared_ptr<ValVector<2>> vec      = ValVector<2>::GetNewVector(d, 1);
+	shared_ptr<ValVector<2>> expected = ValVector<2>::GetNewVector(d, 1);
+
+	auto f = [&](const std::array<double, 2> coord) -> double {
+		double x = coord[0];
+		double y = coord[1];
+		return 1 + ((x * 0.3) + y);
+	};
+
+	// the ghost cells of normal neighbors are overwritten, not added to
+	vec->setWithGhost(100);
+	DomainTools::SetValues<2>(d, vec, f);
+	DomainTools::SetValuesWithGhost<2>(d, expected, f);
+
+	BiLinearGhostFiller blgf(d);
+	blgf.fillGhost(vec);
+
+	for (auto pinfo : d->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<2> vec_ld      = vec->getLocalData(0, pinfo->local_index);
+		LocalData<2> expected_ld = expected->getLocalData(0, pinfo->local_index);
+		for (Side<2> s : Side<2>::getValues()) {
+			if (pinfo->hasNbr(s)) {
+				INFO("side:      " << s);
+				INFO("nbr-type:  " << pinfo->getNbrType(s));
+				// every layer is copied from normal neighbors
+				int num_layers = pinfo->getNbrType(s) == NbrType::Normal ? num_ghost : 1;
+				for (int layer = 1; layer <= num_layers; layer++) {
+					INFO("layer:  " << layer);
+					LocalData<1> vec_ghost      = vec_ld.getGhostSliceOnSide(s, layer);
+					LocalData<1> expected_ghost = expected_ld.getGhostSliceOnSide(s, layer);
+					nested_loop<1>(vec_ghost.getStart(), vec_ghost.getEnd(),
+					               [&](const array<int, 1> &coord) {
+						               INFO("coord:  " << coord[0]);
+						               CHECK(vec_ghost[coord] == Approx(expected_ghost[coord]));
+					               });
+				}
+			}
+		}
+	}
+}
+TEST_CASE("exchange uniform mesh 2D BiLinearGhostFiller fill corners", "[BiLinearGhostFiller]")
+{
+	auto nx        = GENERATE(2, 10);
+	auto ny        = GENERATE(2, 10);
+	auto num_ghost = GENERATE(1, 2);
+	auto neighbor  = GENERATE(false, true);
+
+	DomainReader<2>       domain_reader(uniform, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d = domain_reader.getFinerDomain();
+
+	shared_ptr<ValVector<2>> vec      = ValVector<2>::GetNewVector(d, 2);
+	shared_ptr<ValVector<2>> expected = ValVector<2>::GetNewVector(d, 2);
+
+	auto f = [&](const std::array<double, 2> coord) -> double {
+		double x = coord[0];
+		double y = coord[1];
+		return 1 + ((x * 0.3) + y);
+	};
+
+	vec->setWithGhost(100);
+	DomainTools::SetValues<2>(d, vec, f, f);
+	DomainTools::SetValuesWithGhost<2>(d, expected, f, f);
+
+	BiLinearGhostFiller blgf(d);
+	blgf.setUseNeighborCollectives(neighbor);
+	blgf.setFillCorners(true);
+	CHECK(blgf.getFillCorners());
+	blgf.fillGhost(vec);
+
+	for (auto pinfo : d->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		for (int c = 0; c < 2; c++) {
+			LocalData<2> vec_ld      = vec->getLocalData(c, pinfo->local_index);
+			LocalData<2> expected_ld = expected->getLocalData(c, pinfo->local_index);
+			nested_loop<2>(vec_ld.getGhostStart(), vec_ld.getGhostEnd(),
+			               [&](const array<int, 2> &coord) {
+				               // only check the cells that are inside of the domain
+				               for (int axis = 0; axis < 2; axis++) {
+					               if ((coord[axis] < 0
+					                    && !pinfo->hasNbr(Side<2>::LowerSideOnAxis(axis)))
+					                   || (coord[axis] >= pinfo->ns[axis]
+					                       && !pinfo->hasNbr(Side<2>::HigherSideOnAxis(axis)))) {
+						               return;
+					               }
+				               }
+				               INFO("xi:    " << coord[0]);
+				               INFO("yi:    " << coord[1]);
+				               CHECK(vec_ld[coord] == Approx(expected_ld[coord]));
+			               });
+		}
+	}
+}
@@ -1,6 +1,7 @@
 #include "utils/DomainReader.h"
 #include <ThunderEgg/BiLinearGhostFiller.h>
 #include <ThunderEgg/DomainTools.h>
+#include <ThunderEgg/SharedValVector.h>
 #include <ThunderEgg/ValVector.h>
 
 #include "catch.hpp"
@@ -117,4 +118,52 @@ TEST_CASE("exchange various meshes 2D BiLinearGhostFiller ghost already set",
 			}
 		}
 	}
-}
\ No newline at end of file
+}
+TEST_CASE("exchange various meshes 2D BiLinearGhostFiller with shared memory",
+          "[BiLinearGhostFiller]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, uniform, refined);
+	INFO("MESH: " << mesh_file);
+	auto nx        = GENERATE(2, 10);
+	auto ny        = GENERATE(2, 10);
+	int  num_ghost = 1;
+
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d = domain_reader.getFinerDomain();
+
+	auto                     shared_comm = make_shared<SharedMemoryComm>(MPI_COMM_WORLD);
+	auto                     vec         = SharedValVector<2>::GetNewVector(shared_comm, d, 1);
+	shared_ptr<ValVector<2>> expected    = ValVector<2>::GetNewVector(d, 1);
+
+	auto f = [&](const std::array<double, 2> coord) -> double {
+		double x = coord[0];
+		double y = coord[1];
+		return 1 + ((x * 0.3) + y);
+	};
+
+	DomainTools::SetValues<2>(d, vec, f);
+	DomainTools::SetValuesWithGhost<2>(d, expected, f);
+
+	BiLinearGhostFiller blgf(d);
+	blgf.setUseSharedMemory(shared_comm);
+	blgf.fillGhost(vec);
+
+	for (auto pinfo : d->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<2> vec_ld      = vec->getLocalData(0, pinfo->local_index);
+		LocalData<2> expected_ld = expected->getLocalData(0, pinfo->local_index);
+		for (Side<2> s : Side<2>::getValues()) {
+			LocalData<1> vec_ghost      = vec_ld.getGhostSliceOnSide(s, 1);
+			LocalData<1> expected_ghost = expected_ld.getGhostSliceOnSide(s, 1);
+			if (pinfo->hasNbr(s)) {
+				INFO("side:      " << s);
+				INFO("nbr-type:  " << pinfo->getNbrType(s));
+				nested_loop<1>(vec_ghost.getStart(), vec_ghost.getEnd(),
+				               [&](const array<int, 1> &coord) {
+					               INFO("coord:  " << coord[0]);
+					               CHECK(vec_ghost[coord] == Approx(expected_ghost[coord]));
+				               });
+			}
+		}
+	}
+}
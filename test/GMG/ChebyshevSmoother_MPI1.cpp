@@ -0,0 +1,189 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "../utils/DomainReader.h"
+#include "catch.hpp"
+#include <ThunderEgg/BiLinearGhostFiller.h>
+#include <ThunderEgg/DomainTools.h>
+#include <ThunderEgg/GMG/ChebyshevSmoother.h>
+#include <ThunderEgg/Poisson/StarPatchOperator.h>
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/ValVectorGenerator.h>
+#include <ThunderEgg/VarPoisson/StarPatchOperator.h>
+using namespace std;
+using namespace ThunderEgg;
+#define MESHES                                                                                     \
+	"mesh_inputs/2d_uniform_2x2_mpi1.json", "mesh_inputs/2d_uniform_2x2_refined_nw_mpi1.json",     \
+	"mesh_inputs/2d_uniform_8x8_refined_cross_mpi1.json"
+namespace
+{
+auto ffun = [](const std::array<double, 2> &coord) {
+	double x = coord[0];
+	double y = coord[1];
+	return -5 * M_PI * M_PI * sin(M_PI * y) * cos(2 * M_PI * x);
+};
+auto hfun = [](const std::array<double, 2> &coord) {
+	double x = coord[0];
+	double y = coord[1];
+	return 1 + 10 * x * y * y;
+};
+} // namespace
+TEST_CASE("GMG::ChebyshevSmoother throws with invalid parameters", "[GMG::ChebyshevSmoother]")
+{
+	DomainReader<2>       domain_reader("mesh_inputs/2d_uniform_2x2_mpi1.json", {4, 4}, 1);
+	shared_ptr<Domain<2>> d = domain_reader.getFinerDomain();
+
+	auto gf       = make_shared<BiLinearGhostFiller>(d);
+	auto op       = make_shared<Poisson::StarPatchOperator<2>>(d, gf);
+	auto vg       = make_shared<ValVectorGenerator<2>>(d, 1);
+	auto inv_diag = vg->getNewVector();
+	op->getInverseDiagonal(inv_diag);
+
+	CHECK_THROWS_AS(GMG::ChebyshevSmoother<2>(op, inv_diag, vg, 0), RuntimeError);
+	CHECK_THROWS_AS(GMG::ChebyshevSmoother<2>(op, inv_diag, vg, 2, 0), RuntimeError);
+	CHECK_THROWS_AS(GMG::ChebyshevSmoother<2>(op, inv_diag, vg, 2, 10, 0, 1.1), RuntimeError);
+	CHECK_THROWS_AS(GMG::ChebyshevSmoother<2>(op, inv_diag, vg, 2, 10, 1.2, 1.1), RuntimeError);
+	// a diagonal with the wrong sign gives negative eigenvalues
+	inv_diag->scale(-1);
+	CHECK_THROWS_AS(GMG::ChebyshevSmoother<2>(op, inv_diag, vg), RuntimeError);
+}
+TEST_CASE("GMG::ChebyshevSmoother estimates the eigenvalues of the Jacobi preconditioned Laplacian",
+          "[GMG::ChebyshevSmoother]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH: " << mesh_file);
+	auto n       = GENERATE(4, 8);
+	auto neumann = GENERATE(false, true);
+	INFO("n:       " << n);
+	INFO("neumann: " << neumann);
+
+	DomainReader<2>       domain_reader(mesh_file, {n, n}, 1, neumann);
+	shared_ptr<Domain<2>> d = domain_reader.getFinerDomain();
+
+	auto gf       = make_shared<BiLinearGhostFiller>(d);
+	auto op       = make_shared<Poisson::StarPatchOperator<2>>(d, gf, neumann);
+	auto vg       = make_shared<ValVectorGenerator<2>>(d, 1);
+	auto inv_diag = vg->getNewVector();
+	op->getInverseDiagonal(inv_diag);
+
+	GMG::ChebyshevSmoother<2> smoother(op, inv_diag, vg, 3, 20, 0.2, 1.2);
+
+	// the eigenvalues of D^-1 A are in (0, 2) for a uniform mesh, the refined meshes are close
+	CHECK(smoother.getMaxEigenvalueEstimate() > 1);
+	CHECK(smoother.getMaxEigenvalueEstimate() < 2.5);
+	CHECK(smoother.getLowerBound() == Approx(0.2 * smoother.getMaxEigenvalueEstimate()));
+	CHECK(smoother.getUpperBound() == Approx(1.2 * smoother.getMaxEigenvalueEstimate()));
+	CHECK(smoother.getDegree() == 3);
+}
+TEST_CASE("GMG::ChebyshevSmoother with degree 1 is a weighted Jacobi step",
+          "[GMG::ChebyshevSmoother]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH: " << mesh_file);
+
+	DomainReader<2>       domain_reader(mesh_file, {5, 4}, 1);
+	shared_ptr<Domain<2>> d = domain_reader.getFinerDomain();
+
+	auto gf       = make_shared<BiLinearGhostFiller>(d);
+	auto op       = make_shared<Poisson::StarPatchOperator<2>>(d, gf);
+	auto vg       = make_shared<ValVectorGenerator<2>>(d, 1);
+	auto inv_diag = vg->getNewVector();
+	op->getInverseDiagonal(inv_diag);
+
+	GMG::ChebyshevSmoother<2> smoother(op, inv_diag, vg, 1);
+
+	auto f = vg->getNewVector();
+	DomainTools::SetValues<2>(d, f, ffun);
+	auto u = vg->getNewVector();
+	u->set(1);
+	auto u_expected = vg->getNewVector();
+	u_expected->set(1);
+	auto r = vg->getNewVector();
+	op->residual(f, u_expected, r);
+
+	smoother.smooth(f, u);
+
+	double omega = 2 / (smoother.getLowerBound() + smoother.getUpperBound());
+	for (auto pinfo : d->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<2> u_ld          = u->getLocalData(0, pinfo->local_index);
+		LocalData<2> u_expected_ld = u_expected->getLocalData(0, pinfo->local_index);
+		LocalData<2> r_ld          = r->getLocalData(0, pinfo->local_index);
+		LocalData<2> inv_diag_ld   = inv_diag->getLocalData(0, pinfo->local_index);
+		nested_loop<2>(u_ld.getStart(), u_ld.getEnd(), [&](const array<int, 2> &coord) {
+			INFO("xi:    " << coord[0]);
+			INFO("yi:    " << coord[1]);
+			double expected = u_expected_ld[coord] + omega * inv_diag_ld[coord] * r_ld[coord];
+			CHECK(u_ld[coord] == Approx(expected));
+		});
+	}
+}
+TEST_CASE("GMG::ChebyshevSmoother damps a rough error", "[GMG::ChebyshevSmoother]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH: " << mesh_file);
+	auto n      = GENERATE(4, 8);
+	auto degree = GENERATE(1, 2, 4);
+	auto var    = GENERATE(false, true);
+	INFO("n:      " << n);
+	INFO("degree: " << degree);
+	INFO("var:    " << var);
+
+	DomainReader<2>       domain_reader(mesh_file, {n, n}, 1);
+	shared_ptr<Domain<2>> d = domain_reader.getFinerDomain();
+
+	auto gf       = make_shared<BiLinearGhostFiller>(d);
+	auto vg       = make_shared<ValVectorGenerator<2>>(d, 1);
+	auto inv_diag = vg->getNewVector();
+
+	shared_ptr<const Operator<2>> op;
+	if (var) {
+		auto h_vec = vg->getNewVector();
+		DomainTools::SetValuesWithGhost<2>(d, h_vec, hfun);
+		auto var_op = make_shared<VarPoisson::StarPatchOperator<2>>(h_vec, d, gf);
+		var_op->getInverseDiagonal(inv_diag);
+		op = var_op;
+	} else {
+		auto poisson_op = make_shared<Poisson::StarPatchOperator<2>>(d, gf);
+		poisson_op->getInverseDiagonal(inv_diag);
+		op = poisson_op;
+	}
+
+	GMG::ChebyshevSmoother<2> smoother(op, inv_diag, vg, degree);
+
+	// with f = 0, u is the error, which starts out rough
+	auto f = vg->getNewVector();
+	auto u = vg->getNewVector();
+	auto r = vg->getNewVector();
+	int  index = 0;
+	for (int i = 0; i < u->getNumLocalPatches(); i++) {
+		LocalData<2> ld = u->getLocalData(0, i);
+		nested_loop<2>(ld.getStart(), ld.getEnd(), [&](const array<int, 2> &coord) {
+			ld[coord] = sin(index * index + 0.5 * index);
+			index++;
+		});
+	}
+
+	double initial_norm = op->residual(f, u, r, true);
+	smoother.smooth(f, u);
+	double norm = op->residual(f, u, r, true);
+	CHECK(norm < 0.5 * initial_norm);
+}
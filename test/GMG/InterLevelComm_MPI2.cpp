@@ -886,4 +886,154 @@ TEST_CASE("2-processor getGhostPatches then sendGhostPaches called on uniform qu
 		               });
 	} else {
 	}
-}
\ No newline at end of file
+}
+TEST_CASE("2-processor neighbor collectives match point-to-point messages",
+          "[GMG::InterLevelComm]")
+{
+	auto mesh_file
+	= GENERATE(as<std::string>{}, uniform, "mesh_inputs/2d_uniform_4x4_mid_on_1_mpi2.json");
+	auto                  num_components = GENERATE(1, 2);
+	auto                  nx             = GENERATE(2, 10);
+	auto                  ny             = GENERATE(2, 10);
+	int                   num_ghost      = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine   = domain_reader.getFinerDomain();
+	shared_ptr<Domain<2>> d_coarse = domain_reader.getCoarserDomain();
+
+	auto ilc = std::make_shared<GMG::InterLevelComm<2>>(d_coarse, num_components, d_fine);
+	auto neighbor_ilc
+	= std::make_shared<GMG::InterLevelComm<2>>(d_coarse, num_components, d_fine);
+	neighbor_ilc->setUseNeighborCollectives(true);
+	CHECK_FALSE(ilc->getUseNeighborCollectives());
+	CHECK(neighbor_ilc->getUseNeighborCollectives());
+
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	INFO("rank: " << rank);
+
+	auto fill = [&](shared_ptr<Vector<2>> vec) {
+		for (int i = 0; i < vec->getNumLocalPatches(); i++) {
+			auto local_datas = vec->getLocalDatas(i);
+			for (int c = 0; c < num_components; c++) {
+				nested_loop<2>(local_datas[c].getGhostStart(), local_datas[c].getGhostEnd(),
+				               [&](const std::array<int, 2> &coord) {
+					               local_datas[c][coord]
+					               = 1000 * rank + 100 * i + 10 * c + coord[0] + 3 * coord[1];
+				               });
+			}
+		}
+	};
+	auto check = [&](shared_ptr<const Vector<2>> vec, shared_ptr<const Vector<2>> expected) {
+		for (int i = 0; i < vec->getNumLocalPatches(); i++) {
+			auto local_datas    = vec->getLocalDatas(i);
+			auto expected_datas = expected->getLocalDatas(i);
+			for (int c = 0; c < num_components; c++) {
+				nested_loop<2>(local_datas[c].getGhostStart(), local_datas[c].getGhostEnd(),
+				               [&](const std::array<int, 2> &coord) {
+					               CHECK(local_datas[c][coord] == expected_datas[c][coord]);
+				               });
+			}
+		}
+	};
+
+	auto coarse_vec          = ValVector<2>::GetNewVector(d_coarse, num_components);
+	auto ghost_vec           = ilc->getNewGhostVector();
+	auto neighbor_coarse_vec = ValVector<2>::GetNewVector(d_coarse, num_components);
+	auto neighbor_ghost_vec  = neighbor_ilc->getNewGhostVector();
+
+	// reverse scatter
+	fill(coarse_vec);
+	fill(ghost_vec);
+	fill(neighbor_coarse_vec);
+	fill(neighbor_ghost_vec);
+	ilc->sendGhostPatchesStart(coarse_vec, ghost_vec);
+	ilc->sendGhostPatchesFinish(coarse_vec, ghost_vec);
+	neighbor_ilc->sendGhostPatchesStart(neighbor_coarse_vec, neighbor_ghost_vec);
+	neighbor_ilc->sendGhostPatchesFinish(neighbor_coarse_vec, neighbor_ghost_vec);
+	check(neighbor_coarse_vec, coarse_vec);
+
+	// forward scatter
+	ghost_vec->setWithGhost(0);
+	neighbor_ghost_vec->setWithGhost(0);
+	ilc->getGhostPatchesStart(coarse_vec, ghost_vec);
+	ilc->getGhostPatchesFinish(coarse_vec, ghost_vec);
+	neighbor_ilc->getGhostPatchesStart(neighbor_coarse_vec, neighbor_ghost_vec);
+	neighbor_ilc->getGhostPatchesFinish(neighbor_coarse_vec, neighbor_ghost_vec);
+	check(neighbor_ghost_vec, ghost_vec);
+}
+TEST_CASE("2-processor float messages match double messages", "[GMG::InterLevelComm]")
+{
+	auto mesh_file
+	= GENERATE(as<std::string>{}, uniform, "mesh_inputs/2d_uniform_4x4_mid_on_1_mpi2.json");
+	auto                  neighbor       = GENERATE(false, true);
+	auto                  num_components = GENERATE(1, 2);
+	auto                  nx             = GENERATE(2, 10);
+	auto                  ny             = GENERATE(2, 10);
+	int                   num_ghost      = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine   = domain_reader.getFinerDomain();
+	shared_ptr<Domain<2>> d_coarse = domain_reader.getCoarserDomain();
+
+	auto ilc       = std::make_shared<GMG::InterLevelComm<2>>(d_coarse, num_components, d_fine);
+	auto float_ilc = std::make_shared<GMG::InterLevelComm<2>>(d_coarse, num_components, d_fine);
+	float_ilc->setUseNeighborCollectives(neighbor);
+	float_ilc->setUseFloatMessages(true);
+	CHECK_FALSE(ilc->getUseFloatMessages());
+	CHECK(float_ilc->getUseFloatMessages());
+
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	INFO("rank: " << rank);
+
+	auto fill = [&](shared_ptr<Vector<2>> vec) {
+		for (int i = 0; i < vec->getNumLocalPatches(); i++) {
+			auto local_datas = vec->getLocalDatas(i);
+			for (int c = 0; c < num_components; c++) {
+				nested_loop<2>(local_datas[c].getGhostStart(), local_datas[c].getGhostEnd(),
+				               [&](const std::array<int, 2> &coord) {
+					               local_datas[c][coord]
+					               = (1000 * rank + 100 * i + 10 * c + coord[0] + 3 * coord[1])
+					                 / 3.0;
+				               });
+			}
+		}
+	};
+	auto check = [&](shared_ptr<const Vector<2>> vec, shared_ptr<const Vector<2>> expected) {
+		for (int i = 0; i < vec->getNumLocalPatches(); i++) {
+			auto local_datas    = vec->getLocalDatas(i);
+			auto expected_datas = expected->getLocalDatas(i);
+			for (int c = 0; c < num_components; c++) {
+				nested_loop<2>(local_datas[c].getGhostStart(), local_datas[c].getGhostEnd(),
+				               [&](const std::array<int, 2> &coord) {
+					               CHECK(local_datas[c][coord]
+					                     == Approx(expected_datas[c][coord]).epsilon(1e-6));
+				               });
+			}
+		}
+	};
+
+	auto coarse_vec       = ValVector<2>::GetNewVector(d_coarse, num_components);
+	auto ghost_vec        = ilc->getNewGhostVector();
+	auto float_coarse_vec = ValVector<2>::GetNewVector(d_coarse, num_components);
+	auto float_ghost_vec  = float_ilc->getNewGhostVector();
+
+	// reverse scatter
+	fill(coarse_vec);
+	fill(ghost_vec);
+	fill(float_coarse_vec);
+	fill(float_ghost_vec);
+	ilc->sendGhostPatchesStart(coarse_vec, ghost_vec);
+	ilc->sendGhostPatchesFinish(coarse_vec, ghost_vec);
+	float_ilc->sendGhostPatchesStart(float_coarse_vec, float_ghost_vec);
+	float_ilc->sendGhostPatchesFinish(float_coarse_vec, float_ghost_vec);
+	check(float_coarse_vec, coarse_vec);
+
+	// forward scatter
+	ghost_vec->setWithGhost(0);
+	float_ghost_vec->setWithGhost(0);
+	ilc->getGhostPatchesStart(coarse_vec, ghost_vec);
+	ilc->getGhostPatchesFinish(coarse_vec, ghost_vec);
+	float_ilc->getGhostPatchesStart(float_coarse_vec, float_ghost_vec);
+	float_ilc->getGhostPatchesFinish(float_coarse_vec, float_ghost_vec);
+	check(float_ghost_vec, ghost_vec);
+}
@@ -223,49 +223,42 @@ TEST_CASE("CG giving a good initial guess reduces the iterations", "[CG]")
 }
 namespace
 {
-class MockVector : public Vector<2>
-{
-	public:
-	mutable int norm_calls = 0;
-	double      dot_value;
-	MockVector(double dot_value) : Vector<2>(MPI_COMM_WORLD, 1, 0, 10), dot_value(dot_value) {}
-	LocalData<2>       getLocalData(int, int) override {}
-	const LocalData<2> getLocalData(int, int) const override {}
-	double             dot(std::shared_ptr<const Vector<2>>) const override
-	{
-		return dot_value;
-	}
-	double twoNorm() const override
-	{
-		norm_calls++;
-		if (norm_calls == 1) {
-			return 1;
-		} else {
-			return norm_calls * 1e6;
-		}
-	}
-};
 class MockVectorGenerator : public VectorGenerator<2>
 {
 	public:
-	std::shared_ptr<MockVector> vec;
-	MockVectorGenerator(std::shared_ptr<MockVector> vec) : vec(vec) {}
 	std::shared_ptr<Vector<2>> getNewVector() const override
 	{
-		return vec;
+		return make_shared<ValVector<2>>(MPI_COMM_WORLD, array<int, 2>{3, 1}, 0, 1, 1);
 	}
 };
+/**
+ * @brief Ignores the input and returns the given outputs in order
+ */
 class MockOperator : public Operator<2>
 {
 	public:
-	void apply(std::shared_ptr<const Vector<2>>, std::shared_ptr<Vector<2>>) const override {}
+	vector<array<double, 3>> outputs;
+	mutable size_t           num_calls = 0;
+	MockOperator(const vector<array<double, 3>> &outputs) : outputs(outputs) {}
+	void apply(std::shared_ptr<const Vector<2>>, std::shared_ptr<Vector<2>> y) const override
+	{
+		LocalData<2> ld = y->getLocalData(0, 0);
+		for (int i = 0; i < 3; i++) {
+			ld[{i, 0}] = outputs.at(num_calls)[i];
+		}
+		num_calls++;
+	}
 };
 } // namespace
 TEST_CASE("CG throws breakdown exception when rho is 0", "[CG]")
 {
-	auto  vec = make_shared<MockVector>(0);
+	auto x = make_shared<ValVector<2>>(MPI_COMM_WORLD, array<int, 2>{3, 1}, 0, 1, 1);
+	auto b = make_shared<ValVector<2>>(MPI_COMM_WORLD, array<int, 2>{3, 1}, 0, 1, 1);
+	b->getLocalData(0, 0)[{0, 0}] = 1;
+
+	// the initial residual is zero, a negative tolerance forces an iteration
+	auto  op = make_shared<MockOperator>(vector<array<double, 3>>{{1, 0, 0}});
 	CG<2> solver;
-	CHECK_THROWS_AS(
-	solver.solve(make_shared<MockVectorGenerator>(vec), make_shared<MockOperator>(), vec, vec),
-	BreakdownError);
+	solver.setTolerance(-1);
+	CHECK_THROWS_AS(solver.solve(make_shared<MockVectorGenerator>(), op, x, b), BreakdownError);
 }
\ No newline at end of file
@@ -49,15 +49,15 @@ template <int D> class MockPatchOperator : public PatchOperator<D>
 	{
 	}
 	void applySinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                      const std::vector<LocalData<D>> &us, std::vector<LocalData<D>> &fs,
+	                      const PatchView<D> &us, PatchView<D> &fs,
 	                      bool treat_interior_boundary_as_dirichlet) const override
 	{
 		interior_dirichlet |= true;
 		num_apply_calls++;
 	}
 	void addGhostToRHS(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                   const std::vector<LocalData<D>> &   us,
-	                   std::vector<LocalData<D>> &         fs) const override
+	                   const PatchView<D> &                us,
+	                   PatchView<D> &                      fs) const override
 	{
 		rhs_was_modified = true;
 	}
@@ -87,7 +87,7 @@ template <int D> class NonLinMockPatchOperator : public PatchOperator<D>
 	{
 	}
 	void applySinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                      const std::vector<LocalData<D>> &us, std::vector<LocalData<D>> &fs,
+	                      const PatchView<D> &us, PatchView<D> &fs,
 	                      bool treat_interior_boundary_as_dirichlet) const override
 	{
 		interior_dirichlet |= treat_interior_boundary_as_dirichlet;
@@ -97,8 +97,8 @@ template <int D> class NonLinMockPatchOperator : public PatchOperator<D>
 		}
 	}
 	void addGhostToRHS(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                   const std::vector<LocalData<D>> &   us,
-	                   std::vector<LocalData<D>> &         fs) const override
+	                   const PatchView<D> &                us,
+	                   PatchView<D> &                      fs) const override
 	{
 		rhs_was_modified = true;
 	}
@@ -0,0 +1,173 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "catch.hpp"
+#include <ThunderEgg/LocalData.h>
+#include <ThunderEgg/Loops.h>
+#include <vector>
+using namespace std;
+using namespace ThunderEgg;
+TEST_CASE("row_loop visits the first cell of each row", "[Loops]")
+{
+	array<int, 3>         start = {1, -1, 2};
+	array<int, 3>         end   = {4, 1, 3};
+	vector<array<int, 3>> coords;
+	row_loop<3>(start, end, [&](const array<int, 3> &coord) { coords.push_back(coord); });
+
+	vector<array<int, 3>> expected;
+	for (int z = 2; z <= 3; z++) {
+		for (int y = -1; y <= 1; y++) {
+			expected.push_back({1, y, z});
+		}
+	}
+	CHECK(coords == expected);
+}
+TEST_CASE("nested_row_loop passes row pointers and the row length", "[Loops]")
+{
+	int            num_ghost = GENERATE(0, 1);
+	array<int, 2>  lengths   = {3, 4};
+	array<int, 2>  strides   = {1, lengths[0] + 2 * num_ghost};
+	int            size      = strides[1] * (lengths[1] + 2 * num_ghost);
+	vector<double> a_vec(size);
+	vector<double> b_vec(size);
+	LocalData<2>   a(a_vec.data() + num_ghost * (1 + strides[1]), strides, lengths, num_ghost);
+	LocalData<2>   b(b_vec.data() + num_ghost * (1 + strides[1]), strides, lengths, num_ghost);
+	nested_loop<2>(a.getStart(), a.getEnd(),
+	               [&](const array<int, 2> &coord) { a[coord] = coord[0] + 10 * coord[1]; });
+
+	int num_rows = 0;
+	nested_row_loop<2>(
+	a.getStart(), a.getEnd(),
+	[&](int n, const double *a_row, double *b_row) {
+		CHECK(n == 3);
+		for (int i = 0; i < n; i++) {
+			b_row[i] = 2 * a_row[i];
+		}
+		num_rows++;
+	},
+	a, b);
+
+	CHECK(num_rows == 4);
+	nested_loop<2>(a.getStart(), a.getEnd(), [&](const array<int, 2> &coord) {
+		CHECK(b[coord] == 2 * (coord[0] + 10 * coord[1]));
+	});
+}
+TEST_CASE("cell_loop with contiguous and non-contiguous rows", "[Loops]")
+{
+	// the second array stores two interleaved components, so its rows are not contiguous
+	int            stride = GENERATE(1, 2);
+	array<int, 2>  lengths{3, 4};
+	vector<double> a_vec(3 * 4);
+	vector<double> b_vec(3 * 4 * stride);
+	LocalData<2>   a(a_vec.data(), {1, 3}, lengths, 0);
+	LocalData<2>   b(b_vec.data(), {stride, 3 * stride}, lengths, 0);
+	nested_loop<2>(a.getStart(), a.getEnd(),
+	               [&](const array<int, 2> &coord) { a[coord] = coord[0] - coord[1]; });
+
+	int num_cells = 0;
+	cell_loop<2>(
+	a.getStart(), a.getEnd(),
+	[&](const double &a_value, double &b_value) {
+		b_value = a_value + 1;
+		num_cells++;
+	},
+	a, b);
+
+	CHECK(num_cells == 12);
+	nested_loop<2>(a.getStart(), a.getEnd(), [&](const array<int, 2> &coord) {
+		CHECK(b[coord] == coord[0] - coord[1] + 1);
+	});
+	if (stride == 2) {
+		// the interleaved values are not touched
+		for (size_t i = 1; i < b_vec.size(); i += 2) {
+			CHECK(b_vec[i] == 0);
+		}
+	}
+}
+TEST_CASE("tiled_row_loop visits each row once with the tile lengths", "[Loops]")
+{
+	array<int, 3> start = {-1, 0, 2};
+	array<int, 3> end   = {5, 6, 4};
+	array<int, 3> tile_sizes
+	= GENERATE(array<int, 3>{0, 0, 0}, array<int, 3>{0, 3, 0}, array<int, 3>{4, 2, 2},
+	           array<int, 3>{100, 1, 0}, array<int, 3>{7, 7, 3});
+	INFO("tile sizes: " << tile_sizes[0] << " " << tile_sizes[1] << " " << tile_sizes[2]);
+
+	// count the number of times each cell is visited
+	vector<int> visits(7 * 7 * 3);
+	tiled_row_loop<3>(start, end, tile_sizes, [&](const array<int, 3> &coord, int n) {
+		CHECK(coord[0] + n - 1 <= end[0]);
+		if (tile_sizes[0] > 0) {
+			CHECK(n <= tile_sizes[0]);
+		}
+		for (int i = 0; i < n; i++) {
+			visits[(coord[0] + i + 1) + 7 * coord[1] + 49 * (coord[2] - 2)]++;
+		}
+	});
+	for (int count : visits) {
+		CHECK(count == 1);
+	}
+}
+TEST_CASE("tiled_row_loop without tiles matches row_loop", "[Loops]")
+{
+	array<int, 3>         start = {1, -1, 2};
+	array<int, 3>         end   = {4, 1, 3};
+	vector<array<int, 3>> coords;
+	tiled_row_loop<3>(start, end, {0, 0, 0}, [&](const array<int, 3> &coord, int n) {
+		CHECK(n == 4);
+		coords.push_back(coord);
+	});
+
+	vector<array<int, 3>> expected;
+	row_loop<3>(start, end, [&](const array<int, 3> &coord) { expected.push_back(coord); });
+	CHECK(coords == expected);
+}
+TEST_CASE("tiled_nested_row_loop passes row pointers and the row length", "[Loops]")
+{
+	array<int, 2>  lengths = {5, 4};
+	array<int, 2>  strides = {1, 7};
+	vector<double> a_vec(7 * 6);
+	vector<double> b_vec(7 * 6);
+	LocalData<2>   a(a_vec.data() + 8, strides, lengths, 1);
+	LocalData<2>   b(b_vec.data() + 8, strides, lengths, 1);
+	nested_loop<2>(a.getStart(), a.getEnd(),
+	               [&](const array<int, 2> &coord) { a[coord] = coord[0] + 10 * coord[1]; });
+
+	tiled_nested_row_loop<2>(
+	a.getStart(), a.getEnd(), {2, 3},
+	[&](int n, const double *a_row, double *b_row) {
+		CHECK(n <= 2);
+		for (int i = 0; i < n; i++) {
+			b_row[i] = 2 * a_row[i];
+		}
+	},
+	a, b);
+
+	nested_loop<2>(a.getStart(), a.getEnd(), [&](const array<int, 2> &coord) {
+		CHECK(b[coord] == 2 * (coord[0] + 10 * coord[1]));
+	});
+}
+TEST_CASE("is_tiled", "[Loops]")
+{
+	CHECK_FALSE(is_tiled<3>({0, 0, 0}));
+	CHECK(is_tiled<3>({0, 4, 0}));
+	CHECK(is_tiled<2>({1, 0}));
+}
@@ -43,9 +43,9 @@ template <int D> class CallMockMPIGhostFiller : public MPIGhostFiller<D>
 
 	public:
 	void fillGhostCellsForNbrPatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                               const std::vector<LocalData<D>> &   local_datas,
-	                               const std::vector<LocalData<D>> &nbr_datas, const Side<D> side,
-	                               const NbrType nbr_type, const Orthant<D> orthant) const override
+	                               const PatchView<D> &local_datas, const PatchView<D> &nbr_datas,
+	                               const Side<D> side, const NbrType nbr_type,
+	                               const Orthant<D> orthant) const override
 	{
 		called = true;
 		nbr_calls.emplace_back(pinfo, side, nbr_type, orthant, local_datas.size(),
@@ -53,12 +53,17 @@ template <int D> class CallMockMPIGhostFiller : public MPIGhostFiller<D>
 	}
 
 	void fillGhostCellsForLocalPatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                                 const std::vector<LocalData<D>> &   local_datas) const override
+	                                 const PatchView<D> &local_datas) const override
 	{
 		called = true;
 		local_calls.emplace_back(pinfo, local_datas.size());
 	}
 
+	bool isThreadSafe() const override
+	{
+		return false;
+	}
+
 	CallMockMPIGhostFiller(std::shared_ptr<const Domain<D>> domain_in, int num_components,
 	                       int side_cases_in)
 	: MPIGhostFiller<D>(domain_in, side_cases_in), num_components(num_components)
@@ -187,9 +192,9 @@ template <int D> class ExchangeMockMPIGhostFiller : public MPIGhostFiller<D>
 {
 	public:
 	void fillGhostCellsForNbrPatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                               const std::vector<LocalData<D>> &   local_datas,
-	                               const std::vector<LocalData<D>> &nbr_datas, const Side<D> side,
-	                               const NbrType nbr_type, const Orthant<D> orthant) const override
+	                               const PatchView<D> &local_datas, const PatchView<D> &nbr_datas,
+	                               const Side<D> side, const NbrType nbr_type,
+	                               const Orthant<D> orthant) const override
 	{
 		for (size_t c = 0; c < nbr_datas.size(); c++) {
 			int index = 0;
@@ -205,7 +210,7 @@ template <int D> class ExchangeMockMPIGhostFiller : public MPIGhostFiller<D>
 	}
 
 	void fillGhostCellsForLocalPatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                                 const std::vector<LocalData<D>> &   local_data) const override
+	                                 const PatchView<D> &local_data) const override
 	{
 	}
 
@@ -106,4 +106,71 @@ TEST_CASE("Two Exchanges for various domains 1-side cases", "[MPIGhostFiller]")
 	mgf.fillGhost(vec);
 
 	mgf.checkVector(vec);
-}
\ No newline at end of file
+}
+TEST_CASE("fillGhostStart and fillGhostFinish with one rank", "[MPIGhostFiller]")
+{
+	auto mesh_file
+	= GENERATE(as<std::string>{}, single_mesh_file, refined_mesh_file, cross_mesh_file);
+	INFO("MESH: " << mesh_file);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {4, 4}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto vec   = ValVector<2>::GetNewVector(d_fine, 2);
+	auto other = ValVector<2>::GetNewVector(d_fine, 2);
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		for (int c = 0; c < 2; c++) {
+			auto data = vec->getLocalData(c, pinfo->local_index);
+			nested_loop<2>(data.getStart(), data.getEnd(),
+			               [&](const std::array<int, 2> &coord) { data[coord] = pinfo->id; });
+		}
+	}
+
+	ExchangeMockMPIGhostFiller<2> mgf(d_fine, 1);
+
+	CHECK_THROWS_AS(mgf.fillGhostFinish(vec), RuntimeError);
+
+	mgf.fillGhostStart(vec);
+	// all of the neighbors are on this rank, so the ghost cells are already filled
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		CHECK_FALSE(mgf.needsFillGhostFinish(pinfo->local_index));
+	}
+	CHECK_THROWS_AS(mgf.fillGhostStart(vec), RuntimeError);
+	CHECK_THROWS_AS(mgf.fillGhostFinish(other), RuntimeError);
+	mgf.fillGhostFinish(vec);
+
+	mgf.checkVector(vec);
+}
+
+TEST_CASE("Exchange of several vectors with one rank", "[MPIGhostFiller]")
+{
+	auto mesh_file
+	= GENERATE(as<std::string>{}, single_mesh_file, refined_mesh_file, cross_mesh_file);
+	INFO("MESH: " << mesh_file);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {4, 4}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	vector<shared_ptr<const Vector<2>>> vecs;
+	for (int num_components : {2, 1}) {
+		auto vec = ValVector<2>::GetNewVector(d_fine, num_components);
+		for (auto pinfo : d_fine->getPatchInfoVector()) {
+			for (int c = 0; c < num_components; c++) {
+				auto data = vec->getLocalData(c, pinfo->local_index);
+				nested_loop<2>(data.getStart(), data.getEnd(),
+				               [&](const std::array<int, 2> &coord) { data[coord] = pinfo->id; });
+			}
+		}
+		vecs.push_back(vec);
+	}
+
+	ExchangeMockMPIGhostFiller<2> mgf(d_fine, 1);
+
+	mgf.fillGhostStart(vecs);
+	CHECK_THROWS_AS(mgf.fillGhostFinish(vecs[0]), RuntimeError);
+	mgf.fillGhostFinish(vecs);
+
+	for (auto vec : vecs) {
+		mgf.checkVector(vec);
+	}
+}
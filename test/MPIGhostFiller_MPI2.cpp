@@ -3,6 +3,7 @@
 #include "utils/DomainReader.h"
 #include <ThunderEgg/DomainTools.h>
 #include <ThunderEgg/MPIGhostFiller.h>
+#include <ThunderEgg/SharedValVector.h>
 #include <ThunderEgg/ValVector.h>
 #include <list>
 using namespace std;
@@ -84,4 +85,218 @@ TEST_CASE("Two Exchanges for various domains 1-side cases MPI2", "[MPIGhostFille
 	mgf.fillGhost(vec);
 
 	mgf.checkVector(vec);
-}
\ No newline at end of file
+}
+TEST_CASE("Exchanges with different numbers of components MPI2", "[MPIGhostFiller]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, uniform, refined);
+	INFO("MESH: " << mesh_file);
+	auto                  nx        = GENERATE(2, 5);
+	auto                  ny        = GENERATE(2, 5);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	ExchangeMockMPIGhostFiller<2> mgf(d_fine, 1);
+
+	// the buffers for each number of components are reused, so alternate between them
+	for (int num_components : {1, 3, 1, 2, 3}) {
+		INFO("num_components: " << num_components);
+		auto vec = ValVector<2>::GetNewVector(d_fine, num_components);
+		for (auto pinfo : d_fine->getPatchInfoVector()) {
+			for (int c = 0; c < num_components; c++) {
+				auto data = vec->getLocalData(c, pinfo->local_index);
+				nested_loop<2>(data.getStart(), data.getEnd(),
+				               [&](const std::array<int, 2> &coord) { data[coord] = pinfo->id; });
+			}
+		}
+
+		mgf.fillGhost(vec);
+
+		mgf.checkVector(vec);
+	}
+}
+TEST_CASE("Exchange with neighbor collectives for various domains MPI2", "[MPIGhostFiller]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, uniform, refined);
+	INFO("MESH: " << mesh_file);
+	auto                  nx        = GENERATE(2, 5);
+	auto                  ny        = GENERATE(2, 5);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	ExchangeMockMPIGhostFiller<2> mgf(d_fine, 1);
+	mgf.setUseNeighborCollectives(true);
+	CHECK(mgf.getUseNeighborCollectives());
+
+	for (int num_components : {1, 3, 1}) {
+		INFO("num_components: " << num_components);
+		auto vec = ValVector<2>::GetNewVector(d_fine, num_components);
+		for (auto pinfo : d_fine->getPatchInfoVector()) {
+			for (int c = 0; c < num_components; c++) {
+				auto data = vec->getLocalData(c, pinfo->local_index);
+				nested_loop<2>(data.getStart(), data.getEnd(),
+				               [&](const std::array<int, 2> &coord) { data[coord] = pinfo->id; });
+			}
+		}
+
+		mgf.fillGhost(vec);
+
+		mgf.checkVector(vec);
+	}
+}
+
+TEST_CASE("Exchange with float messages for various domains MPI2", "[MPIGhostFiller]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, uniform, refined);
+	INFO("MESH: " << mesh_file);
+	auto                  neighbor  = GENERATE(false, true);
+	auto                  nx        = GENERATE(2, 5);
+	auto                  ny        = GENERATE(2, 5);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	ExchangeMockMPIGhostFiller<2> mgf(d_fine, 1);
+	mgf.setUseNeighborCollectives(neighbor);
+	mgf.setUseFloatMessages(true);
+	CHECK(mgf.getUseFloatMessages());
+
+	// the patch ids are exact in single precision
+	for (int num_components : {1, 3, 1}) {
+		INFO("num_components: " << num_components);
+		auto vec = ValVector<2>::GetNewVector(d_fine, num_components);
+		for (auto pinfo : d_fine->getPatchInfoVector()) {
+			for (int c = 0; c < num_components; c++) {
+				auto data = vec->getLocalData(c, pinfo->local_index);
+				nested_loop<2>(data.getStart(), data.getEnd(),
+				               [&](const std::array<int, 2> &coord) { data[coord] = pinfo->id; });
+			}
+		}
+
+		mgf.fillGhost(vec);
+
+		mgf.checkVector(vec);
+	}
+}
+
+TEST_CASE("fillGhostStart and fillGhostFinish for various domains MPI2", "[MPIGhostFiller]")
+{
+	auto num_components = GENERATE(1, 2, 3);
+	auto mesh_file      = GENERATE(as<std::string>{}, uniform, refined);
+	INFO("MESH: " << mesh_file);
+	auto                  nx        = GENERATE(2, 5);
+	auto                  ny        = GENERATE(2, 5);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto vec = ValVector<2>::GetNewVector(d_fine, num_components);
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		for (int c = 0; c < num_components; c++) {
+			auto data = vec->getLocalData(c, pinfo->local_index);
+			nested_loop<2>(data.getStart(), data.getEnd(),
+			               [&](const std::array<int, 2> &coord) { data[coord] = pinfo->id; });
+		}
+	}
+
+	ExchangeMockMPIGhostFiller<2> mgf(d_fine, 1);
+
+	// only the patches with a neighbor on the other rank have to wait for the finish
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		bool has_remote_nbr = false;
+		for (int rank : pinfo->getNbrRanks()) {
+			has_remote_nbr = has_remote_nbr || (rank != pinfo->rank && rank != -1);
+		}
+		CHECK(mgf.needsFillGhostFinish(pinfo->local_index) == has_remote_nbr);
+	}
+
+	mgf.fillGhostStart(vec);
+	mgf.fillGhostFinish(vec);
+
+	mgf.checkVector(vec);
+}
+
+TEST_CASE("Exchange of several vectors for various domains MPI2", "[MPIGhostFiller]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, uniform, refined);
+	INFO("MESH: " << mesh_file);
+	auto                  nx        = GENERATE(2, 5);
+	auto                  ny        = GENERATE(2, 5);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	ExchangeMockMPIGhostFiller<2> mgf(d_fine, 1);
+
+	vector<shared_ptr<const Vector<2>>> vecs;
+	for (int num_components : {1, 3, 2}) {
+		auto vec = ValVector<2>::GetNewVector(d_fine, num_components);
+		for (auto pinfo : d_fine->getPatchInfoVector()) {
+			for (int c = 0; c < num_components; c++) {
+				auto data = vec->getLocalData(c, pinfo->local_index);
+				nested_loop<2>(data.getStart(), data.getEnd(),
+				               [&](const std::array<int, 2> &coord) { data[coord] = pinfo->id; });
+			}
+		}
+		vecs.push_back(vec);
+	}
+
+	mgf.fillGhost(vecs);
+
+	for (auto vec : vecs) {
+		INFO("num_components: " << vec->getNumComponents());
+		mgf.checkVector(vec);
+	}
+
+	// a single vector with the same total number of components reuses the buffers
+	auto vec = ValVector<2>::GetNewVector(d_fine, 6);
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		for (int c = 0; c < 6; c++) {
+			auto data = vec->getLocalData(c, pinfo->local_index);
+			nested_loop<2>(data.getStart(), data.getEnd(),
+			               [&](const std::array<int, 2> &coord) { data[coord] = pinfo->id; });
+		}
+	}
+	mgf.fillGhost(vec);
+	mgf.checkVector(vec);
+}
+
+TEST_CASE("Exchange with shared memory for various domains MPI2", "[MPIGhostFiller]")
+{
+	auto num_components = GENERATE(1, 2, 3);
+	auto mesh_file      = GENERATE(as<std::string>{}, uniform, refined);
+	INFO("MESH: " << mesh_file);
+	auto                  nx        = GENERATE(2, 5);
+	auto                  ny        = GENERATE(2, 5);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto shared_comm = make_shared<SharedMemoryComm>(MPI_COMM_WORLD);
+	auto vec         = SharedValVector<2>::GetNewVector(shared_comm, d_fine, num_components);
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		for (int c = 0; c < num_components; c++) {
+			auto data = vec->getLocalData(c, pinfo->local_index);
+			nested_loop<2>(data.getStart(), data.getEnd(),
+			               [&](const std::array<int, 2> &coord) { data[coord] = pinfo->id; });
+		}
+	}
+
+	ExchangeMockMPIGhostFiller<2> mgf(d_fine, 1);
+	mgf.setUseSharedMemory(shared_comm);
+
+	mgf.fillGhost(vec);
+	mgf.checkVector(vec);
+
+	// the ghost cells are zeroed and filled again
+	mgf.fillGhostStart(vec);
+	mgf.fillGhostFinish(vec);
+	mgf.checkVector(vec);
+
+	// vectors that are not in shared memory still use messages
+	auto val_vec = ValVector<2>::GetNewVector(d_fine, num_components);
+	val_vec->copy(vec);
+	mgf.fillGhost(val_vec);
+	mgf.checkVector(val_vec);
+}
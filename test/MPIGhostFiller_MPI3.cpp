@@ -3,6 +3,7 @@
 #include "utils/DomainReader.h"
 #include <ThunderEgg/DomainTools.h>
 #include <ThunderEgg/MPIGhostFiller.h>
+#include <ThunderEgg/SharedValVector.h>
 #include <ThunderEgg/ValVector.h>
 #include <list>
 using namespace std;
@@ -58,6 +59,33 @@ TEST_CASE("Exchange for various domains 1-side cases MPI3", "[MPIGhostFiller]")
 
 	mgf.checkVector(vec);
 }
+TEST_CASE("Exchange with neighbor collectives for various domains MPI3", "[MPIGhostFiller]")
+{
+	auto num_components = GENERATE(1, 2, 3);
+	auto mesh_file      = GENERATE(as<std::string>{}, uniform, refined);
+	INFO("MESH: " << mesh_file);
+	auto                  nx        = GENERATE(2, 5);
+	auto                  ny        = GENERATE(2, 5);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto vec = ValVector<2>::GetNewVector(d_fine, num_components);
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		for (int c = 0; c < num_components; c++) {
+			auto data = vec->getLocalData(c, pinfo->local_index);
+			nested_loop<2>(data.getStart(), data.getEnd(),
+			               [&](const std::array<int, 2> &coord) { data[coord] = pinfo->id; });
+		}
+	}
+
+	ExchangeMockMPIGhostFiller<2> mgf(d_fine, 1);
+	mgf.setUseNeighborCollectives(true);
+
+	mgf.fillGhost(vec);
+
+	mgf.checkVector(vec);
+}
 TEST_CASE("Two Exchanges for various domains 1-side cases MPI3", "[MPIGhostFiller]")
 {
 	auto num_components = GENERATE(1, 2, 3);
@@ -84,4 +112,34 @@ TEST_CASE("Two Exchanges for various domains 1-side cases MPI3", "[MPIGhostFille
 	mgf.fillGhost(vec);
 
 	mgf.checkVector(vec);
-}
\ No newline at end of file
+}
+TEST_CASE("Exchange with shared memory for various domains MPI3", "[MPIGhostFiller]")
+{
+	auto num_components = GENERATE(1, 2, 3);
+	auto mesh_file      = GENERATE(as<std::string>{}, uniform, refined);
+	INFO("MESH: " << mesh_file);
+	auto                  nx        = GENERATE(2, 5);
+	auto                  ny        = GENERATE(2, 5);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto shared_comm = make_shared<SharedMemoryComm>(MPI_COMM_WORLD);
+	auto vec         = SharedValVector<2>::GetNewVector(shared_comm, d_fine, num_components);
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		for (int c = 0; c < num_components; c++) {
+			auto data = vec->getLocalData(c, pinfo->local_index);
+			nested_loop<2>(data.getStart(), data.getEnd(),
+			               [&](const std::array<int, 2> &coord) { data[coord] = pinfo->id; });
+		}
+	}
+
+	ExchangeMockMPIGhostFiller<2> mgf(d_fine, 1);
+	mgf.setUseSharedMemory(shared_comm);
+
+	mgf.fillGhost(vec);
+	mgf.checkVector(vec);
+
+	mgf.fillGhost(vec);
+	mgf.checkVector(vec);
+}
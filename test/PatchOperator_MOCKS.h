@@ -47,6 +47,98 @@ template <int D> class MockGhostFiller : public GhostFiller<D>
 		return called;
 	}
 };
+template <int D> class SplitMockGhostFiller : public GhostFiller<D>
+{
+	private:
+	mutable bool started  = false;
+	mutable bool finished = false;
+
+	public:
+	void fillGhost(std::shared_ptr<const Vector<D>> u) const override
+	{
+		fillGhostStart(u);
+		fillGhostFinish(u);
+	}
+	void fillGhostStart(std::shared_ptr<const Vector<D>> u) const override
+	{
+		CHECK_FALSE(started);
+		started = true;
+	}
+	void fillGhostFinish(std::shared_ptr<const Vector<D>> u) const override
+	{
+		CHECK(started);
+		CHECK_FALSE(finished);
+		finished = true;
+	}
+	bool needsFillGhostFinish(int patch_local_index) const override
+	{
+		return patch_local_index % 2 == 1;
+	}
+	bool wasStarted() const
+	{
+		return started;
+	}
+	bool wasFinished() const
+	{
+		return finished;
+	}
+};
+template <int D> class SplitCheckingPatchOperator : public PatchOperator<D>
+{
+	private:
+	std::shared_ptr<const SplitMockGhostFiller<D>> split_ghost_filler;
+	mutable int                                    num_calls = 0;
+
+	public:
+	SplitCheckingPatchOperator(std::shared_ptr<const Domain<D>>               domain,
+	                           std::shared_ptr<const SplitMockGhostFiller<D>> ghost_filler)
+	: PatchOperator<D>(domain, ghost_filler), split_ghost_filler(ghost_filler)
+	{
+	}
+	void applySinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
+	                      const PatchView<D> &us, PatchView<D> &fs,
+	                      bool treat_interior_boundary_as_dirichlet) const override
+	{
+		INFO("LOCAL_INDEX: " << pinfo->local_index);
+		CHECK(split_ghost_filler->wasStarted());
+		CHECK(split_ghost_filler->wasFinished()
+		      == split_ghost_filler->needsFillGhostFinish(pinfo->local_index));
+		num_calls++;
+	}
+	void addGhostToRHS(std::shared_ptr<const PatchInfo<D>> pinfo,
+	                   const PatchView<D> &                us,
+	                   PatchView<D> &                      fs) const override
+	{
+	}
+	int getNumCalls() const
+	{
+		return num_calls;
+	}
+};
+template <int D> class DoublingPatchOperator : public PatchOperator<D>
+{
+	public:
+	DoublingPatchOperator(std::shared_ptr<const Domain<D>>      domain,
+	                      std::shared_ptr<const GhostFiller<D>> ghost_filler)
+	: PatchOperator<D>(domain, ghost_filler)
+	{
+	}
+	void applySinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
+	                      const PatchView<D> &us, PatchView<D> &fs,
+	                      bool treat_interior_boundary_as_dirichlet) const override
+	{
+		for (size_t c = 0; c < fs.size(); c++) {
+			nested_loop<D>(fs[c].getStart(), fs[c].getEnd(), [&](const std::array<int, D> &coord) {
+				fs[c][coord] = 2 * us[c][coord];
+			});
+		}
+	}
+	void addGhostToRHS(std::shared_ptr<const PatchInfo<D>> pinfo,
+	                   const PatchView<D> &                us,
+	                   PatchView<D> &                      fs) const override
+	{
+	}
+};
 template <int D> class MockPatchOperator : public PatchOperator<D>
 {
 	private:
@@ -65,7 +157,7 @@ template <int D> class MockPatchOperator : public PatchOperator<D>
 		}
 	}
 	void applySinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                      const std::vector<LocalData<D>> &us, std::vector<LocalData<D>> &fs,
+	                      const PatchView<D> &us, PatchView<D> &fs,
 	                      bool treat_interior_boundary_as_dirichlet) const override
 	{
 		CHECK_FALSE(treat_interior_boundary_as_dirichlet);
@@ -82,8 +174,8 @@ template <int D> class MockPatchOperator : public PatchOperator<D>
 		}
 	}
 	void addGhostToRHS(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                   const std::vector<LocalData<D>> &   us,
-	                   std::vector<LocalData<D>> &         fs) const override
+	                   const PatchView<D> &                us,
+	                   PatchView<D> &                      fs) const override
 	{
 	}
 	bool allPatchesCalled()
@@ -75,4 +75,87 @@ TEST_CASE("PatchOperator check getGhostFiller", "[PatchOperator]")
 	MockPatchOperator<2> mpo(d_fine, mgf, u, f);
 
 	CHECK(mpo.getGhostFiller() == mgf);
-}
\ No newline at end of file
+}
+TEST_CASE("PatchOperator apply splits patches around fillGhostFinish", "[PatchOperator]")
+{
+	auto mesh_file
+	= GENERATE(as<std::string>{}, single_mesh_file, refined_mesh_file, cross_mesh_file);
+	INFO("MESH: " << mesh_file);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {4, 4}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto u = ValVector<2>::GetNewVector(d_fine, 1);
+	auto f = ValVector<2>::GetNewVector(d_fine, 1);
+
+	auto                          mgf = make_shared<SplitMockGhostFiller<2>>();
+	SplitCheckingPatchOperator<2> mpo(d_fine, mgf);
+
+	mpo.apply(u, f);
+
+	CHECK(mgf->wasFinished());
+	CHECK(mpo.getNumCalls() == d_fine->getNumLocalPatches());
+}
+TEST_CASE("PatchOperator residual splits patches around fillGhostFinish", "[PatchOperator]")
+{
+	auto mesh_file
+	= GENERATE(as<std::string>{}, single_mesh_file, refined_mesh_file, cross_mesh_file);
+	INFO("MESH: " << mesh_file);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {4, 4}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto u = ValVector<2>::GetNewVector(d_fine, 1);
+	auto f = ValVector<2>::GetNewVector(d_fine, 1);
+	auto r = ValVector<2>::GetNewVector(d_fine, 1);
+
+	auto                          mgf = make_shared<SplitMockGhostFiller<2>>();
+	SplitCheckingPatchOperator<2> mpo(d_fine, mgf);
+
+	mpo.residual(f, u, r);
+
+	CHECK(mgf->wasFinished());
+	CHECK(mpo.getNumCalls() == d_fine->getNumLocalPatches());
+}
+TEST_CASE("PatchOperator residual is f minus the operator applied to u", "[PatchOperator]")
+{
+	auto mesh_file
+	= GENERATE(as<std::string>{}, single_mesh_file, refined_mesh_file, cross_mesh_file);
+	INFO("MESH: " << mesh_file);
+	auto                  num_components = GENERATE(1, 2);
+	int                   num_ghost      = 1;
+	DomainReader<2>       domain_reader(mesh_file, {4, 5}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto u = ValVector<2>::GetNewVector(d_fine, num_components);
+	auto f = ValVector<2>::GetNewVector(d_fine, num_components);
+	auto r = ValVector<2>::GetNewVector(d_fine, num_components);
+	for (int i = 0; i < u->getNumLocalPatches(); i++) {
+		for (int c = 0; c < num_components; c++) {
+			LocalData<2> u_ld = u->getLocalData(c, i);
+			LocalData<2> f_ld = f->getLocalData(c, i);
+			nested_loop<2>(u_ld.getStart(), u_ld.getEnd(), [&](const array<int, 2> &coord) {
+				u_ld[coord] = i + 0.5 * c + coord[0] - coord[1];
+				f_ld[coord] = 3 * coord[0] + coord[1] / 7.0;
+			});
+		}
+	}
+
+	auto                     mgf = make_shared<MockGhostFiller<2>>();
+	DoublingPatchOperator<2> dpo(d_fine, mgf);
+
+	double norm = dpo.residual(f, u, r, true);
+
+	for (int i = 0; i < u->getNumLocalPatches(); i++) {
+		for (int c = 0; c < num_components; c++) {
+			LocalData<2> u_ld = u->getLocalData(c, i);
+			LocalData<2> f_ld = f->getLocalData(c, i);
+			LocalData<2> r_ld = r->getLocalData(c, i);
+			nested_loop<2>(u_ld.getStart(), u_ld.getEnd(), [&](const array<int, 2> &coord) {
+				CHECK(r_ld[coord] == f_ld[coord] - 2 * u_ld[coord]);
+			});
+		}
+	}
+	CHECK(norm == Approx(r->twoNorm()));
+	CHECK(dpo.residual(f, u, r) == 0);
+}
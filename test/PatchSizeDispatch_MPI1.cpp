@@ -0,0 +1,160 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "utils/DomainReader.h"
+#include "catch.hpp"
+#include <ThunderEgg/DomainTools.h>
+#include <ThunderEgg/GMG/LinearRestrictor.h>
+#include <ThunderEgg/PatchSizeDispatch.h>
+#include <ThunderEgg/ValVector.h>
+using namespace std;
+using namespace ThunderEgg;
+#define MESHES                                                                                     \
+	"mesh_inputs/2d_uniform_4x4_mpi1.json", "mesh_inputs/2d_uniform_2x2_refined_nw_mpi1.json",     \
+	"mesh_inputs/2d_uniform_8x8_refined_cross_mpi1.json"
+#define MESHES_3D                                                                                  \
+	"mesh_inputs/3d_uniform_2x2x2_mpi1.json", "mesh_inputs/3d_refined_bnw_2x2x2_mpi1.json"
+namespace
+{
+/**
+ * @brief Check that the two vectors are equal, including the ghost cells
+ */
+template <int D>
+void CheckVectorsEqual(shared_ptr<const Domain<D>> domain, shared_ptr<const Vector<D>> expected,
+                       shared_ptr<const Vector<D>> vec)
+{
+	for (auto pinfo : domain->getPatchInfoVector()) {
+		for (int c = 0; c < expected->getNumComponents(); c++) {
+			LocalData<D> expected_ld = expected->getLocalData(c, pinfo->local_index);
+			LocalData<D> ld          = vec->getLocalData(c, pinfo->local_index);
+			nested_loop<D>(ld.getGhostStart(), ld.getGhostEnd(), [&](const array<int, D> &coord) {
+				REQUIRE(ld[coord] == Approx(expected_ld[coord]).margin(1e-10));
+			});
+		}
+	}
+}
+/**
+ * @brief Kernel that records which patch size it was called with
+ */
+template <int D, int N> struct RecordSizeKernel {
+	static void run(int &n)
+	{
+		n = N;
+	}
+};
+} // namespace
+TEST_CASE("PatchSizeDispatch GetSpecializedSize", "[PatchSizeDispatch]")
+{
+	CHECK(PatchSizeDispatch::GetSpecializedSize<2>({8, 8}) == 8);
+	CHECK(PatchSizeDispatch::GetSpecializedSize<2>({16, 16}) == 16);
+	CHECK(PatchSizeDispatch::GetSpecializedSize<3>({32, 32, 32}) == 32);
+	CHECK(PatchSizeDispatch::GetSpecializedSize<3>({64, 64, 64}) == 64);
+	CHECK(PatchSizeDispatch::GetSpecializedSize<2>({8, 16}) == 0);
+	CHECK(PatchSizeDispatch::GetSpecializedSize<2>({10, 10}) == 0);
+	CHECK(PatchSizeDispatch::GetSpecializedSize<3>({16, 16, 8}) == 0);
+}
+TEST_CASE("PatchSizeDispatch Dispatch", "[PatchSizeDispatch]")
+{
+	int n = GENERATE(8, 16, 32, 64);
+
+	int called_n = 0;
+	CHECK(PatchSizeDispatch::Dispatch<RecordSizeKernel, 2>({n, n}, called_n));
+	CHECK(called_n == n);
+}
+TEST_CASE("PatchSizeDispatch Dispatch returns false for unmatched sizes", "[PatchSizeDispatch]")
+{
+	int called_n = 0;
+	CHECK_FALSE(PatchSizeDispatch::Dispatch<RecordSizeKernel, 2>({10, 10}, called_n));
+	CHECK_FALSE(PatchSizeDispatch::Dispatch<RecordSizeKernel, 2>({8, 16}, called_n));
+	CHECK(called_n == 0);
+}
+TEST_CASE("PatchSizeDispatch Dispatch returns false when disabled", "[PatchSizeDispatch]")
+{
+	PatchSizeDispatch::SetEnabled(false);
+	CHECK_FALSE(PatchSizeDispatch::IsEnabled());
+	int called_n = 0;
+	CHECK_FALSE(PatchSizeDispatch::Dispatch<RecordSizeKernel, 2>({8, 8}, called_n));
+	CHECK(called_n == 0);
+	PatchSizeDispatch::SetEnabled(true);
+	CHECK(PatchSizeDispatch::IsEnabled());
+}
+TEST_CASE("PatchSizeDispatch 2d LinearRestrictor matches the generic version",
+          "[PatchSizeDispatch]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH FILE " << mesh_file);
+	int n = GENERATE(8, 16);
+	INFO("n " << n);
+	DomainReader<2>       domain_reader(mesh_file, {n, n}, 1);
+	shared_ptr<Domain<2>> d_fine   = domain_reader.getFinerDomain();
+	shared_ptr<Domain<2>> d_coarse = domain_reader.getCoarserDomain();
+
+	auto ufun = [](const std::array<double, 2> &coord) {
+		return sin(M_PI * coord[0]) * cos(2 * M_PI * coord[1]);
+	};
+
+	auto u = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<2>(d_fine, u, ufun);
+
+	GMG::LinearRestrictor<2> restrictor(d_fine, d_coarse, 1);
+
+	shared_ptr<Vector<2>> coarse[2];
+	for (int enabled = 0; enabled < 2; enabled++) {
+		PatchSizeDispatch::SetEnabled(enabled);
+
+		coarse[enabled] = ValVector<2>::GetNewVector(d_coarse, 1);
+		restrictor.restrict(u, coarse[enabled]);
+	}
+	PatchSizeDispatch::SetEnabled(true);
+
+	CheckVectorsEqual<2>(d_coarse, coarse[0], coarse[1]);
+}
+TEST_CASE("PatchSizeDispatch 3d LinearRestrictor matches the generic version",
+          "[PatchSizeDispatch]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES_3D);
+	INFO("MESH FILE " << mesh_file);
+	int n = GENERATE(8, 16);
+	INFO("n " << n);
+	DomainReader<3>       domain_reader(mesh_file, {n, n, n}, 1);
+	shared_ptr<Domain<3>> d_fine   = domain_reader.getFinerDomain();
+	shared_ptr<Domain<3>> d_coarse = domain_reader.getCoarserDomain();
+
+	auto ufun = [](const std::array<double, 3> &coord) {
+		return sin(M_PI * coord[0]) * cos(2 * M_PI * coord[1]) * coord[2];
+	};
+
+	auto u = ValVector<3>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<3>(d_fine, u, ufun);
+
+	GMG::LinearRestrictor<3> restrictor(d_fine, d_coarse, 1);
+
+	shared_ptr<Vector<3>> coarse[2];
+	for (int enabled = 0; enabled < 2; enabled++) {
+		PatchSizeDispatch::SetEnabled(enabled);
+
+		coarse[enabled] = ValVector<3>::GetNewVector(d_coarse, 1);
+		restrictor.restrict(u, coarse[enabled]);
+	}
+	PatchSizeDispatch::SetEnabled(true);
+
+	CheckVectorsEqual<3>(d_coarse, coarse[0], coarse[1]);
+}
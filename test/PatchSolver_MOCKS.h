@@ -62,8 +62,8 @@ template <int D> class MockPatchSolver : public PatchSolver<D>
 		}
 	}
 	void solveSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                      const std::vector<LocalData<D>> &   fs,
-	                      std::vector<LocalData<D>> &         us) const override
+	                      const PatchView<D> &                fs,
+	                      PatchView<D> &                      us) const override
 	{
 		CHECK(patches_to_be_called.count(pinfo) == 1);
 		patches_to_be_called.erase(pinfo);
@@ -79,5 +79,68 @@ template <int D> class MockPatchSolver : public PatchSolver<D>
 		return patches_to_be_called.empty();
 	}
 };
+template <int D> class SplitMockGhostFiller : public GhostFiller<D>
+{
+	private:
+	mutable bool started  = false;
+	mutable bool finished = false;
+
+	public:
+	void fillGhost(std::shared_ptr<const Vector<D>> u) const override
+	{
+		fillGhostStart(u);
+		fillGhostFinish(u);
+	}
+	void fillGhostStart(std::shared_ptr<const Vector<D>> u) const override
+	{
+		CHECK_FALSE(started);
+		started = true;
+	}
+	void fillGhostFinish(std::shared_ptr<const Vector<D>> u) const override
+	{
+		CHECK(started);
+		CHECK_FALSE(finished);
+		finished = true;
+	}
+	bool needsFillGhostFinish(int patch_local_index) const override
+	{
+		return patch_local_index % 2 == 1;
+	}
+	bool wasStarted() const
+	{
+		return started;
+	}
+	bool wasFinished() const
+	{
+		return finished;
+	}
+};
+template <int D> class SplitCheckingPatchSolver : public PatchSolver<D>
+{
+	private:
+	std::shared_ptr<const SplitMockGhostFiller<D>> split_ghost_filler;
+	mutable int                                    num_calls = 0;
+
+	public:
+	SplitCheckingPatchSolver(std::shared_ptr<const Domain<D>>               domain_in,
+	                         std::shared_ptr<const SplitMockGhostFiller<D>> ghost_filler_in)
+	: PatchSolver<D>(domain_in, ghost_filler_in), split_ghost_filler(ghost_filler_in)
+	{
+	}
+	void solveSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
+	                      const PatchView<D> &                fs,
+	                      PatchView<D> &                      us) const override
+	{
+		INFO("LOCAL_INDEX: " << pinfo->local_index);
+		CHECK(split_ghost_filler->wasStarted());
+		CHECK(split_ghost_filler->wasFinished()
+		      == split_ghost_filler->needsFillGhostFinish(pinfo->local_index));
+		num_calls++;
+	}
+	int getNumCalls() const
+	{
+		return num_calls;
+	}
+};
 } // namespace
 } // namespace ThunderEgg
\ No newline at end of file
@@ -188,4 +188,24 @@ TEST_CASE("PatchSolver getGhostFiller", "[PatchSolver]")
 	MockPatchSolver<2> mps(d_fine, mgf, u, f);
 
 	CHECK(mps.getGhostFiller() == mgf);
-}
\ No newline at end of file
+}
+TEST_CASE("PatchSolver smooth splits patches around fillGhostFinish", "[PatchSolver]")
+{
+	auto mesh_file
+	= GENERATE(as<std::string>{}, single_mesh_file, refined_mesh_file, cross_mesh_file);
+	INFO("MESH: " << mesh_file);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {4, 4}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto u = ValVector<2>::GetNewVector(d_fine, 1);
+	auto f = ValVector<2>::GetNewVector(d_fine, 1);
+
+	auto                        mgf = make_shared<SplitMockGhostFiller<2>>();
+	SplitCheckingPatchSolver<2> mps(d_fine, mgf);
+
+	mps.smooth(f, u);
+
+	CHECK(mgf->wasFinished());
+	CHECK(mps.getNumCalls() == d_fine->getNumLocalPatches());
+}
@@ -0,0 +1,89 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "Vector_MOCKS.h"
+#include "catch.hpp"
+#include <ThunderEgg/PatchView.h>
+using namespace std;
+using namespace ThunderEgg;
+TEST_CASE("PatchView<2> default constructor", "[PatchView]")
+{
+	PatchView<2> view;
+	CHECK(view.size() == 0);
+	CHECK(view.begin() == view.end());
+}
+TEST_CASE("PatchView<2> num_components constructor", "[PatchView]")
+{
+	int          num_components = GENERATE(1, 2, 4, 5, 9);
+	PatchView<2> view(num_components);
+	CHECK(view.size() == (size_t) num_components);
+	CHECK(view.end() - view.begin() == num_components);
+	CHECK(view.data() == view.begin());
+	CHECK(&view[num_components - 1] == view.end() - 1);
+}
+TEST_CASE("PatchView<2> initializer_list constructor", "[PatchView]")
+{
+	double       data[6];
+	LocalData<2> a(data, {1, 2}, {1, 1}, 0);
+	LocalData<2> b(data + 2, {1, 2}, {1, 1}, 0);
+	LocalData<2> c(data + 4, {1, 2}, {1, 1}, 0);
+	PatchView<2> view = {a, b, c};
+	CHECK(view.size() == 3);
+	CHECK(view[0].getPtr() == data);
+	CHECK(view[1].getPtr() == data + 2);
+	CHECK(view[2].getPtr() == data + 4);
+}
+TEST_CASE("PatchView<2> copy keeps the LocalData objects", "[PatchView]")
+{
+	int                 num_components = GENERATE(1, 4, 5, 9);
+	std::vector<double> data(num_components);
+	PatchView<2>        view(num_components);
+	for (int c = 0; c < num_components; c++) {
+		view[c] = LocalData<2>(data.data() + c, {1, 1}, {1, 1}, 0);
+	}
+	const PatchView<2> copy = view;
+	REQUIRE(copy.size() == (size_t) num_components);
+	int c = 0;
+	for (const LocalData<2> &ld : copy) {
+		CHECK(ld.getPtr() == data.data() + c);
+		c++;
+	}
+	CHECK(copy.data() != view.data());
+}
+TEST_CASE("Vector<3> getLocalDatas returns a PatchView", "[PatchView]")
+{
+	int           num_components    = GENERATE(1, 2, 3, 4, 5, 6);
+	array<int, 3> ns                = {2, 3, 4};
+	int           num_local_patches = GENERATE(1, 3);
+
+	auto vec = make_shared<MockVector<3>>(MPI_COMM_WORLD, num_components, num_local_patches, 1, ns);
+	auto const_vec = std::const_pointer_cast<const MockVector<3>>(vec);
+	for (int i = 0; i < num_local_patches; i++) {
+		PatchView<3>       lds       = vec->getLocalDatas(i);
+		const PatchView<3> const_lds = const_vec->getLocalDatas(i);
+		REQUIRE(lds.size() == (size_t) num_components);
+		REQUIRE(const_lds.size() == (size_t) num_components);
+		for (int c = 0; c < num_components; c++) {
+			CHECK(lds[c].getPtr() == vec->getLocalData(c, i).getPtr());
+			CHECK(const_lds[c].getPtr() == vec->getLocalData(c, i).getPtr());
+		}
+	}
+}
@@ -0,0 +1,185 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "../utils/DomainReader.h"
+#include "catch.hpp"
+#include <ThunderEgg/BiLinearGhostFiller.h>
+#include <ThunderEgg/DomainTools.h>
+#include <ThunderEgg/Poisson/StarJacobiSmoother.h>
+#include <ThunderEgg/Poisson/StarPatchOperator.h>
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/ValVector.h>
+using namespace std;
+using namespace ThunderEgg;
+#define MESHES                                                                                     \
+	"mesh_inputs/2d_uniform_2x2_nw_on_1_mpi2.json", "mesh_inputs/2d_uniform_4x4_mid_on_1_mpi2.json"
+TEST_CASE("Poisson::StarJacobiSmoother two sets of ghost cells matches one set of ghost cells",
+          "[Poisson::StarJacobiSmoother]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH: " << mesh_file);
+	auto n          = GENERATE(4, 7);
+	auto num_sweeps = GENERATE(1, 2, 3, 4);
+	auto neumann    = GENERATE(false, true);
+	INFO("n:          " << n);
+	INFO("num_sweeps: " << num_sweeps);
+	INFO("neumann:    " << neumann);
+
+	DomainReader<2>       domain_reader_1(mesh_file, {n, n}, 1);
+	shared_ptr<Domain<2>> d_1 = domain_reader_1.getFinerDomain();
+	DomainReader<2>       domain_reader_2(mesh_file, {n, n}, 2);
+	shared_ptr<Domain<2>> d_2 = domain_reader_2.getFinerDomain();
+
+	auto ffun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return -5 * M_PI * M_PI * sin(M_PI * y) * cos(2 * M_PI * x);
+	};
+	auto ufun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return x * x - y;
+	};
+
+	auto f_1 = ValVector<2>::GetNewVector(d_1, 1);
+	auto u_1 = ValVector<2>::GetNewVector(d_1, 1);
+	DomainTools::SetValues<2>(d_1, f_1, ffun);
+	DomainTools::SetValues<2>(d_1, u_1, ufun);
+	auto f_2 = ValVector<2>::GetNewVector(d_2, 1);
+	auto u_2 = ValVector<2>::GetNewVector(d_2, 1);
+	DomainTools::SetValues<2>(d_2, f_2, ffun);
+	DomainTools::SetValues<2>(d_2, u_2, ufun);
+
+	auto gf_1 = make_shared<BiLinearGhostFiller>(d_1);
+	auto gf_2 = make_shared<BiLinearGhostFiller>(d_2);
+	gf_2->setFillCorners(true);
+
+	Poisson::StarJacobiSmoother<2> smoother_1(d_1, gf_1, num_sweeps, 2.0 / 3.0, neumann);
+	Poisson::StarJacobiSmoother<2> smoother_2(d_2, gf_2, num_sweeps, 2.0 / 3.0, neumann);
+	smoother_1.smooth(f_1, u_1);
+	smoother_2.smooth(f_2, u_2);
+
+	for (auto pinfo : d_1->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<2> u_1_ld = u_1->getLocalData(0, pinfo->local_index);
+		LocalData<2> u_2_ld = u_2->getLocalData(0, pinfo->local_index);
+		nested_loop<2>(u_1_ld.getStart(), u_1_ld.getEnd(), [&](const array<int, 2> &coord) {
+			INFO("xi:    " << coord[0]);
+			INFO("yi:    " << coord[1]);
+			CHECK(u_2_ld[coord] == Approx(u_1_ld[coord]));
+		});
+	}
+}
+TEST_CASE("Poisson::StarJacobiSmoother reduces the residual", "[Poisson::StarJacobiSmoother]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH: " << mesh_file);
+	auto n = GENERATE(4, 7);
+	INFO("n:          " << n);
+
+	DomainReader<2>       domain_reader(mesh_file, {n, n}, 2);
+	shared_ptr<Domain<2>> d = domain_reader.getFinerDomain();
+
+	auto ffun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return -5 * M_PI * M_PI * sin(M_PI * y) * cos(2 * M_PI * x);
+	};
+
+	auto f = ValVector<2>::GetNewVector(d, 1);
+	auto u = ValVector<2>::GetNewVector(d, 1);
+	auto r = ValVector<2>::GetNewVector(d, 1);
+	DomainTools::SetValues<2>(d, f, ffun);
+
+	auto gf = make_shared<BiLinearGhostFiller>(d);
+	gf->setFillCorners(true);
+	Poisson::StarPatchOperator<2>  op(d, gf);
+	Poisson::StarJacobiSmoother<2> smoother(d, gf, 4);
+
+	smoother.smooth(f, u);
+	op.apply(u, r);
+	r->scaleThenAdd(-1, f);
+
+	CHECK(r->twoNorm() < f->twoNorm());
+}
+TEST_CASE("Poisson::StarJacobiSmoother tiled residual matches untiled residual",
+          "[Poisson::StarJacobiSmoother]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH: " << mesh_file);
+	auto          n          = GENERATE(4, 7);
+	auto          num_ghost  = GENERATE(1, 2);
+	auto          neumann    = GENERATE(false, true);
+	array<int, 2> tile_sizes = GENERATE(array<int, 2>{0, 2}, array<int, 2>{3, 5});
+	INFO("n:          " << n);
+	INFO("num_ghost:  " << num_ghost);
+	INFO("neumann:    " << neumann);
+	INFO("tile sizes: " << tile_sizes[0] << " " << tile_sizes[1]);
+
+	DomainReader<2>       domain_reader(mesh_file, {n, n}, num_ghost);
+	shared_ptr<Domain<2>> d = domain_reader.getFinerDomain();
+
+	auto ffun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return -5 * M_PI * M_PI * sin(M_PI * y) * cos(2 * M_PI * x);
+	};
+	auto ufun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return x * x - y;
+	};
+
+	auto f       = ValVector<2>::GetNewVector(d, 1);
+	auto u       = ValVector<2>::GetNewVector(d, 1);
+	auto u_tiled = ValVector<2>::GetNewVector(d, 1);
+	DomainTools::SetValues<2>(d, f, ffun);
+	DomainTools::SetValues<2>(d, u, ufun);
+	DomainTools::SetValues<2>(d, u_tiled, ufun);
+
+	auto gf = make_shared<BiLinearGhostFiller>(d);
+	gf->setFillCorners(true);
+	Poisson::StarJacobiSmoother<2> smoother(d, gf, 3, 2.0 / 3.0, neumann);
+	CHECK(smoother.getTileSizes() == array<int, 2>{0, 0});
+	smoother.smooth(f, u);
+	smoother.setTileSizes(tile_sizes);
+	CHECK(smoother.getTileSizes() == tile_sizes);
+	smoother.smooth(f, u_tiled);
+
+	for (auto pinfo : d->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<2> u_ld       = u->getLocalData(0, pinfo->local_index);
+		LocalData<2> u_tiled_ld = u_tiled->getLocalData(0, pinfo->local_index);
+		nested_loop<2>(u_ld.getStart(), u_ld.getEnd(), [&](const array<int, 2> &coord) {
+			INFO("xi:    " << coord[0]);
+			INFO("yi:    " << coord[1]);
+			CHECK(u_tiled_ld[coord] == Approx(u_ld[coord]));
+		});
+	}
+}
+TEST_CASE("Poisson::StarJacobiSmoother throws without corners", "[Poisson::StarJacobiSmoother]")
+{
+	DomainReader<2>       domain_reader("mesh_inputs/2d_uniform_2x2_nw_on_1_mpi2.json", {4, 4}, 2);
+	shared_ptr<Domain<2>> d = domain_reader.getFinerDomain();
+
+	auto gf = make_shared<BiLinearGhostFiller>(d);
+	CHECK_THROWS_AS(Poisson::StarJacobiSmoother<2>(d, gf), RuntimeError);
+}
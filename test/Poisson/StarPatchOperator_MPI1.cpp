@@ -26,6 +26,7 @@
 #include <ThunderEgg/DomainTools.h>
 #include <ThunderEgg/GMG/LinearRestrictor.h>
 #include <ThunderEgg/Poisson/StarPatchOperator.h>
+#include <ThunderEgg/TriLinearGhostFiller.h>
 #include <ThunderEgg/ValVector.h>
 using namespace std;
 using namespace ThunderEgg;
@@ -319,4 +320,156 @@ TEST_CASE("Test Poisson::StarPatchOperator constructor throws exception with no
 	auto gf = make_shared<BiLinearGhostFiller>(d_fine);
 	CHECK_THROWS_AS(make_shared<Poisson::StarPatchOperator<2>>(d_fine, gf),
 	                ThunderEgg::RuntimeError);
-}
\ No newline at end of file
+}
+TEST_CASE("Test Poisson::StarPatchOperator residual matches apply then subtract",
+          "[Poisson::StarPatchOperator]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH FILE " << mesh_file);
+	auto                  n         = GENERATE(5, 8);
+	auto                  neumann   = GENERATE(false, true);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {n, n}, num_ghost, neumann);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto gfun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return sin(M_PI * y) * cos(2 * M_PI * x);
+	};
+	auto ffun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return x * x + y;
+	};
+
+	auto u = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<2>(d_fine, u, gfun);
+	auto f = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<2>(d_fine, f, ffun);
+	auto r          = ValVector<2>::GetNewVector(d_fine, 1);
+	auto r_expected = ValVector<2>::GetNewVector(d_fine, 1);
+
+	auto                          gf = make_shared<BiLinearGhostFiller>(d_fine);
+	Poisson::StarPatchOperator<2> p_operator(d_fine, gf, neumann);
+	p_operator.apply(u, r_expected);
+	r_expected->scaleThenAdd(-1, f);
+
+	CHECK(p_operator.residual(f, u, r) == 0);
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<2> r_ld          = r->getLocalData(0, pinfo->local_index);
+		LocalData<2> r_expected_ld = r_expected->getLocalData(0, pinfo->local_index);
+		nested_loop<2>(r_ld.getStart(), r_ld.getEnd(), [&](const array<int, 2> &coord) {
+			INFO("xi:    " << coord[0]);
+			INFO("yi:    " << coord[1]);
+			CHECK(r_ld[coord] == Approx(r_expected_ld[coord]));
+		});
+	}
+
+	r->set(0);
+	double norm = p_operator.residual(f, u, r, true);
+	CHECK(norm == Approx(r->twoNorm()));
+	CHECK(norm == Approx(r_expected->twoNorm()));
+}
+TEST_CASE("Test Poisson::StarPatchOperator tiled stencil matches untiled stencil in 3d",
+          "[Poisson::StarPatchOperator]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, "mesh_inputs/3d_uniform_2x2x2_mpi1.json",
+	                          "mesh_inputs/3d_refined_bnw_2x2x2_mpi1.json");
+	INFO("MESH FILE " << mesh_file);
+	auto          n       = GENERATE(6, 8);
+	auto          neumann = GENERATE(false, true);
+	array<int, 3> tile_sizes
+	= GENERATE(array<int, 3>{0, 3, 0}, array<int, 3>{0, 5, 4}, array<int, 3>{4, 2, 3});
+	INFO("tile sizes: " << tile_sizes[0] << " " << tile_sizes[1] << " " << tile_sizes[2]);
+	int                   num_ghost = 1;
+	DomainReader<3>       domain_reader(mesh_file, {n, n, n}, num_ghost, neumann);
+	shared_ptr<Domain<3>> d_fine = domain_reader.getFinerDomain();
+
+	auto gfun = [](const std::array<double, 3> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		double z = coord[2];
+		return sin(M_PI * y) * cos(2 * M_PI * x) * exp(z);
+	};
+	auto ffun = [](const std::array<double, 3> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		double z = coord[2];
+		return x * y - z;
+	};
+
+	auto u = ValVector<3>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<3>(d_fine, u, gfun);
+	auto f = ValVector<3>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<3>(d_fine, f, ffun);
+	auto g       = ValVector<3>::GetNewVector(d_fine, 1);
+	auto g_tiled = ValVector<3>::GetNewVector(d_fine, 1);
+	auto r       = ValVector<3>::GetNewVector(d_fine, 1);
+	auto r_tiled = ValVector<3>::GetNewVector(d_fine, 1);
+
+	auto                          gf = make_shared<TriLinearGhostFiller>(d_fine);
+	Poisson::StarPatchOperator<3> p_operator(d_fine, gf, neumann);
+	CHECK(p_operator.getTileSizes() == array<int, 3>{0, 0, 0});
+	p_operator.apply(u, g);
+	p_operator.residual(f, u, r);
+	p_operator.setTileSizes(tile_sizes);
+	CHECK(p_operator.getTileSizes() == tile_sizes);
+	p_operator.apply(u, g_tiled);
+	p_operator.residual(f, u, r_tiled);
+
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<3> g_ld       = g->getLocalData(0, pinfo->local_index);
+		LocalData<3> g_tiled_ld = g_tiled->getLocalData(0, pinfo->local_index);
+		LocalData<3> r_ld       = r->getLocalData(0, pinfo->local_index);
+		LocalData<3> r_tiled_ld = r_tiled->getLocalData(0, pinfo->local_index);
+		nested_loop<3>(g_ld.getStart(), g_ld.getEnd(), [&](const array<int, 3> &coord) {
+			INFO("xi:    " << coord[0]);
+			INFO("yi:    " << coord[1]);
+			INFO("zi:    " << coord[2]);
+			CHECK(g_tiled_ld[coord] == g_ld[coord]);
+			CHECK(r_tiled_ld[coord] == r_ld[coord]);
+		});
+	}
+}
+TEST_CASE("Test Poisson::StarPatchOperator getInverseDiagonal matches the stencil",
+          "[Poisson::StarPatchOperator]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH FILE " << mesh_file);
+	auto                  nx        = GENERATE(1, 4);
+	auto                  ny        = GENERATE(3, 4);
+	auto                  neumann   = GENERATE(false, true);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost, neumann);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto inv_diag = ValVector<2>::GetNewVector(d_fine, 2);
+	auto u        = ValVector<2>::GetNewVector(d_fine, 1);
+	auto f        = ValVector<2>::GetNewVector(d_fine, 1);
+
+	auto                          gf = make_shared<BiLinearGhostFiller>(d_fine);
+	Poisson::StarPatchOperator<2> p_operator(d_fine, gf, neumann);
+	p_operator.getInverseDiagonal(inv_diag);
+
+	// apply the stencil to each unit vector of a patch, with the interior ghost cells set to 0
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		PatchView<2> us = u->getLocalDatas(pinfo->local_index);
+		PatchView<2> fs = f->getLocalDatas(pinfo->local_index);
+		for (int c = 0; c < 2; c++) {
+			LocalData<2> inv_diag_ld = inv_diag->getLocalData(c, pinfo->local_index);
+			nested_loop<2>(us[0].getStart(), us[0].getEnd(), [&](const array<int, 2> &coord) {
+				INFO("xi:    " << coord[0]);
+				INFO("yi:    " << coord[1]);
+				nested_loop<2>(us[0].getGhostStart(), us[0].getGhostEnd(),
+				               [&](const array<int, 2> &coord) { us[0][coord] = 0; });
+				us[0][coord] = 1;
+				p_operator.applySinglePatch(pinfo, us, fs, false);
+				CHECK(inv_diag_ld[coord] == Approx(1 / fs[0][coord]));
+			});
+		}
+	}
+}
@@ -0,0 +1,184 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "catch.hpp"
+#include <ThunderEgg/PooledVectorGenerator.h>
+#include <ThunderEgg/ValVector.h>
+using namespace std;
+using namespace ThunderEgg;
+namespace
+{
+/**
+ * @brief Generates ValVectors and counts how many were generated
+ */
+class CountingVG : public VectorGenerator<2>
+{
+	public:
+	mutable int num_generated = 0;
+	shared_ptr<Vector<2>> getNewVector() const override
+	{
+		num_generated++;
+		return make_shared<ValVector<2>>(MPI_COMM_WORLD, array<int, 2>{3, 4}, 1, 2, 5);
+	}
+};
+/**
+ * @brief Generates ValVectors with padded rows
+ */
+class AlignedVG : public VectorGenerator<2>
+{
+	public:
+	shared_ptr<Vector<2>> getNewVector() const override
+	{
+		ValVectorLayout layout;
+		layout.aligned = true;
+		return make_shared<ValVector<2>>(MPI_COMM_WORLD, array<int, 2>{3, 4}, 1, 2, 5, layout);
+	}
+};
+// 5 patches with 2 components of 5x6 cells
+const size_t vector_num_bytes = 5 * 2 * 5 * 6 * sizeof(double);
+} // namespace
+TEST_CASE("PooledVectorGenerator throws with null generator", "[PooledVectorGenerator]")
+{
+	CHECK_THROWS_AS(PooledVectorGenerator<2>(nullptr), RuntimeError);
+}
+TEST_CASE("PooledVectorGenerator initial statistics", "[PooledVectorGenerator]")
+{
+	auto                     counting_vg = make_shared<CountingVG>();
+	PooledVectorGenerator<2> vg(counting_vg);
+	CHECK(vg.getNumHits() == 0);
+	CHECK(vg.getNumMisses() == 0);
+	CHECK(vg.getNumFreeVectors() == 0);
+	CHECK(vg.getNumBytes() == 0);
+	CHECK(vg.getPeakNumBytes() == 0);
+	CHECK(counting_vg->num_generated == 0);
+}
+TEST_CASE("PooledVectorGenerator allocates when the free list is empty",
+          "[PooledVectorGenerator]")
+{
+	auto                     counting_vg = make_shared<CountingVG>();
+	PooledVectorGenerator<2> vg(counting_vg);
+
+	auto a = vg.getNewVector();
+	auto b = vg.getNewVector();
+	CHECK(a != b);
+	CHECK(a->getNumComponents() == 2);
+	CHECK(a->getNumLocalPatches() == 5);
+	CHECK(counting_vg->num_generated == 2);
+	CHECK(vg.getNumHits() == 0);
+	CHECK(vg.getNumMisses() == 2);
+	CHECK(vg.getNumFreeVectors() == 0);
+	CHECK(vg.getNumBytes() == 2 * vector_num_bytes);
+	CHECK(vg.getPeakNumBytes() == 2 * vector_num_bytes);
+}
+TEST_CASE("PooledVectorGenerator returns vectors to the free list", "[PooledVectorGenerator]")
+{
+	auto                     counting_vg = make_shared<CountingVG>();
+	PooledVectorGenerator<2> vg(counting_vg);
+
+	auto a = vg.getNewVector();
+	auto b = vg.getNewVector();
+
+	Vector<2> *a_ptr = a.get();
+	auto       a_copy = a;
+	a                 = nullptr;
+	CHECK(vg.getNumFreeVectors() == 0);
+	a_copy = nullptr;
+	CHECK(vg.getNumFreeVectors() == 1);
+
+	auto c = vg.getNewVector();
+	CHECK(c.get() == a_ptr);
+	CHECK(counting_vg->num_generated == 2);
+	CHECK(vg.getNumHits() == 1);
+	CHECK(vg.getNumMisses() == 2);
+	CHECK(vg.getNumFreeVectors() == 0);
+	CHECK(vg.getNumBytes() == 2 * vector_num_bytes);
+	CHECK(vg.getPeakNumBytes() == 2 * vector_num_bytes);
+}
+TEST_CASE("PooledVectorGenerator recycled vectors are zero", "[PooledVectorGenerator]")
+{
+	PooledVectorGenerator<2> vg(make_shared<CountingVG>());
+
+	auto a = vg.getNewVector();
+	a->setWithGhost(3);
+	a = nullptr;
+
+	auto b = vg.getNewVector();
+	REQUIRE(vg.getNumHits() == 1);
+	for (int i = 0; i < b->getNumLocalPatches(); i++) {
+		for (int c = 0; c < b->getNumComponents(); c++) {
+			LocalData<2> ld = b->getLocalData(c, i);
+			nested_loop<2>(ld.getGhostStart(), ld.getGhostEnd(),
+			               [&](const array<int, 2> &coord) { CHECK(ld[coord] == 0); });
+		}
+	}
+}
+TEST_CASE("PooledVectorGenerator steady state does not allocate", "[PooledVectorGenerator]")
+{
+	auto                     counting_vg = make_shared<CountingVG>();
+	PooledVectorGenerator<2> vg(counting_vg);
+
+	for (int i = 0; i < 10; i++) {
+		auto a = vg.getNewVector();
+		auto b = vg.getNewVector();
+		auto c = vg.getNewVector();
+	}
+	CHECK(counting_vg->num_generated == 3);
+	CHECK(vg.getNumMisses() == 3);
+	CHECK(vg.getNumHits() == 27);
+	CHECK(vg.getNumFreeVectors() == 3);
+	CHECK(vg.getPeakNumBytes() == 3 * vector_num_bytes);
+}
+TEST_CASE("PooledVectorGenerator counts the padding of aligned vectors", "[PooledVectorGenerator]")
+{
+	PooledVectorGenerator<2> vg(make_shared<AlignedVG>());
+
+	auto a = vg.getNewVector();
+	CHECK(vg.getNumBytes() == a->getNumLocalBytes());
+	CHECK(vg.getNumBytes() > vector_num_bytes);
+}
+TEST_CASE("PooledVectorGenerator clear", "[PooledVectorGenerator]")
+{
+	auto                     counting_vg = make_shared<CountingVG>();
+	PooledVectorGenerator<2> vg(counting_vg);
+
+	auto a = vg.getNewVector();
+	vg.getNewVector();
+	CHECK(vg.getNumFreeVectors() == 1);
+
+	vg.clear();
+	CHECK(vg.getNumFreeVectors() == 0);
+	CHECK(vg.getNumBytes() == vector_num_bytes);
+	CHECK(vg.getPeakNumBytes() == 2 * vector_num_bytes);
+
+	a = nullptr;
+	CHECK(vg.getNumFreeVectors() == 1);
+}
+TEST_CASE("PooledVectorGenerator vectors outlive the generator", "[PooledVectorGenerator]")
+{
+	shared_ptr<Vector<2>> a;
+	{
+		PooledVectorGenerator<2> vg(make_shared<CountingVG>());
+		a = vg.getNewVector();
+	}
+	a->set(1);
+	CHECK(a->twoNorm() > 0);
+	a = nullptr;
+}
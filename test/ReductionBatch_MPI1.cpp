@@ -0,0 +1,164 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "Vector_MOCKS.h"
+#include "catch.hpp"
+#include <ThunderEgg/ReductionBatch.h>
+using namespace std;
+using namespace ThunderEgg;
+TEST_CASE("ReductionBatch<3> matches Vector reductions", "[ReductionBatch]")
+{
+	int           num_components    = GENERATE(1, 2, 3);
+	auto          num_ghost_cells   = GENERATE(0, 1, 5);
+	int           nx                = GENERATE(1, 4, 5);
+	int           ny                = GENERATE(1, 4, 5);
+	int           nz                = GENERATE(1, 4, 5);
+	array<int, 3> ns                = {nx, ny, nz};
+	int           num_local_patches = GENERATE(1, 13);
+
+	auto a = make_shared<MockVector<3>>(MPI_COMM_WORLD, num_components, num_local_patches,
+	                                    num_ghost_cells, ns);
+	auto b = make_shared<MockVector<3>>(MPI_COMM_WORLD, num_components, num_local_patches,
+	                                    num_ghost_cells, ns);
+
+	INFO("num_ghost_cells:   " << num_ghost_cells);
+	INFO("nx:                " << nx);
+	INFO("ny:                " << ny);
+	INFO("nz:                " << nz);
+	INFO("num_local_patches: " << num_local_patches);
+	INFO("num_components:    " << num_components);
+
+	for (size_t i = 0; i < a->data.size(); i++) {
+		double x   = (i + 0.5) / a->data.size();
+		a->data[i] = 10 - (x - 0.75) * (x - 0.75);
+	}
+
+	for (size_t i = 0; i < b->data.size(); i++) {
+		double x   = (i + 0.5) / b->data.size();
+		b->data[i] = (x - 0.5) * (x - 0.5) - 1;
+	}
+
+	ReductionBatch<3> batch;
+	int               a_dot_b_index  = batch.addDot(a, b);
+	int               a_norm_index   = batch.addTwoNorm(a);
+	int               b_inf_index    = batch.addInfNorm(b);
+	int               b_dot_b_index  = batch.addDot(b, b);
+	int               a_inf_index    = batch.addInfNorm(a);
+	int               b_norm_index   = batch.addTwoNorm(b);
+	int               num_reductions = batch.getNumReductions();
+	batch.evaluate();
+
+	CHECK(num_reductions == 6);
+	CHECK(batch.getResult(a_dot_b_index) == Approx(a->dot(b)));
+	CHECK(batch.getResult(a_norm_index) == Approx(a->twoNorm()));
+	CHECK(batch.getResult(b_inf_index) == Approx(b->infNorm()));
+	CHECK(batch.getResult(b_dot_b_index) == Approx(b->dot(b)));
+	CHECK(batch.getResult(a_inf_index) == Approx(a->infNorm()));
+	CHECK(batch.getResult(b_norm_index) == Approx(b->twoNorm()));
+}
+TEST_CASE("ReductionBatch<3> evaluate with no reductions", "[ReductionBatch]")
+{
+	ReductionBatch<3> batch;
+	batch.evaluate();
+	CHECK(batch.getNumReductions() == 0);
+}
+TEST_CASE("ReductionBatch<3> getResult throws before evaluate", "[ReductionBatch]")
+{
+	auto a = make_shared<MockVector<3>>(MPI_COMM_WORLD, 1, 1, 1, array<int, 3>{2, 2, 2});
+
+	ReductionBatch<3> batch;
+	int               index = batch.addTwoNorm(a);
+	CHECK_THROWS_AS(batch.getResult(index), RuntimeError);
+	batch.evaluate();
+	CHECK_NOTHROW(batch.getResult(index));
+	batch.addInfNorm(a);
+	CHECK_THROWS_AS(batch.getResult(index), RuntimeError);
+}
+TEST_CASE("ReductionBatch<3> getResult throws with invalid index", "[ReductionBatch]")
+{
+	auto a = make_shared<MockVector<3>>(MPI_COMM_WORLD, 1, 1, 1, array<int, 3>{2, 2, 2});
+
+	ReductionBatch<3> batch;
+	int               index = batch.addTwoNorm(a);
+	batch.evaluate();
+	CHECK_THROWS_AS(batch.getResult(index + 1), RuntimeError);
+	CHECK_THROWS_AS(batch.getResult(-1), RuntimeError);
+}
+TEST_CASE("ReductionBatch<3> throws with incompatible vectors", "[ReductionBatch]")
+{
+	auto a = make_shared<MockVector<3>>(MPI_COMM_WORLD, 1, 1, 1, array<int, 3>{2, 2, 2});
+	auto b = make_shared<MockVector<3>>(MPI_COMM_WORLD, 2, 1, 1, array<int, 3>{2, 2, 2});
+	auto c = make_shared<MockVector<3>>(MPI_COMM_WORLD, 1, 2, 1, array<int, 3>{2, 2, 2});
+
+	ReductionBatch<3> batch;
+	batch.addTwoNorm(a);
+	CHECK_THROWS_AS(batch.addDot(a, b), RuntimeError);
+	CHECK_THROWS_AS(batch.addTwoNorm(c), RuntimeError);
+	CHECK_THROWS_AS(batch.addInfNorm(nullptr), RuntimeError);
+}
+TEST_CASE("ReductionBatch<3> evaluateStart and evaluateFinish match evaluate", "[ReductionBatch]")
+{
+	auto a = make_shared<MockVector<3>>(MPI_COMM_WORLD, 2, 3, 1, array<int, 3>{3, 4, 2});
+	auto b = make_shared<MockVector<3>>(MPI_COMM_WORLD, 2, 3, 1, array<int, 3>{3, 4, 2});
+	for (size_t i = 0; i < a->data.size(); i++) {
+		double x   = (i + 0.5) / a->data.size();
+		a->data[i] = 10 - (x - 0.75) * (x - 0.75);
+		b->data[i] = (x - 0.5) * (x - 0.5) - 1;
+	}
+
+	double expected_a_dot_b = a->dot(b);
+	double expected_b_inf   = b->infNorm();
+	double expected_a_norm  = a->twoNorm();
+
+	ReductionBatch<3> batch;
+	int               a_dot_b_index = batch.addDot(a, b);
+	int               b_inf_index   = batch.addInfNorm(b);
+	int               a_norm_index  = batch.addTwoNorm(a);
+	batch.evaluateStart();
+	CHECK_THROWS_AS(batch.getResult(a_dot_b_index), RuntimeError);
+	// the local values have already been computed, so the vectors can be modified
+	a->set(0);
+	batch.evaluateFinish();
+
+	CHECK(batch.getResult(a_dot_b_index) == Approx(expected_a_dot_b));
+	CHECK(batch.getResult(b_inf_index) == Approx(expected_b_inf));
+	CHECK(batch.getResult(a_norm_index) == Approx(expected_a_norm));
+}
+TEST_CASE("ReductionBatch<3> evaluateFinish throws if not started", "[ReductionBatch]")
+{
+	ReductionBatch<3> batch;
+	CHECK_THROWS_AS(batch.evaluateFinish(), RuntimeError);
+	batch.evaluateStart();
+	CHECK_THROWS_AS(batch.evaluateStart(), RuntimeError);
+	batch.evaluateFinish();
+	CHECK_THROWS_AS(batch.evaluateFinish(), RuntimeError);
+}
+TEST_CASE("ReductionBatch<3> can not be modified while in progress", "[ReductionBatch]")
+{
+	auto a = make_shared<MockVector<3>>(MPI_COMM_WORLD, 1, 1, 1, array<int, 3>{2, 2, 2});
+
+	ReductionBatch<3> batch;
+	batch.addTwoNorm(a);
+	batch.evaluateStart();
+	CHECK_THROWS_AS(batch.addInfNorm(a), RuntimeError);
+	batch.evaluateFinish();
+	CHECK_NOTHROW(batch.addInfNorm(a));
+}
@@ -79,8 +79,8 @@ template <int D> class MockPatchSolver : public PatchSolver<D>
 		}
 	}
 	void solveSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                      const std::vector<LocalData<D>> &   fs,
-	                      std::vector<LocalData<D>> &         us) const override
+	                      const PatchView<D> &                fs,
+	                      PatchView<D> &                      us) const override
 	{
 		CHECK(patches_to_be_called.count(pinfo) == 1);
 		patches_to_be_called.erase(pinfo);
@@ -104,8 +104,8 @@ template <int D> class RHSGhostCheckingPatchSolver : public PatchSolver<D>
 	{
 	}
 	void solveSinglePatch(std::shared_ptr<const PatchInfo<D>> pinfo,
-	                      const std::vector<LocalData<D>> &   fs,
-	                      std::vector<LocalData<D>> &         us) const override
+	                      const PatchView<D> &                fs,
+	                      PatchView<D> &                      us) const override
 	{
 		was_called = true;
 		for (Side<D> s : Side<D>::getValues()) {
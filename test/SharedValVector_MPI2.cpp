@@ -0,0 +1,89 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "catch.hpp"
+#include <ThunderEgg/SharedValVector.h>
+using namespace std;
+using namespace ThunderEgg;
+TEST_CASE("SharedValVector getNodeLocalData reads the patches of the other rank MPI2",
+          "[SharedValVector]")
+{
+	auto num_components = GENERATE(1, 2);
+	auto num_patches    = GENERATE(1, 3);
+	auto nx             = GENERATE(1, 4);
+	auto ny             = GENERATE(1, 5);
+	int  num_ghost      = 1;
+	INFO("num_components: " << num_components);
+	INFO("num_patches: " << num_patches);
+	INFO("nx: " << nx);
+	INFO("ny: " << ny);
+
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	int other_rank = 1 - rank;
+
+	auto               shared_comm = make_shared<SharedMemoryComm>(MPI_COMM_WORLD);
+	std::array<int, 2> ns          = {nx, ny};
+	SharedValVector<2> vec(shared_comm, ns, num_ghost, num_components, num_patches);
+
+	CHECK(vec.getNumLocalCells() == nx * ny * num_patches);
+	CHECK(vec.isOnNode(rank));
+	REQUIRE(vec.isOnNode(other_rank));
+
+	for (int p = 0; p < num_patches; p++) {
+		for (int c = 0; c < num_components; c++) {
+			auto ld = vec.getLocalData(c, p);
+			nested_loop<2>(ld.getGhostStart(), ld.getGhostEnd(),
+			               [&](const array<int, 2> &coord) {
+				               ld[coord] = rank * 1000 + p * 100 + c * 10 + coord[0] + coord[1];
+			               });
+		}
+	}
+	vec.sync();
+	shared_comm->barrier();
+	vec.sync();
+
+	for (int p = 0; p < num_patches; p++) {
+		for (int c = 0; c < num_components; c++) {
+			const auto ld = vec.getNodeLocalData(other_rank, c, p);
+			nested_loop<2>(ld.getGhostStart(), ld.getGhostEnd(), [&](const array<int, 2> &coord) {
+				CHECK(ld[coord] == other_rank * 1000 + p * 100 + c * 10 + coord[0] + coord[1]);
+			});
+		}
+	}
+
+	// wait for the other rank before the values are changed
+	shared_comm->barrier();
+
+	vec.set(1);
+	CHECK(vec.twoNorm() == Approx(sqrt(2.0 * nx * ny * num_patches * num_components)));
+}
+TEST_CASE("SharedMemoryComm ranks MPI2", "[SharedValVector]")
+{
+	SharedMemoryComm shared_comm(MPI_COMM_WORLD);
+	CHECK(shared_comm.getSize() == 2);
+	CHECK(shared_comm.contains(0));
+	CHECK(shared_comm.contains(1));
+	CHECK_FALSE(shared_comm.contains(2));
+	CHECK(shared_comm.getNodeRank(0) == 0);
+	CHECK(shared_comm.getNodeRank(1) == 1);
+	CHECK(shared_comm.getNodeRank(-1) == MPI_UNDEFINED);
+}
@@ -0,0 +1,242 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "Vector_MOCKS.h"
+#include "catch.hpp"
+#include "utils/DomainReader.h"
+#include <ThunderEgg/BiLinearGhostFiller.h>
+#include <ThunderEgg/BiQuadraticGhostFiller.h>
+#include <ThunderEgg/DomainTools.h>
+#include <ThunderEgg/Threading.h>
+#include <ThunderEgg/ValVector.h>
+using namespace std;
+using namespace ThunderEgg;
+namespace
+{
+/**
+ * @brief Sets the number of threads, and restores the previous number when destroyed
+ */
+class NumThreadsGuard
+{
+	private:
+	int prev_num_threads;
+
+	public:
+	explicit NumThreadsGuard(int num_threads) : prev_num_threads(Threading::GetNumThreads())
+	{
+		Threading::SetNumThreads(num_threads);
+	}
+	~NumThreadsGuard()
+	{
+		Threading::SetNumThreads(prev_num_threads);
+	}
+};
+/**
+ * @brief Fill a vector with values that have rounding error when summed
+ */
+template <int D> void FillVector(shared_ptr<Vector<D>> vec, double shift)
+{
+	int index = 0;
+	for (int i = 0; i < vec->getNumLocalPatches(); i++) {
+		for (int c = 0; c < vec->getNumComponents(); c++) {
+			LocalData<D> ld = vec->getLocalData(c, i);
+			nested_loop<D>(ld.getStart(), ld.getEnd(), [&](const array<int, D> &coord) {
+				ld[coord] = shift + 1.0 / (index + 3) - sin(index);
+				index++;
+			});
+		}
+	}
+}
+} // namespace
+TEST_CASE("Threading SetNumThreads throws with less than 1 thread", "[Threading]")
+{
+	CHECK_THROWS_AS(Threading::SetNumThreads(0), RuntimeError);
+	CHECK_THROWS_AS(Threading::SetNumThreads(-1), RuntimeError);
+}
+TEST_CASE("Threading GetNumThreads", "[Threading]")
+{
+	int             num_threads = GENERATE(1, 2, 4);
+	NumThreadsGuard guard(num_threads);
+#ifdef _OPENMP
+	CHECK(Threading::GetNumThreads() == num_threads);
+#else
+	CHECK(Threading::GetNumThreads() == 1);
+#endif
+}
+TEST_CASE("Threading ParallelFor calls each index once", "[Threading]")
+{
+	int             num_threads = GENERATE(1, 2, 4);
+	int             n           = GENERATE(0, 1, 3, 17);
+	NumThreadsGuard guard(num_threads);
+
+	vector<int> counts(n, 0);
+	Threading::ParallelFor(n, [&](int i) { counts[i]++; });
+	for (int i = 0; i < n; i++) {
+		CHECK(counts[i] == 1);
+	}
+}
+TEST_CASE("Threading ParallelSum and ParallelMax", "[Threading]")
+{
+	int             num_threads = GENERATE(1, 2, 4);
+	int             n           = GENERATE(0, 1, 3, 17);
+	NumThreadsGuard guard(num_threads);
+
+	double expected_sum = 0;
+	double expected_max = 0;
+	for (int i = 0; i < n; i++) {
+		expected_sum += 1.0 / (i + 1);
+		expected_max = fmax(expected_max, 1.0 * i);
+	}
+	CHECK(Threading::ParallelSum(n, [](int i) { return 1.0 / (i + 1); }) == expected_sum);
+	CHECK(Threading::ParallelMax(n, [](int i) { return 1.0 * i; }) == expected_max);
+}
+TEST_CASE("Threading vector reductions do not depend on the number of threads", "[Threading]")
+{
+	int num_components    = GENERATE(1, 2);
+	int num_local_patches = GENERATE(1, 7);
+	INFO("num_components:    " << num_components);
+	INFO("num_local_patches: " << num_local_patches);
+
+	array<int, 3> ns = {5, 7, 2};
+
+	auto a = make_shared<ValVector<3>>(MPI_COMM_WORLD, ns, 1, num_components, num_local_patches);
+	auto b = make_shared<ValVector<3>>(MPI_COMM_WORLD, ns, 1, num_components, num_local_patches);
+	auto mock_a
+	= make_shared<MockVector<3>>(MPI_COMM_WORLD, num_components, num_local_patches, 1, ns);
+	auto mock_b
+	= make_shared<MockVector<3>>(MPI_COMM_WORLD, num_components, num_local_patches, 1, ns);
+	FillVector<3>(a, 0.1);
+	FillVector<3>(b, -0.3);
+	FillVector<3>(mock_a, 0.1);
+	FillVector<3>(mock_b, -0.3);
+
+	double dot, two_norm, inf_norm, mock_dot, mock_two_norm, mock_inf_norm;
+	{
+		NumThreadsGuard guard(1);
+		dot           = a->dot(b);
+		two_norm      = a->twoNorm();
+		inf_norm      = a->infNorm();
+		mock_dot      = mock_a->dot(mock_b);
+		mock_two_norm = mock_a->twoNorm();
+		mock_inf_norm = mock_a->infNorm();
+	}
+	int             num_threads = GENERATE(2, 3, 4);
+	NumThreadsGuard guard(num_threads);
+	CHECK(a->dot(b) == dot);
+	CHECK(a->twoNorm() == two_norm);
+	CHECK(a->infNorm() == inf_norm);
+	CHECK(mock_a->dot(mock_b) == mock_dot);
+	CHECK(mock_a->twoNorm() == mock_two_norm);
+	CHECK(mock_a->infNorm() == mock_inf_norm);
+}
+TEST_CASE("Threading vector operations match the serial versions", "[Threading]")
+{
+	int num_threads = GENERATE(2, 4);
+	INFO("num_threads: " << num_threads);
+
+	array<int, 3> ns       = {5, 7, 2};
+	auto          serial   = make_shared<MockVector<3>>(MPI_COMM_WORLD, 2, 7, 1, ns);
+	auto          threaded = make_shared<MockVector<3>>(MPI_COMM_WORLD, 2, 7, 1, ns);
+	auto          b        = make_shared<MockVector<3>>(MPI_COMM_WORLD, 2, 7, 1, ns);
+	FillVector<3>(serial, 1);
+	FillVector<3>(threaded, 1);
+	FillVector<3>(b, 2);
+	{
+		NumThreadsGuard guard(1);
+		serial->scaleThenAddScaled(0.5, -2, b);
+		serial->shift(3);
+	}
+	{
+		NumThreadsGuard guard(num_threads);
+		threaded->scaleThenAddScaled(0.5, -2, b);
+		threaded->shift(3);
+	}
+	for (int i = 0; i < 7; i++) {
+		for (int c = 0; c < 2; c++) {
+			LocalData<3> serial_ld   = serial->getLocalData(c, i);
+			LocalData<3> threaded_ld = threaded->getLocalData(c, i);
+			nested_loop<3>(serial_ld.getGhostStart(), serial_ld.getGhostEnd(),
+			               [&](const array<int, 3> &coord) {
+				               CHECK(threaded_ld[coord] == serial_ld[coord]);
+			               });
+		}
+	}
+}
+TEST_CASE("Threading Domain::integrate does not depend on the number of threads", "[Threading]")
+{
+	auto mesh_file
+	= GENERATE(as<std::string>{}, "mesh_inputs/2d_uniform_2x2_refined_nw_mpi1.json",
+	           "mesh_inputs/2d_uniform_8x8_refined_cross_mpi1.json");
+	INFO("MESH FILE " << mesh_file);
+	DomainReader<2>       domain_reader(mesh_file, {6, 5}, 1);
+	shared_ptr<Domain<2>> domain = domain_reader.getFinerDomain();
+
+	auto u = ValVector<2>::GetNewVector(domain, 2);
+	FillVector<2>(u, 0.7);
+
+	double integral;
+	{
+		NumThreadsGuard guard(1);
+		integral = domain->integrate(u);
+	}
+	int             num_threads = GENERATE(2, 3, 4);
+	NumThreadsGuard guard(num_threads);
+	CHECK(domain->integrate(u) == integral);
+}
+TEST_CASE("Threading ghost fillers do not depend on the number of threads", "[Threading]")
+{
+	auto mesh_file
+	= GENERATE(as<std::string>{}, "mesh_inputs/2d_uniform_2x2_refined_nw_mpi1.json",
+	           "mesh_inputs/2d_uniform_8x8_refined_cross_mpi1.json");
+	int num_threads = GENERATE(2, 3, 4);
+	INFO("MESH FILE " << mesh_file);
+	INFO("num_threads: " << num_threads);
+	DomainReader<2>       domain_reader(mesh_file, {6, 5}, 1);
+	shared_ptr<Domain<2>> domain = domain_reader.getFinerDomain();
+
+	BiLinearGhostFiller    bilinear(domain);
+	BiQuadraticGhostFiller biquadratic(domain);
+	for (const MPIGhostFiller<2> *ghost_filler :
+	     vector<const MPIGhostFiller<2> *>{&bilinear, &biquadratic}) {
+		auto serial   = ValVector<2>::GetNewVector(domain, 2);
+		auto threaded = ValVector<2>::GetNewVector(domain, 2);
+		FillVector<2>(serial, 0.7);
+		FillVector<2>(threaded, 0.7);
+		{
+			NumThreadsGuard guard(1);
+			ghost_filler->fillGhost(serial);
+		}
+		{
+			NumThreadsGuard guard(num_threads);
+			ghost_filler->fillGhost(threaded);
+		}
+		for (int i = 0; i < serial->getNumLocalPatches(); i++) {
+			for (int c = 0; c < 2; c++) {
+				LocalData<2> serial_ld   = serial->getLocalData(c, i);
+				LocalData<2> threaded_ld = threaded->getLocalData(c, i);
+				nested_loop<2>(serial_ld.getGhostStart(), serial_ld.getGhostEnd(),
+				               [&](const array<int, 2> &coord) {
+					               CHECK(threaded_ld[coord] == serial_ld[coord]);
+				               });
+			}
+		}
+	}
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "catch.hpp"
+#include <ThunderEgg/RuntimeError.h>
+#include <ThunderEgg/Tiling.h>
+using namespace std;
+using namespace ThunderEgg;
+namespace
+{
+/**
+ * @brief Sets the cache size, and restores the previous cache size when destroyed
+ */
+class CacheSizeGuard
+{
+	private:
+	long prev_cache_size;
+
+	public:
+	explicit CacheSizeGuard(long cache_size) : prev_cache_size(Tiling::GetCacheSize())
+	{
+		Tiling::SetCacheSize(cache_size);
+	}
+	~CacheSizeGuard()
+	{
+		Tiling::SetCacheSize(prev_cache_size);
+	}
+};
+} // namespace
+TEST_CASE("Tiling SetCacheSize throws with a cache size that is not positive", "[Tiling]")
+{
+	CHECK_THROWS_AS(Tiling::SetCacheSize(0), RuntimeError);
+	CHECK_THROWS_AS(Tiling::SetCacheSize(-1), RuntimeError);
+}
+TEST_CASE("Tiling GetCacheSize", "[Tiling]")
+{
+	CHECK(Tiling::GetCacheSize() > 0);
+	CacheSizeGuard guard(12345);
+	CHECK(Tiling::GetCacheSize() == 12345);
+}
+TEST_CASE("Tiling ChooseTileSizes does not tile 2d patches", "[Tiling]")
+{
+	CacheSizeGuard guard(1024);
+	CHECK(Tiling::ChooseTileSizes<2>({512, 512}, 1, 5) == array<int, 2>{0, 0});
+}
+TEST_CASE("Tiling ChooseTileSizes does not tile patches that fit", "[Tiling]")
+{
+	CacheSizeGuard guard(1 << 20);
+	// 5 planes of 18x18 doubles
+	CHECK(Tiling::ChooseTileSizes<3>({16, 16, 16}, 1, 5) == array<int, 3>{0, 0, 0});
+}
+TEST_CASE("Tiling ChooseTileSizes splits the second to last axis", "[Tiling]")
+{
+	long cache_size = GENERATE(1l << 18, 1l << 19, 1l << 20);
+	int  n          = GENERATE(128, 200, 256);
+	int  num_planes = GENERATE(4, 8);
+	INFO("cache size: " << cache_size);
+	INFO("n:          " << n);
+	INFO("num_planes: " << num_planes);
+	CacheSizeGuard guard(cache_size);
+
+	array<int, 3> tile_sizes = Tiling::ChooseTileSizes<3>({n, n, n}, 1, num_planes);
+	CHECK(tile_sizes[0] == 0);
+	CHECK(tile_sizes[2] == 0);
+	REQUIRE(tile_sizes[1] > 0);
+	CHECK(tile_sizes[1] < n);
+
+	auto tile_bytes = [&](int size) {
+		return (long) num_planes * (n + 2) * (size + 2) * (long) sizeof(double);
+	};
+	CHECK(tile_bytes(tile_sizes[1]) <= cache_size / 2);
+	// the tiles are about the same size
+	int num_tiles = (n + tile_sizes[1] - 1) / tile_sizes[1];
+	CHECK(n - (num_tiles - 1) * tile_sizes[1] > tile_sizes[1] - num_tiles);
+}
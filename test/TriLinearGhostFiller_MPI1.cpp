@@ -303,4 +303,109 @@ TEST_CASE("TriLinearGhostFiller constructor throws error with odd number of cell
 	shared_ptr<Domain<3>> d = domain_reader.getFinerDomain();
 
 	CHECK_THROWS_AS(TriLinearGhostFiller(d), RuntimeError);
-}
\ No newline at end of file
+}
+TEST_CASE("exchange various meshes 3D TriLinearGhostFiller two ghost layers",
+          "[TriLinearGhostFiller]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, single_mesh_file, refined_mesh_file);
+	INFO("MESH: " << mesh_file);
+	auto nx        = GENERATE(10, 2);
+	auto ny        = GENERATE(10, 2);
+	auto nz        = GENERATE(10, 2);
+	int  num_ghost = 2;
+
+	DomainReader<3>       domain_reader(mesh_file, {nx, ny, nz}, num_ghost);
+	shared_ptr<Domain<3>> d = domain_reader.getFinerDomain();
+
+	shared_ptr<ValVector<3>> vec      = ValVector<3>::GetNewVector(d, 1);
+	shared_ptr<ValVector<3>> expected = ValVector<3>::GetNewVector(d, 1);
+
+	auto f = [&](const std::array<double, 3> coord) -> double {
+		double x = coord[0];
+		double y = coord[1];
+		double z = coord[2];
+		return 1 + 0.5 * x + y + 7 * z;
+	};
+
+	// the ghost cells of normal neighbors are overwritten, not added to
+	vec->setWithGhost(100);
+	DomainTools::SetValues<3>(d, vec, f);
+	DomainTools::SetValuesWithGhost<3>(d, expected, f);
+
+	TriLinearGhostFiller tlgf(d);
+	tlgf.fillGhost(vec);
+
+	for (auto pinfo : d->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<3> vec_ld      = vec->getLocalData(0, pinfo->local_index);
+		LocalData<3> expected_ld = expected->getLocalData(0, pinfo->local_index);
+		for (Side<3> s : Side<3>::getValues()) {
+			if (pinfo->hasNbr(s)) {
+				INFO("side:      " << s);
+				INFO("nbr-type:  " << pinfo->getNbrType(s));
+				// every layer is copied from normal neighbors
+				int num_layers = pinfo->getNbrType(s) == NbrType::Normal ? num_ghost : 1;
+				for (int layer = 1; layer <= num_layers; layer++) {
+					INFO("layer:  " << layer);
+					LocalData<2> vec_ghost      = vec_ld.getGhostSliceOnSide(s, layer);
+					LocalData<2> expected_ghost = expected_ld.getGhostSliceOnSide(s, layer);
+					nested_loop<2>(vec_ghost.getStart(), vec_ghost.getEnd(),
+					               [&](const array<int, 2> &coord) {
+						               INFO("coord:  " << coord[0] << ", " << coord[1]);
+						               CHECK(vec_ghost[coord] == Approx(expected_ghost[coord]));
+					               });
+				}
+			}
+		}
+	}
+}
+TEST_CASE("exchange uniform 3D TriLinearGhostFiller fill corners", "[TriLinearGhostFiller]")
+{
+	auto nx        = GENERATE(2, 6);
+	auto ny        = GENERATE(2, 6);
+	auto nz        = GENERATE(2, 6);
+	auto num_ghost = GENERATE(1, 2);
+
+	DomainReader<3>       domain_reader(single_mesh_file, {nx, ny, nz}, num_ghost);
+	shared_ptr<Domain<3>> d = domain_reader.getFinerDomain();
+
+	shared_ptr<ValVector<3>> vec      = ValVector<3>::GetNewVector(d, 1);
+	shared_ptr<ValVector<3>> expected = ValVector<3>::GetNewVector(d, 1);
+
+	auto f = [&](const std::array<double, 3> coord) -> double {
+		double x = coord[0];
+		double y = coord[1];
+		double z = coord[2];
+		return 1 + ((x * 0.3) + y - 2 * z);
+	};
+
+	vec->setWithGhost(100);
+	DomainTools::SetValues<3>(d, vec, f);
+	DomainTools::SetValuesWithGhost<3>(d, expected, f);
+
+	TriLinearGhostFiller tlgf(d);
+	tlgf.setFillCorners(true);
+	tlgf.fillGhost(vec);
+
+	for (auto pinfo : d->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<3> vec_ld      = vec->getLocalData(0, pinfo->local_index);
+		LocalData<3> expected_ld = expected->getLocalData(0, pinfo->local_index);
+		nested_loop<3>(vec_ld.getGhostStart(), vec_ld.getGhostEnd(),
+		               [&](const array<int, 3> &coord) {
+			               // only check the cells that are inside of the domain
+			               for (int axis = 0; axis < 3; axis++) {
+				               if ((coord[axis] < 0
+				                    && !pinfo->hasNbr(Side<3>::LowerSideOnAxis(axis)))
+				                   || (coord[axis] >= pinfo->ns[axis]
+				                       && !pinfo->hasNbr(Side<3>::HigherSideOnAxis(axis)))) {
+					               return;
+				               }
+			               }
+			               INFO("xi:    " << coord[0]);
+			               INFO("yi:    " << coord[1]);
+			               INFO("zi:    " << coord[2]);
+			               CHECK(vec_ld[coord] == Approx(expected_ld[coord]));
+		               });
+	}
+}
@@ -48,4 +48,28 @@ TEST_CASE("ValVectorGenerator getNewVector", "[ValVectorGenerator]")
 	CHECK(val_vector->getMPIComm() == MPI_COMM_WORLD);
 	CHECK(val_vector->getLocalData(0, 0).getLengths()[0] == nx);
 	CHECK(val_vector->getLocalData(0, 0).getLengths()[1] == ny);
-}
\ No newline at end of file
+}
+TEST_CASE("ValVectorGenerator getNewVector with layout", "[ValVectorGenerator]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH FILE " << mesh_file);
+	int                   n         = GENERATE(4, 5);
+	int                   num_ghost = GENERATE(0, 1);
+	DomainReader<2>       domain_reader(mesh_file, {n, n}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	ValVectorLayout layout;
+	layout.aligned = true;
+	ValVectorGenerator<2> vg(d_fine, 1, layout);
+	CHECK(vg.getLayout().aligned);
+
+	auto val_vector = dynamic_pointer_cast<ValVector<2>>(vg.getNewVector());
+	REQUIRE(val_vector != nullptr);
+	CHECK(val_vector->getLayout().aligned);
+	CHECK(val_vector->getNumLocalCells() == d_fine->getNumLocalCells());
+	for (int i = 0; i < val_vector->getNumLocalPatches(); i++) {
+		LocalData<2> ld = val_vector->getLocalData(0, i);
+		CHECK(reinterpret_cast<uintptr_t>(ld.getPtr()) % ValVectorLayout::Alignment == 0);
+		CHECK(ld.getStrides()[1] % (ValVectorLayout::Alignment / sizeof(double)) == 0);
+	}
+}
@@ -19,6 +19,7 @@
  *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
  ***************************************************************************/
 
+#include "Vector_MOCKS.h"
 #include "catch.hpp"
 #include "utils/DomainReader.h"
 #include <ThunderEgg/ValVector.h>
@@ -586,4 +587,309 @@ TEST_CASE("ValVector getNewVector works", "[ValVector]")
 	CHECK(val_vector->getMPIComm() == MPI_COMM_WORLD);
 	CHECK(val_vector->getLocalData(0, 0).getLengths()[0] == nx);
 	CHECK(val_vector->getLocalData(0, 0).getLengths()[1] == ny);
-}
\ No newline at end of file
+}
+namespace
+{
+/**
+ * @brief Fill the ValVector and the MockVector with the same values, including ghost cells
+ */
+void FillVectors(shared_ptr<ValVector<3>> vec, shared_ptr<MockVector<3>> mock, double shift)
+{
+	int index = 0;
+	for (int i = 0; i < vec->getNumLocalPatches(); i++) {
+		for (int c = 0; c < vec->getNumComponents(); c++) {
+			LocalData<3> ld      = vec->getLocalData(c, i);
+			LocalData<3> mock_ld = mock->getLocalData(c, i);
+			nested_loop<3>(ld.getGhostStart(), ld.getGhostEnd(), [&](const array<int, 3> &coord) {
+				double x       = (index + 0.5) / 100;
+				ld[coord]      = shift + x - x * x;
+				mock_ld[coord] = ld[coord];
+				index++;
+			});
+		}
+	}
+}
+/**
+ * @brief Check that the values in the ValVector and MockVector are equal, including ghost cells
+ */
+void CheckVectors(shared_ptr<const ValVector<3>> vec, shared_ptr<const MockVector<3>> mock)
+{
+	for (int i = 0; i < vec->getNumLocalPatches(); i++) {
+		for (int c = 0; c < vec->getNumComponents(); c++) {
+			const LocalData<3> ld      = vec->getLocalData(c, i);
+			const LocalData<3> mock_ld = mock->getLocalData(c, i);
+			nested_loop<3>(ld.getGhostStart(), ld.getGhostEnd(), [&](const array<int, 3> &coord) {
+				CHECK(ld[coord] == Approx(mock_ld[coord]));
+			});
+		}
+	}
+}
+/**
+ * @brief The ValVectors and the MockVectors that they are compared against
+ *
+ * The MockVectors use the generic Vector implementations of the operations
+ */
+struct VectorSet {
+	shared_ptr<ValVector<3>>  a;
+	shared_ptr<ValVector<3>>  b;
+	shared_ptr<ValVector<3>>  c;
+	shared_ptr<MockVector<3>> mock_a;
+	shared_ptr<MockVector<3>> mock_b;
+	shared_ptr<MockVector<3>> mock_c;
+	VectorSet(const array<int, 3> &ns, int num_ghost_cells, int num_components,
+	          int num_local_patches, bool aligned)
+	{
+		ValVectorLayout layout;
+		layout.aligned = aligned;
+		a = make_shared<ValVector<3>>(MPI_COMM_WORLD, ns, num_ghost_cells, num_components,
+		                              num_local_patches, layout);
+		b = make_shared<ValVector<3>>(MPI_COMM_WORLD, ns, num_ghost_cells, num_components,
+		                              num_local_patches, layout);
+		c = make_shared<ValVector<3>>(MPI_COMM_WORLD, ns, num_ghost_cells, num_components,
+		                              num_local_patches, layout);
+		mock_a = make_shared<MockVector<3>>(MPI_COMM_WORLD, num_components, num_local_patches,
+		                                    num_ghost_cells, ns);
+		mock_b = make_shared<MockVector<3>>(MPI_COMM_WORLD, num_components, num_local_patches,
+		                                    num_ghost_cells, ns);
+		mock_c = make_shared<MockVector<3>>(MPI_COMM_WORLD, num_components, num_local_patches,
+		                                    num_ghost_cells, ns);
+		FillVectors(a, mock_a, 1);
+		FillVectors(b, mock_b, -2);
+		FillVectors(c, mock_c, 3);
+	}
+};
+} // namespace
+#define VECTOR_SET_GENERATORS                                                                      \
+	int           num_components    = GENERATE(1, 2);                                             \
+	auto          num_ghost_cells   = GENERATE(0, 1, 2);                                          \
+	int           nx                = GENERATE(1, 5);                                             \
+	int           ny                = GENERATE(1, 4);                                             \
+	int           nz                = GENERATE(1, 3);                                             \
+	array<int, 3> ns                = {nx, ny, nz};                                               \
+	int           num_local_patches = GENERATE(1, 3);                                             \
+	bool          aligned           = GENERATE(false, true);                                      \
+	INFO("aligned:           " << aligned);                                                       \
+	INFO("num_ghost_cells:   " << num_ghost_cells);                                               \
+	INFO("nx:                " << nx);                                                            \
+	INFO("ny:                " << ny);                                                            \
+	INFO("nz:                " << nz);                                                            \
+	INFO("num_local_patches: " << num_local_patches);                                             \
+	INFO("num_components:    " << num_components);                                                \
+	VectorSet v(ns, num_ghost_cells, num_components, num_local_patches, aligned);
+TEST_CASE("ValVector<3> set matches Vector<3> set", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->set(7);
+	v.mock_a->set(7);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> setWithGhost matches Vector<3> setWithGhost", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->setWithGhost(7);
+	v.mock_a->setWithGhost(7);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> scale matches Vector<3> scale", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->scale(-3);
+	v.mock_a->scale(-3);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> shift matches Vector<3> shift", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->shift(-3);
+	v.mock_a->shift(-3);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> copy matches Vector<3> copy", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->copy(v.b);
+	v.mock_a->copy(v.mock_b);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> copy from a vector with a different layout", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->copy(v.mock_b);
+	v.mock_a->copy(v.mock_b);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> add matches Vector<3> add", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->add(v.b);
+	v.mock_a->add(v.mock_b);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> addScaled matches Vector<3> addScaled", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->addScaled(-0.5, v.b);
+	v.mock_a->addScaled(-0.5, v.mock_b);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> addScaled two vectors matches Vector<3> addScaled two vectors",
+          "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->addScaled(-0.5, v.b, 2, v.c);
+	v.mock_a->addScaled(-0.5, v.mock_b, 2, v.mock_c);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> addScaled two vectors with a different layout", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->addScaled(-0.5, v.b, 2, v.mock_c);
+	v.mock_a->addScaled(-0.5, v.mock_b, 2, v.mock_c);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> scaleThenAdd matches Vector<3> scaleThenAdd", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->scaleThenAdd(-0.5, v.b);
+	v.mock_a->scaleThenAdd(-0.5, v.mock_b);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> scaleThenAddScaled matches Vector<3> scaleThenAddScaled", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->scaleThenAddScaled(-0.5, 3, v.b);
+	v.mock_a->scaleThenAddScaled(-0.5, 3, v.mock_b);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> scaleThenAddScaled two vectors matches Vector<3> scaleThenAddScaled two "
+          "vectors",
+          "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->scaleThenAddScaled(-0.5, 3, v.b, 2, v.c);
+	v.mock_a->scaleThenAddScaled(-0.5, 3, v.mock_b, 2, v.mock_c);
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> twoNorm matches Vector<3> twoNorm", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	CHECK(v.a->twoNorm() == Approx(v.mock_a->twoNorm()));
+}
+TEST_CASE("ValVector<3> dot matches Vector<3> dot", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	CHECK(v.a->dot(v.b) == Approx(v.mock_a->dot(v.mock_b)));
+	CHECK(v.a->dot(v.mock_b) == Approx(v.mock_a->dot(v.mock_b)));
+}
+TEST_CASE("ValVector<3> copyWithGhost", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->copyWithGhost(v.b);
+	CheckVectors(v.a, v.mock_b);
+}
+TEST_CASE("ValVector<3> scaleWithGhost", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->scaleWithGhost(-3);
+	for (int i = 0; i < num_local_patches; i++) {
+		for (int c = 0; c < num_components; c++) {
+			LocalData<3> mock_ld = v.mock_a->getLocalData(c, i);
+			nested_loop<3>(mock_ld.getGhostStart(), mock_ld.getGhostEnd(),
+			               [&](const array<int, 3> &coord) { mock_ld[coord] *= -3; });
+		}
+	}
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> addScaledWithGhost", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	v.a->addScaledWithGhost(-0.5, v.b);
+	for (int i = 0; i < num_local_patches; i++) {
+		for (int c = 0; c < num_components; c++) {
+			LocalData<3> mock_a_ld = v.mock_a->getLocalData(c, i);
+			LocalData<3> mock_b_ld = v.mock_b->getLocalData(c, i);
+			nested_loop<3>(mock_a_ld.getGhostStart(), mock_a_ld.getGhostEnd(),
+			               [&](const array<int, 3> &coord) {
+				               mock_a_ld[coord] += -0.5 * mock_b_ld[coord];
+			               });
+		}
+	}
+	CheckVectors(v.a, v.mock_a);
+}
+TEST_CASE("ValVector<3> aligned layout aligns the first cell of each row", "[ValVector]")
+{
+	int           num_components    = GENERATE(1, 2);
+	auto          num_ghost_cells   = GENERATE(0, 1, 2);
+	int           nx                = GENERATE(1, 5, 8, 10);
+	int           ny                = GENERATE(1, 4);
+	int           nz                = GENERATE(1, 3);
+	array<int, 3> ns                = {nx, ny, nz};
+	int           num_local_patches = GENERATE(1, 3);
+	INFO("num_ghost_cells:   " << num_ghost_cells);
+	INFO("nx:                " << nx);
+	INFO("ny:                " << ny);
+	INFO("nz:                " << nz);
+	INFO("num_local_patches: " << num_local_patches);
+	INFO("num_components:    " << num_components);
+
+	ValVectorLayout layout;
+	layout.aligned = true;
+	ValVector<3> vec(MPI_COMM_WORLD, ns, num_ghost_cells, num_components, num_local_patches,
+	                 layout);
+	CHECK(vec.getLayout().aligned);
+	for (int i = 0; i < num_local_patches; i++) {
+		for (int c = 0; c < num_components; c++) {
+			LocalData<3>  ld    = vec.getLocalData(c, i);
+			array<int, 3> start = ld.getGhostStart();
+			array<int, 3> end   = ld.getGhostEnd();
+			start[0]            = 0;
+			end[0]              = 0;
+			nested_loop<3>(start, end, [&](const array<int, 3> &coord) {
+				uintptr_t addr = reinterpret_cast<uintptr_t>(ld.getPtr(coord));
+				CHECK(addr % ValVectorLayout::Alignment == 0);
+			});
+		}
+	}
+}
+TEST_CASE("ValVector<3> getNumLocalBytes", "[ValVector]")
+{
+	ValVectorLayout layout;
+	ValVector<3>    packed(MPI_COMM_WORLD, {5, 4, 3}, 1, 2, 3, layout);
+	CHECK(packed.getNumLocalBytes() == 7 * 6 * 5 * 2 * 3 * sizeof(double));
+
+	// the rows are padded to 8 values, and the data can be shifted by up to 7 values
+	layout.aligned = true;
+	ValVector<3> aligned(MPI_COMM_WORLD, {5, 4, 3}, 1, 2, 3, layout);
+	CHECK(aligned.getNumLocalBytes() == (8 * 6 * 5 * 2 * 3 + 7) * sizeof(double));
+}
+TEST_CASE("ValVector<3> copy between aligned and packed layouts", "[ValVector]")
+{
+	VECTOR_SET_GENERATORS
+	ValVectorLayout other_layout;
+	other_layout.aligned = !aligned;
+	auto other = make_shared<ValVector<3>>(MPI_COMM_WORLD, ns, num_ghost_cells, num_components,
+	                                       num_local_patches, other_layout);
+	other->copy(v.a);
+	CHECK(other->dot(v.b) == Approx(v.mock_a->dot(v.mock_b)));
+	for (int i = 0; i < num_local_patches; i++) {
+		for (int c = 0; c < num_components; c++) {
+			const LocalData<3> ld      = other->getLocalData(c, i);
+			const LocalData<3> mock_ld = v.mock_a->getLocalData(c, i);
+			nested_loop<3>(ld.getStart(), ld.getEnd(), [&](const array<int, 3> &coord) {
+				CHECK(ld[coord] == Approx(mock_ld[coord]));
+			});
+		}
+	}
+}
+TEST_CASE("ValVector<3> huge pages layout", "[ValVector]")
+{
+	ValVectorLayout layout;
+	layout.aligned    = GENERATE(false, true);
+	layout.huge_pages = true;
+	// large enough to span several huge pages
+	ValVector<3> vec(MPI_COMM_WORLD, {32, 32, 32}, 1, 1, 32, layout);
+	CHECK(vec.getLayout().huge_pages);
+	CHECK(vec.twoNorm() == 0);
+	vec.set(2);
+	CHECK(vec.twoNorm() == Approx(2 * sqrt(32.0 * 32 * 32 * 32)));
+}
@@ -270,4 +270,238 @@ TEST_CASE("Test VarPoisson::StarPatchOperator constructor throws exception with
 	auto gf = make_shared<BiLinearGhostFiller>(d_fine);
 	CHECK_THROWS_AS(make_shared<VarPoisson::StarPatchOperator<2>>(h_vec, d_fine, gf),
 	                ThunderEgg::RuntimeError);
-}
\ No newline at end of file
+}
+TEST_CASE("Test StarPatchOperator residual matches apply then subtract",
+          "[VarPoisson::StarPatchOperator]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH FILE " << mesh_file);
+	auto                  nx        = GENERATE(2, 10);
+	auto                  ny        = GENERATE(2, 10);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto gfun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return sinl(M_PI * y) * cosl(2 * M_PI * x);
+	};
+	auto ffun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return x * x + y;
+	};
+	auto hfun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return 1 + x * y;
+	};
+
+	auto u = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<2>(d_fine, u, gfun);
+	auto f = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<2>(d_fine, f, ffun);
+	auto h_vec = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValuesWithGhost<2>(d_fine, h_vec, hfun);
+	auto r          = ValVector<2>::GetNewVector(d_fine, 1);
+	auto r_expected = ValVector<2>::GetNewVector(d_fine, 1);
+
+	auto                             gf = make_shared<BiLinearGhostFiller>(d_fine);
+	VarPoisson::StarPatchOperator<2> p_operator(h_vec, d_fine, gf);
+	p_operator.apply(u, r_expected);
+	r_expected->scaleThenAdd(-1, f);
+
+	double norm = p_operator.residual(f, u, r, true);
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<2> r_ld          = r->getLocalData(0, pinfo->local_index);
+		LocalData<2> r_expected_ld = r_expected->getLocalData(0, pinfo->local_index);
+		nested_loop<2>(r_ld.getStart(), r_ld.getEnd(), [&](const array<int, 2> &coord) {
+			INFO("xi:    " << coord[0]);
+			INFO("yi:    " << coord[1]);
+			CHECK(r_ld[coord] == Approx(r_expected_ld[coord]));
+		});
+	}
+	CHECK(norm == Approx(r->twoNorm()));
+	CHECK(norm == Approx(r_expected->twoNorm()));
+}
+TEST_CASE("Test StarPatchOperator cached coefficients match uncached",
+          "[VarPoisson::StarPatchOperator]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH FILE " << mesh_file);
+	auto                  nx        = GENERATE(2, 5, 10);
+	auto                  ny        = GENERATE(2, 10);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto gfun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return sinl(M_PI * y) * cosl(2 * M_PI * x);
+	};
+	auto ffun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return x * x + y;
+	};
+	auto hfun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return 1 + x * y * y;
+	};
+
+	auto u = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<2>(d_fine, u, gfun);
+	auto f = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<2>(d_fine, f, ffun);
+	auto h_vec = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValuesWithGhost<2>(d_fine, h_vec, hfun);
+
+	auto                             gf = make_shared<BiLinearGhostFiller>(d_fine);
+	VarPoisson::StarPatchOperator<2> p_operator(h_vec, d_fine, gf);
+	CHECK_FALSE(p_operator.getCachedCoefficients());
+
+	auto g_expected = ValVector<2>::GetNewVector(d_fine, 1);
+	auto r_expected = ValVector<2>::GetNewVector(d_fine, 1);
+	p_operator.apply(u, g_expected);
+	p_operator.residual(f, u, r_expected);
+
+	p_operator.setCachedCoefficients(true);
+	CHECK(p_operator.getCachedCoefficients());
+
+	auto g = ValVector<2>::GetNewVector(d_fine, 1);
+	auto r = ValVector<2>::GetNewVector(d_fine, 1);
+	p_operator.apply(u, g);
+	p_operator.residual(f, u, r);
+
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<2> g_ld          = g->getLocalData(0, pinfo->local_index);
+		LocalData<2> g_expected_ld = g_expected->getLocalData(0, pinfo->local_index);
+		LocalData<2> r_ld          = r->getLocalData(0, pinfo->local_index);
+		LocalData<2> r_expected_ld = r_expected->getLocalData(0, pinfo->local_index);
+		nested_loop<2>(g_ld.getStart(), g_ld.getEnd(), [&](const array<int, 2> &coord) {
+			INFO("xi:    " << coord[0]);
+			INFO("yi:    " << coord[1]);
+			CHECK(g_ld[coord] == Approx(g_expected_ld[coord]).margin(1e-8));
+			CHECK(r_ld[coord] == Approx(r_expected_ld[coord]).margin(1e-8));
+		});
+	}
+
+	p_operator.setCachedCoefficients(false);
+	CHECK_FALSE(p_operator.getCachedCoefficients());
+}
+TEST_CASE("Test StarPatchOperator tiled stencil matches untiled stencil",
+          "[VarPoisson::StarPatchOperator]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH FILE " << mesh_file);
+	auto          nx         = GENERATE(5, 10);
+	auto          ny         = GENERATE(2, 10);
+	auto          cached     = GENERATE(false, true);
+	array<int, 2> tile_sizes = GENERATE(array<int, 2>{0, 3}, array<int, 2>{4, 3});
+	INFO("cached:     " << cached);
+	INFO("tile sizes: " << tile_sizes[0] << " " << tile_sizes[1]);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto gfun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return sinl(M_PI * y) * cosl(2 * M_PI * x);
+	};
+	auto ffun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return x * x + y;
+	};
+	auto hfun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return 1 + x * y * y;
+	};
+
+	auto u = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<2>(d_fine, u, gfun);
+	auto f = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValues<2>(d_fine, f, ffun);
+	auto h_vec = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValuesWithGhost<2>(d_fine, h_vec, hfun);
+	auto g       = ValVector<2>::GetNewVector(d_fine, 1);
+	auto g_tiled = ValVector<2>::GetNewVector(d_fine, 1);
+	auto r       = ValVector<2>::GetNewVector(d_fine, 1);
+	auto r_tiled = ValVector<2>::GetNewVector(d_fine, 1);
+
+	auto                             gf = make_shared<BiLinearGhostFiller>(d_fine);
+	VarPoisson::StarPatchOperator<2> p_operator(h_vec, d_fine, gf);
+	CHECK(p_operator.getTileSizes() == array<int, 2>{0, 0});
+	p_operator.setCachedCoefficients(cached);
+	p_operator.apply(u, g);
+	p_operator.residual(f, u, r);
+	p_operator.setTileSizes(tile_sizes);
+	CHECK(p_operator.getTileSizes() == tile_sizes);
+	p_operator.apply(u, g_tiled);
+	p_operator.residual(f, u, r_tiled);
+
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		LocalData<2> g_ld       = g->getLocalData(0, pinfo->local_index);
+		LocalData<2> g_tiled_ld = g_tiled->getLocalData(0, pinfo->local_index);
+		LocalData<2> r_ld       = r->getLocalData(0, pinfo->local_index);
+		LocalData<2> r_tiled_ld = r_tiled->getLocalData(0, pinfo->local_index);
+		nested_loop<2>(g_ld.getStart(), g_ld.getEnd(), [&](const array<int, 2> &coord) {
+			INFO("xi:    " << coord[0]);
+			INFO("yi:    " << coord[1]);
+			CHECK(g_tiled_ld[coord] == Approx(g_ld[coord]).margin(1e-8));
+			CHECK(r_tiled_ld[coord] == r_ld[coord]);
+		});
+	}
+}
+TEST_CASE("Test StarPatchOperator getInverseDiagonal matches the stencil",
+          "[VarPoisson::StarPatchOperator]")
+{
+	auto mesh_file = GENERATE(as<std::string>{}, MESHES);
+	INFO("MESH FILE " << mesh_file);
+	auto                  nx        = GENERATE(1, 4);
+	auto                  ny        = GENERATE(3, 4);
+	int                   num_ghost = 1;
+	DomainReader<2>       domain_reader(mesh_file, {nx, ny}, num_ghost);
+	shared_ptr<Domain<2>> d_fine = domain_reader.getFinerDomain();
+
+	auto hfun = [](const std::array<double, 2> &coord) {
+		double x = coord[0];
+		double y = coord[1];
+		return 1 + x * y * y;
+	};
+	auto h_vec = ValVector<2>::GetNewVector(d_fine, 1);
+	DomainTools::SetValuesWithGhost<2>(d_fine, h_vec, hfun);
+
+	auto inv_diag = ValVector<2>::GetNewVector(d_fine, 1);
+	auto u        = ValVector<2>::GetNewVector(d_fine, 1);
+	auto f        = ValVector<2>::GetNewVector(d_fine, 1);
+
+	auto                             gf = make_shared<BiLinearGhostFiller>(d_fine);
+	VarPoisson::StarPatchOperator<2> p_operator(h_vec, d_fine, gf);
+	p_operator.getInverseDiagonal(inv_diag);
+
+	// apply the stencil to each unit vector of a patch, with the interior ghost cells set to 0
+	for (auto pinfo : d_fine->getPatchInfoVector()) {
+		INFO("Patch: " << pinfo->id);
+		PatchView<2> us          = u->getLocalDatas(pinfo->local_index);
+		PatchView<2> fs          = f->getLocalDatas(pinfo->local_index);
+		LocalData<2> inv_diag_ld = inv_diag->getLocalData(0, pinfo->local_index);
+		nested_loop<2>(us[0].getStart(), us[0].getEnd(), [&](const array<int, 2> &coord) {
+			INFO("xi:    " << coord[0]);
+			INFO("yi:    " << coord[1]);
+			nested_loop<2>(us[0].getGhostStart(), us[0].getGhostEnd(),
+			               [&](const array<int, 2> &coord) { us[0][coord] = 0; });
+			us[0][coord] = 1;
+			p_operator.applySinglePatch(pinfo, us, fs, false);
+			CHECK(inv_diag_ld[coord] == Approx(1 / fs[0][coord]));
+		});
+	}
+}
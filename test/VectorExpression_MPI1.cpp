@@ -0,0 +1,193 @@
+/***************************************************************************
+ *  ThunderEgg, a library for solving Poisson's equation on adaptively
+ *  refined block-structured Cartesian grids
+ *
+ *  Copyright (C) 2019  ThunderEgg Developers. See AUTHORS.md file at the
+ *  top-level directory.
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ***************************************************************************/
+
+#include "Vector_MOCKS.h"
+#include "catch.hpp"
+#include <ThunderEgg/ValVector.h>
+#include <ThunderEgg/VectorExpression.h>
+using namespace std;
+using namespace ThunderEgg;
+namespace
+{
+/**
+ * @brief Fill the vector, including ghost cells, with values that depend on the shift
+ */
+void Fill(shared_ptr<Vector<3>> vec, double shift)
+{
+	for (int i = 0; i < vec->getNumLocalPatches(); i++) {
+		for (int c = 0; c < vec->getNumComponents(); c++) {
+			LocalData<3> ld = vec->getLocalData(c, i);
+			nested_loop<3>(ld.getGhostStart(), ld.getGhostEnd(), [&](const array<int, 3> &coord) {
+				ld[coord] = shift + i + 0.5 * c + 0.25 * coord[0] - coord[1] + 2.0 * coord[2];
+			});
+		}
+	}
+}
+/**
+ * @brief Check that the non-ghost values of a vector are equal to the values of the function
+ */
+template <typename T> void CheckValues(shared_ptr<const Vector<3>> vec, T f)
+{
+	for (int i = 0; i < vec->getNumLocalPatches(); i++) {
+		for (int c = 0; c < vec->getNumComponents(); c++) {
+			const LocalData<3> ld = vec->getLocalData(c, i);
+			nested_loop<3>(ld.getStart(), ld.getEnd(), [&](const array<int, 3> &coord) {
+				CHECK(ld[coord] == Approx(f(c, i, coord)));
+			});
+		}
+	}
+}
+/**
+ * @brief Get a new vector, either a MockVector or a ValVector
+ */
+shared_ptr<Vector<3>> GetNewVector(bool mock, int num_components, int num_local_patches)
+{
+	array<int, 3> ns = {4, 3, 2};
+	if (mock) {
+		return make_shared<MockVector<3>>(MPI_COMM_WORLD, num_components, num_local_patches, 1,
+		                                  ns);
+	} else {
+		return make_shared<ValVector<3>>(MPI_COMM_WORLD, ns, 1, num_components, num_local_patches);
+	}
+}
+} // namespace
+TEST_CASE("assign linear combination", "[VectorExpression]")
+{
+	// the MockVector with more than one component has a non unit stride
+	bool mock           = GENERATE(false, true);
+	int  num_components = GENERATE(1, 2);
+	INFO("mock:           " << mock);
+	INFO("num_components: " << num_components);
+	auto a = GetNewVector(mock, num_components, 3);
+	auto b = GetNewVector(mock, num_components, 3);
+	auto c = GetNewVector(mock, num_components, 3);
+	auto x = GetNewVector(mock, num_components, 3);
+	Fill(a, 1);
+	Fill(b, -2);
+	Fill(c, 7);
+	x->setWithGhost(-99);
+
+	shared_ptr<const Vector<3>> const_c = c;
+	assign(x, 2 * (a - 0.5 * b) + const_c * 3 - b);
+
+	CheckValues(x, [&](int comp, int i, const array<int, 3> &coord) {
+		double base = i + 0.5 * comp + 0.25 * coord[0] - coord[1] + 2.0 * coord[2];
+		return 2 * ((1 + base) - 0.5 * (-2 + base)) + 3 * (7 + base) - (-2 + base);
+	});
+	// ghost values are not changed
+	LocalData<3> ld = x->getLocalData(0, 0);
+	CHECK(ld[{-1, 0, 0}] == -99);
+}
+TEST_CASE("assign with target in expression", "[VectorExpression]")
+{
+	bool mock           = GENERATE(false, true);
+	int  num_components = GENERATE(1, 2);
+	INFO("mock:           " << mock);
+	INFO("num_components: " << num_components);
+	auto p  = GetNewVector(mock, num_components, 2);
+	auto ap = GetNewVector(mock, num_components, 2);
+	auto r  = GetNewVector(mock, num_components, 2);
+	Fill(p, 1);
+	Fill(ap, 3);
+	Fill(r, -1);
+
+	double beta  = 0.5;
+	double omega = 2;
+	assign(p, r + beta * (p - omega * ap));
+
+	CheckValues(p, [&](int comp, int i, const array<int, 3> &coord) {
+		double base = i + 0.5 * comp + 0.25 * coord[0] - coord[1] + 2.0 * coord[2];
+		return (-1 + base) + beta * ((1 + base) - omega * (3 + base));
+	});
+}
+TEST_CASE("assign a vector and a negated vector", "[VectorExpression]")
+{
+	auto a = GetNewVector(false, 1, 2);
+	auto x = GetNewVector(false, 1, 2);
+	Fill(a, 1);
+
+	assign(x, a);
+	CheckValues(x, [&](int comp, int i, const array<int, 3> &coord) {
+		return 1 + i + 0.25 * coord[0] - coord[1] + 2.0 * coord[2];
+	});
+	assign(x, -a);
+	CheckValues(x, [&](int comp, int i, const array<int, 3> &coord) {
+		return -(1 + i + 0.25 * coord[0] - coord[1] + 2.0 * coord[2]);
+	});
+}
+TEST_CASE("assign with ReductionBatch", "[VectorExpression]")
+{
+	bool mock           = GENERATE(false, true);
+	int  num_components = GENERATE(1, 2);
+	INFO("mock:           " << mock);
+	INFO("num_components: " << num_components);
+	auto r    = GetNewVector(mock, num_components, 3);
+	auto ap   = GetNewVector(mock, num_components, 3);
+	auto rhat = GetNewVector(mock, num_components, 3);
+	Fill(r, 1);
+	Fill(ap, -1);
+	Fill(rhat, 4);
+
+	ReductionBatch<3> batch;
+	int               dot_index  = batch.addDot(r, rhat);
+	int               norm_index = batch.addTwoNorm(r);
+	int               inf_index  = batch.addInfNorm(ap);
+	assign(r, r - 0.25 * ap, batch);
+
+	CHECK(batch.getResult(dot_index) == Approx(r->dot(rhat)));
+	CHECK(batch.getResult(norm_index) == Approx(r->twoNorm()));
+	CHECK(batch.getResult(inf_index) == Approx(ap->infNorm()));
+	CheckValues(r, [&](int comp, int i, const array<int, 3> &coord) {
+		double base = i + 0.5 * comp + 0.25 * coord[0] - coord[1] + 2.0 * coord[2];
+		return (1 + base) - 0.25 * (-1 + base);
+	});
+}
+TEST_CASE("assign with empty ReductionBatch", "[VectorExpression]")
+{
+	auto a = GetNewVector(false, 1, 2);
+	auto x = GetNewVector(false, 1, 2);
+	Fill(a, 1);
+
+	ReductionBatch<3> batch;
+	assign(x, 3 * a, batch);
+	CheckValues(x, [&](int comp, int i, const array<int, 3> &coord) {
+		return 3 * (1 + i + 0.25 * coord[0] - coord[1] + 2.0 * coord[2]);
+	});
+}
+TEST_CASE("assign throws with different layouts", "[VectorExpression]")
+{
+	auto x            = GetNewVector(false, 1, 2);
+	auto more_patches = GetNewVector(false, 1, 3);
+	auto more_comps   = GetNewVector(false, 2, 2);
+	auto same         = GetNewVector(false, 1, 2);
+	CHECK_THROWS_AS(assign(x, same + more_patches), RuntimeError);
+	CHECK_THROWS_AS(assign(x, 2 * more_comps), RuntimeError);
+
+	ReductionBatch<3> batch;
+	batch.addTwoNorm(more_patches);
+	CHECK_THROWS_AS(assign(x, same, batch), RuntimeError);
+}
+TEST_CASE("vector expression throws with null vector", "[VectorExpression]")
+{
+	shared_ptr<Vector<3>> null_vec;
+	auto                  x = GetNewVector(false, 1, 2);
+	CHECK_THROWS_AS(assign(x, x + null_vec), RuntimeError);
+}
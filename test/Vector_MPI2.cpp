@@ -151,4 +151,34 @@ TEST_CASE("Vector<3> dot", "[Vector]")
 	MPI_Allreduce(&expected_value, &global_expected_value, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
 
 	CHECK(a->dot(b) == Approx(global_expected_value));
-}
\ No newline at end of file
+}
+TEST_CASE("Vector<3> split phase reductions match blocking reductions", "[Vector]")
+{
+	int           num_components    = GENERATE(1, 2);
+	auto          num_ghost_cells   = GENERATE(0, 1);
+	array<int, 3> ns                = {4, 5, 3};
+	int           num_local_patches = GENERATE(1, 13);
+
+	auto a = make_shared<MockVector<3>>(MPI_COMM_WORLD, num_components, num_local_patches,
+	                                    num_ghost_cells, ns);
+	auto b = make_shared<MockVector<3>>(MPI_COMM_WORLD, num_components, num_local_patches,
+	                                    num_ghost_cells, ns);
+
+	INFO("num_ghost_cells:   " << num_ghost_cells);
+	INFO("num_local_patches: " << num_local_patches);
+	INFO("num_components:    " << num_components);
+
+	for (size_t i = 0; i < a->data.size(); i++) {
+		double x   = (i + 0.5) / a->data.size();
+		a->data[i] = 10 - (x - 0.75) * (x - 0.75);
+		b->data[i] = (x - 0.5) * (x - 0.5) - 1;
+	}
+
+	AsyncReduction dot      = a->dotStart(b);
+	AsyncReduction two_norm = a->twoNormStart();
+	AsyncReduction inf_norm = b->infNormStart();
+
+	CHECK(dot.finish() == a->dot(b));
+	CHECK(two_norm.finish() == a->twoNorm());
+	CHECK(inf_norm.finish() == b->infNorm());
+}